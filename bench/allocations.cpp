@@ -0,0 +1,88 @@
+#include "allocations.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Precedes every allocation so that deallocation knows its size and where the underlying block begins
+struct AllocationHeader
+{
+    size_t size;
+    size_t offset;
+};
+
+static std::atomic<uint64_t> allocations{0u};
+static std::atomic<uint64_t> bytes{0u};
+static std::atomic<uint64_t> live{0u};
+static std::atomic<uint64_t> peak{0u};
+
+static void * allocate(const size_t size, const size_t alignment = alignof(std::max_align_t))
+{
+    allocations.fetch_add(1u, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+
+    const uint64_t current{live.fetch_add(size, std::memory_order_relaxed) + size};
+    uint64_t prevPeak{peak.load(std::memory_order_relaxed)};
+    while (current > prevPeak && !peak.compare_exchange_weak(prevPeak, current, std::memory_order_relaxed));
+
+    const size_t align{std::max(alignment, alignof(std::max_align_t))};
+    const size_t offset{(sizeof(AllocationHeader) + align - 1u) / align * align};
+    if (void * const base{std::aligned_alloc(align, (offset + size + align - 1u) / align * align)})
+    {
+        void * const ptr{static_cast<char *>(base) + offset};
+        static_cast<AllocationHeader *>(ptr)[-1] = AllocationHeader{size, offset};
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+static void deallocate(void * const ptr) noexcept
+{
+    if (ptr)
+    {
+        const AllocationHeader header{static_cast<AllocationHeader *>(ptr)[-1]};
+        live.fetch_sub(header.size, std::memory_order_relaxed);
+        std::free(static_cast<char *>(ptr) - header.offset);
+    }
+}
+
+uint64_t allocationCount() noexcept
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t allocatedBytes() noexcept
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t liveBytes() noexcept
+{
+    return live.load(std::memory_order_relaxed);
+}
+
+uint64_t peakBytes() noexcept
+{
+    return peak.load(std::memory_order_relaxed);
+}
+
+void resetPeakBytes() noexcept
+{
+    peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void * operator new(const size_t size) { return allocate(size); }
+void * operator new[](const size_t size) { return allocate(size); }
+void * operator new(const size_t size, const std::align_val_t alignment) { return allocate(size, size_t(alignment)); }
+void * operator new[](const size_t size, const std::align_val_t alignment) { return allocate(size, size_t(alignment)); }
+
+void operator delete(void * const ptr) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr) noexcept { deallocate(ptr); }
+void operator delete(void * const ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete(void * const ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void * const ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
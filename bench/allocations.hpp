@@ -0,0 +1,36 @@
+#pragma once
+
+///
+/// Global allocation counting for benchmarks
+///
+/// Linking `allocations.cpp` replaces the global `operator new` and `operator delete` with versions that count every
+/// allocation, across all threads
+///
+
+#include <cstddef>
+#include <cstdint>
+
+///
+/// @return the total number of allocations made so far by the process
+///
+uint64_t allocationCount() noexcept;
+
+///
+/// @return the total number of bytes allocated so far by the process
+///
+uint64_t allocatedBytes() noexcept;
+
+///
+/// @return the number of bytes currently allocated and not yet freed
+///
+uint64_t liveBytes() noexcept;
+
+///
+/// @return the highest number of live bytes since the last call to `resetPeakBytes`
+///
+uint64_t peakBytes() noexcept;
+
+///
+/// Resets the peak to the current number of live bytes
+///
+void resetPeakBytes() noexcept;
@@ -0,0 +1,223 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <qc-json.hpp>
+
+#include "allocations.hpp"
+#include "corpus.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Density;
+
+static constexpr size_t corpusSize{1024u * 1024u};
+
+// Each corpus is generated once and split into documents, which for NDJSON are the lines
+struct Documents
+{
+    std::string json;
+    std::vector<std::string_view> documents;
+};
+
+static const Documents & documents(const Corpus corpus)
+{
+    static Documents cache[std::size(corpora)]{};
+
+    Documents & docs{cache[size_t(corpus)]};
+    if (docs.json.empty())
+    {
+        docs.json = generateCorpus(corpus, corpusSize);
+        if (corpus == Corpus::ndjson)
+        {
+            for (size_t start{0u}, end; (end = docs.json.find('\n', start)) != std::string::npos; start = end + 1u)
+            {
+                docs.documents.push_back(std::string_view{docs.json}.substr(start, end - start));
+            }
+        }
+        else
+        {
+            docs.documents.push_back(docs.json);
+        }
+    }
+
+    return docs;
+}
+
+// A flat recording of decode events that can be replayed into an encoder
+class EventRecorder
+{
+    public: //------------------------------------------------------------------
+
+    enum class Type : uint8_t { object, array, end, key, string, integer, unsigner, floater, boolean, null, comment };
+
+    struct Event
+    {
+        Type type;
+        Density density;
+        std::string str;
+        union { int64_t integer; uint64_t unsigner; double floater; bool boolean; };
+    };
+
+    std::vector<Event> events{};
+
+    size_t object(size_t & /*outerState*/) { return _push(Type::object); }
+    size_t array(size_t & /*outerState*/) { return _push(Type::array); }
+    void end(const Density density, size_t && innerState, size_t & /*outerState*/) { events[innerState].density = density; _push(Type::end); }
+    void key(const std::string_view key, size_t & /*state*/) { events[_push(Type::key)].str = key; }
+    void val(const std::string_view val, size_t & /*state*/) { events[_push(Type::string)].str = val; }
+    void val(const int64_t val, size_t & /*state*/) { events[_push(Type::integer)].integer = val; }
+    void val(const uint64_t val, size_t & /*state*/) { events[_push(Type::unsigner)].unsigner = val; }
+    void val(const double val, size_t & /*state*/) { events[_push(Type::floater)].floater = val; }
+    void val(const bool val, size_t & /*state*/) { events[_push(Type::boolean)].boolean = val; }
+    void val(const std::nullptr_t, size_t & /*state*/) { _push(Type::null); }
+    void comment(const std::string_view comment, size_t & /*state*/) { events[_push(Type::comment)].str = comment; }
+
+    void replay(qc::json::Encoder & encoder) const
+    {
+        for (const Event & event : events)
+        {
+            switch (event.type)
+            {
+                case Type::object: encoder << qc::json::object(event.density); break;
+                case Type::array: encoder << qc::json::array(event.density); break;
+                case Type::end: encoder << qc::json::end; break;
+                case Type::key: [[fallthrough]];
+                case Type::string: encoder << event.str; break;
+                case Type::integer: encoder << event.integer; break;
+                case Type::unsigner: encoder << event.unsigner; break;
+                case Type::floater: encoder << event.floater; break;
+                case Type::boolean: encoder << event.boolean; break;
+                case Type::null: encoder << nullptr; break;
+                case Type::comment: encoder << qc::json::comment(event.str); break;
+            }
+        }
+    }
+
+    private: //-----------------------------------------------------------------
+
+    size_t _push(const Type type)
+    {
+        events.push_back(Event{.type = type, .density = Density::unspecified, .str = {}, .integer = 0});
+        return events.size() - 1u;
+    }
+};
+
+// Reports throughput and allocations per iteration
+class Measurement
+{
+    public: //------------------------------------------------------------------
+
+    explicit Measurement(benchmark::State & state) noexcept :
+        _state{state},
+        _startAllocations{allocationCount()}
+    {}
+
+    void finish(const size_t bytesPerIteration)
+    {
+        _state.SetBytesProcessed(int64_t(_state.iterations()) * int64_t(bytesPerIteration));
+        _state.counters["allocs/op"] = benchmark::Counter(double(allocationCount() - _startAllocations), benchmark::Counter::kAvgIterations);
+    }
+
+    private: //-----------------------------------------------------------------
+
+    benchmark::State & _state;
+    uint64_t _startAllocations;
+};
+
+static void saxDecode(benchmark::State & state, const Corpus corpus)
+{
+    const Documents & docs{documents(corpus)};
+    qc::json::DummyComposer composer{};
+
+    Measurement measurement{state};
+    for (auto _ : state)
+    {
+        for (const std::string_view doc : docs.documents)
+        {
+            qc::json::decode(doc, composer, nullptr);
+        }
+    }
+    measurement.finish(docs.json.size());
+}
+
+static void domDecode(benchmark::State & state, const Corpus corpus)
+{
+    const Documents & docs{documents(corpus)};
+
+    Measurement measurement{state};
+    for (auto _ : state)
+    {
+        for (const std::string_view doc : docs.documents)
+        {
+            qc::json::Value val{qc::json::decode(doc)};
+            benchmark::DoNotOptimize(val);
+        }
+    }
+    measurement.finish(docs.json.size());
+}
+
+static void domEncode(benchmark::State & state, const Corpus corpus)
+{
+    const Documents & docs{documents(corpus)};
+    std::vector<qc::json::Value> vals{};
+    size_t bytes{0u};
+    for (const std::string_view doc : docs.documents)
+    {
+        bytes += qc::json::encode(vals.emplace_back(qc::json::decode(doc)), Density::unspecified).size();
+    }
+
+    Measurement measurement{state};
+    for (auto _ : state)
+    {
+        for (const qc::json::Value & val : vals)
+        {
+            std::string str{qc::json::encode(val, Density::unspecified)};
+            benchmark::DoNotOptimize(str);
+        }
+    }
+    measurement.finish(bytes);
+}
+
+static void saxEncode(benchmark::State & state, const Corpus corpus)
+{
+    const Documents & docs{documents(corpus)};
+    std::vector<EventRecorder> recorders{};
+    size_t bytes{0u};
+    for (const std::string_view doc : docs.documents)
+    {
+        qc::json::decode(doc, recorders.emplace_back(), size_t{0u});
+        qc::json::Encoder encoder{};
+        recorders.back().replay(encoder);
+        bytes += encoder.finish().size();
+    }
+
+    qc::json::Encoder encoder{};
+    Measurement measurement{state};
+    for (auto _ : state)
+    {
+        for (const EventRecorder & recorder : recorders)
+        {
+            recorder.replay(encoder);
+            std::string str{encoder.finish()};
+            benchmark::DoNotOptimize(str);
+        }
+    }
+    measurement.finish(bytes);
+}
+
+#define QC_JSON_BENCH(function) \
+    BENCHMARK_CAPTURE(function, numbers, Corpus::numbers); \
+    BENCHMARK_CAPTURE(function, strings, Corpus::strings); \
+    BENCHMARK_CAPTURE(function, nested, Corpus::nested); \
+    BENCHMARK_CAPTURE(function, comments, Corpus::comments); \
+    BENCHMARK_CAPTURE(function, wide, Corpus::wide); \
+    BENCHMARK_CAPTURE(function, ndjson, Corpus::ndjson)
+
+QC_JSON_BENCH(saxDecode);
+QC_JSON_BENCH(domDecode);
+QC_JSON_BENCH(domEncode);
+QC_JSON_BENCH(saxEncode);
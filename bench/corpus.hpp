@@ -0,0 +1,317 @@
+#pragma once
+
+///
+/// Deterministic generation of representative JSON corpora for benchmarking
+///
+/// The same corpus type, size, and seed always produce the same string on every platform
+///
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum class Corpus
+{
+    numbers,  /// Arrays of integers and floating point numbers
+    strings,  /// Records of short and long strings with occasional escapes
+    nested,   /// Deeply nested objects and arrays
+    comments, /// JSON5 config with comments, identifiers, single quotes, hex, and dangling commas
+    wide,     /// A single object with very many members
+    ndjson    /// Newline delimited JSON records
+};
+
+inline constexpr Corpus corpora[]{Corpus::numbers, Corpus::strings, Corpus::nested, Corpus::comments, Corpus::wide, Corpus::ndjson};
+
+///
+/// @return the name of the corpus type
+///
+std::string_view corpusName(Corpus corpus) noexcept;
+
+///
+/// Generates a corpus of approximately the given size
+///
+/// @param corpus the type of corpus
+/// @param size the approximate size in bytes. The result is always complete JSON, so may be slightly larger
+/// @param seed the seed for the pseudo-random generator
+/// @return the generated JSON
+///
+std::string generateCorpus(Corpus corpus, size_t size, uint64_t seed = 0u);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// SplitMix64, which is simple, fast, and fully specified
+class _Random
+{
+    public: //------------------------------------------------------------------
+
+    explicit _Random(const uint64_t seed) noexcept :
+        _state{seed}
+    {}
+
+    uint64_t next() noexcept
+    {
+        uint64_t z{_state += 0x9E3779B97F4A7C15u};
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+        return z ^ (z >> 31);
+    }
+
+    // In the range [0, n)
+    uint64_t below(const uint64_t n) noexcept
+    {
+        return next() % n;
+    }
+
+    bool chance(const uint64_t percent) noexcept
+    {
+        return below(100u) < percent;
+    }
+
+    private: //-----------------------------------------------------------------
+
+    uint64_t _state;
+};
+
+inline void _appendWord(std::string & str, _Random & random)
+{
+    static constexpr std::string_view syllables[]{"ka", "lo", "mi", "ne", "ru", "sa", "to", "vi", "qu", "zer", "ba", "dor"};
+    const uint64_t n{1u + random.below(4u)};
+    for (uint64_t i{0u}; i < n; ++i)
+    {
+        str += syllables[random.below(std::size(syllables))];
+    }
+}
+
+inline void _appendText(std::string & str, _Random & random, const uint64_t words, const bool escapes)
+{
+    for (uint64_t i{0u}; i < words; ++i)
+    {
+        if (i)
+        {
+            str += ' ';
+        }
+        _appendWord(str, random);
+        if (escapes && random.chance(5u))
+        {
+            static constexpr std::string_view escapeSeqs[]{"\\n", "\\t", "\\\"", "\\\\", "\\u00E9", "\\u2603"};
+            str += escapeSeqs[random.below(std::size(escapeSeqs))];
+        }
+    }
+}
+
+inline void _appendNumber(std::string & str, _Random & random)
+{
+    switch (random.below(5u))
+    {
+        case 0u: str += std::to_string(random.below(100u)); break;
+        case 1u: str += std::to_string(-int64_t(random.below(1'000'000u))); break;
+        case 2u: str += std::to_string(random.next() >> 1); break;
+        case 3u:
+        {
+            str += std::to_string(random.below(100000u));
+            str += '.';
+            str += std::to_string(random.below(1000000u));
+            break;
+        }
+        default:
+        {
+            str += std::to_string(1u + random.below(9u));
+            str += '.';
+            str += std::to_string(random.below(100000000u));
+            str += 'e';
+            str += std::to_string(int(random.below(600u)) - 300);
+        }
+    }
+}
+
+inline void _appendNested(std::string & str, _Random & random, const uint64_t depth)
+{
+    if (depth == 0u)
+    {
+        _appendNumber(str, random);
+        return;
+    }
+
+    if (depth % 2u)
+    {
+        str += R"({"k)";
+        str += std::to_string(depth);
+        str += R"(":)";
+        _appendNested(str, random, depth - 1u);
+        if (random.chance(30u))
+        {
+            str += R"(,"x":null)";
+        }
+        str += '}';
+    }
+    else
+    {
+        str += '[';
+        _appendNested(str, random, depth - 1u);
+        if (random.chance(30u))
+        {
+            str += ",true";
+        }
+        str += ']';
+    }
+}
+
+inline void _appendRecord(std::string & str, _Random & random, const uint64_t id)
+{
+    str += R"({"id":)";
+    str += std::to_string(id);
+    str += R"(,"name":")";
+    _appendWord(str, random);
+    str += R"(","active":)";
+    str += random.chance(50u) ? "true" : "false";
+    str += R"(,"score":)";
+    _appendNumber(str, random);
+    str += R"(,"tags":[)";
+    for (uint64_t i{0u}, n{random.below(4u)}; i < n; ++i)
+    {
+        str += i ? ",\"" : "\"";
+        _appendWord(str, random);
+        str += '"';
+    }
+    str += "]}";
+}
+
+inline std::string_view corpusName(const Corpus corpus) noexcept
+{
+    switch (corpus)
+    {
+        case Corpus::numbers: return "numbers";
+        case Corpus::strings: return "strings";
+        case Corpus::nested: return "nested";
+        case Corpus::comments: return "comments";
+        case Corpus::wide: return "wide";
+        case Corpus::ndjson: return "ndjson";
+    }
+    return {};
+}
+
+inline std::string generateCorpus(const Corpus corpus, const size_t size, const uint64_t seed)
+{
+    _Random random{seed ^ (uint64_t(corpus) << 56)};
+    std::string str{};
+    str.reserve(size + 1024u);
+
+    switch (corpus)
+    {
+        case Corpus::numbers:
+        {
+            str += "[\n";
+            while (str.size() < size)
+            {
+                str += "    [";
+                for (int i{0}; i < 16; ++i)
+                {
+                    if (i) str += ", ";
+                    _appendNumber(str, random);
+                }
+                str += "],\n";
+            }
+            str += "    []\n]";
+            break;
+        }
+        case Corpus::strings:
+        {
+            str += "[\n";
+            for (uint64_t id{0u}; str.size() < size; ++id)
+            {
+                str += R"(    {"id": ")";
+                _appendWord(str, random);
+                str += R"(", "summary": ")";
+                _appendText(str, random, 2u + random.below(6u), false);
+                str += R"(", "body": ")";
+                _appendText(str, random, 10u + random.below(80u), true);
+                str += "\"},\n";
+            }
+            str += "    {}\n]";
+            break;
+        }
+        case Corpus::nested:
+        {
+            str += "[\n";
+            while (str.size() < size)
+            {
+                str += "    ";
+                _appendNested(str, random, 32u + random.below(32u));
+                str += ",\n";
+            }
+            str += "    null\n]";
+            break;
+        }
+        case Corpus::comments:
+        {
+            str += "// Generated configuration\n{\n";
+            for (uint64_t section{0u}; str.size() < size; ++section)
+            {
+                str += "    /* Section ";
+                str += std::to_string(section);
+                str += " */\n    section";
+                str += std::to_string(section);
+                str += ": {\n";
+                for (uint64_t i{0u}, n{2u + random.below(8u)}; i < n; ++i)
+                {
+                    if (random.chance(40u))
+                    {
+                        str += "        // ";
+                        _appendText(str, random, 3u + random.below(8u), false);
+                        str += '\n';
+                    }
+                    str += "        ";
+                    _appendWord(str, random);
+                    str += std::to_string(i);
+                    str += ": ";
+                    switch (random.below(5u))
+                    {
+                        case 0u: str += '\''; _appendText(str, random, 1u + random.below(4u), false); str += '\''; break;
+                        case 1u: str += "0x"; str += "0123456789ABCDEF"[random.below(16u)]; str += std::to_string(random.below(0xFFFFu)); break;
+                        case 2u: str += random.chance(50u) ? "true" : "false"; break;
+                        case 3u: str += random.chance(10u) ? "Infinity" : "-12.5"; break;
+                        default: _appendNumber(str, random);
+                    }
+                    str += ",\n";
+                }
+                str += "    },\n";
+            }
+            str += '}';
+            break;
+        }
+        case Corpus::wide:
+        {
+            str += '{';
+            for (uint64_t i{0u}; str.size() < size; ++i)
+            {
+                if (i) str += ',';
+                str += "\"member";
+                str += std::to_string(i);
+                str += "\":";
+                if (random.chance(50u))
+                {
+                    _appendNumber(str, random);
+                }
+                else
+                {
+                    str += '"';
+                    _appendWord(str, random);
+                    str += '"';
+                }
+            }
+            str += '}';
+            break;
+        }
+        case Corpus::ndjson:
+        {
+            for (uint64_t id{0u}; str.size() < size; ++id)
+            {
+                _appendRecord(str, random, id);
+                str += '\n';
+            }
+            break;
+        }
+    }
+
+    return str;
+}
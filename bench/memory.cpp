@@ -0,0 +1,279 @@
+///
+/// Peak memory and DOM footprint benchmark
+///
+/// For each corpus, decodes the whole input into DOM values and reports, relative to the input size:
+/// - the heap bytes retained by the DOM
+/// - the peak heap bytes during decoding, including transient allocations
+/// - the growth of the peak resident set size during decoding (Linux only)
+///
+/// The retained heap is then broken down by walking the DOM:
+/// - `objects`: the object containers and their map nodes, each of which holds a key and a value
+/// - `keys`: key characters too long to be stored inline in the key string
+/// - `arrays`: the array containers and the used portion of their buffers
+/// - `slack`: the unused capacity of array buffers
+/// - `strings`: the string values, including any characters not stored inline
+/// - `comments`: the comment strings, including any characters not stored inline
+///
+/// Map nodes are not visible to the walk, so their size is estimated as three pointers and a color (which holds for the
+/// common standard libraries) plus the key and value. The `accounted` column is the portion of the measured heap that
+/// the breakdown explains, which should be close to 100%
+///
+/// Usage: qc-json-memory [--size <bytes>] [--corpus <name>]
+///
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __GLIBC__
+    #include <malloc.h>
+#endif
+
+#include <qc-json.hpp>
+
+#include "allocations.hpp"
+#include "corpus.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+// Resident set size /////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Reads a `kB` field from `/proc/self/status`
+static std::optional<size_t> readStatus(const std::string_view field)
+{
+    #ifdef __linux__
+        std::ifstream file{"/proc/self/status"};
+        std::string line{};
+        while (std::getline(file, line))
+        {
+            if (line.starts_with(field) && line.size() > field.size() && line[field.size()] == ':')
+            {
+                return size_t(std::strtoull(line.c_str() + field.size() + 1u, nullptr, 10)) * 1024u;
+            }
+        }
+    #endif
+
+    return std::nullopt;
+}
+
+// Returns freed memory to the system, then resets the peak resident set size to the current resident set size
+static bool resetPeakRss()
+{
+    #ifdef __GLIBC__
+        malloc_trim(0u);
+    #endif
+
+    #ifdef __linux__
+        std::ofstream file{"/proc/self/clear_refs"};
+        file << "5";
+        file.flush();
+        return bool(file);
+    #else
+        return false;
+    #endif
+}
+
+// DOM breakdown /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct Breakdown
+{
+    size_t objects{0u};
+    size_t keys{0u};
+    size_t arrays{0u};
+    size_t slack{0u};
+    size_t strings{0u};
+    size_t comments{0u};
+
+    size_t total() const noexcept
+    {
+        return objects + keys + arrays + slack + strings + comments;
+    }
+};
+
+// Three pointers and a color, padded
+static constexpr size_t mapNodeOverhead{4u * sizeof(void *)};
+
+// The heap bytes of a string's character buffer, which is zero if stored inline
+static size_t bufferBytes(const std::string & str) noexcept
+{
+    const char * const data{str.data()};
+    const char * const self{reinterpret_cast<const char *>(&str)};
+    const bool inlined{data >= self && data < self + sizeof(std::string)};
+    return inlined ? 0u : str.capacity() + 1u;
+}
+
+static void walk(const qc::json::Value & val, Breakdown & breakdown)
+{
+    if (const std::string * const comment{val.comment()})
+    {
+        breakdown.comments += sizeof(std::string) + bufferBytes(*comment);
+    }
+
+    switch (val.type())
+    {
+        case qc::json::Type::object:
+        {
+            const qc::json::Object & obj{val.asObject()};
+            breakdown.objects += sizeof(qc::json::Object) + obj.size() * (mapNodeOverhead + sizeof(qc::json::Object::value_type));
+            for (const auto & [key, member] : obj)
+            {
+                breakdown.keys += bufferBytes(key);
+                walk(member, breakdown);
+            }
+            break;
+        }
+        case qc::json::Type::array:
+        {
+            const qc::json::Array & arr{val.asArray()};
+            breakdown.arrays += sizeof(qc::json::Array) + arr.size() * sizeof(qc::json::Value);
+            breakdown.slack += (arr.capacity() - arr.size()) * sizeof(qc::json::Value);
+            for (const qc::json::Value & element : arr)
+            {
+                walk(element, breakdown);
+            }
+            break;
+        }
+        case qc::json::Type::string:
+        {
+            breakdown.strings += sizeof(std::string) + bufferBytes(val.asString());
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+// Benchmark /////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::string ratio(const std::optional<size_t> bytes, const size_t inputBytes)
+{
+    if (!bytes)
+    {
+        return "n/a"s;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2fx", double(*bytes) / double(inputBytes));
+    return buffer;
+}
+
+static std::string percent(const size_t bytes, const size_t total)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f%%", total ? double(bytes) / double(total) * 100.0 : 0.0);
+    return buffer;
+}
+
+static void measure(const Corpus corpus, const size_t size)
+{
+    const std::string json{generateCorpus(corpus, size)};
+
+    // Split the corpus into documents, which for NDJSON are the lines, and otherwise the whole corpus
+    std::vector<std::string_view> docs{};
+    if (corpus == Corpus::ndjson)
+    {
+        for (size_t start{0u}, end; (end = json.find('\n', start)) != std::string::npos; start = end + 1u)
+        {
+            docs.push_back(std::string_view{json}.substr(start, end - start));
+        }
+    }
+    else
+    {
+        docs.push_back(json);
+    }
+
+    // Reserved up front so that it is not included in the measurement
+    std::vector<qc::json::Value> vals{};
+    vals.reserve(docs.size());
+
+    const std::optional<size_t> startRss{resetPeakRss() ? readStatus("VmRSS"sv) : std::nullopt};
+    const size_t startHeap{liveBytes()};
+    resetPeakBytes();
+
+    for (const std::string_view doc : docs)
+    {
+        vals.push_back(qc::json::decode(doc));
+    }
+
+    const size_t heap{liveBytes() - startHeap};
+    const size_t peakHeap{peakBytes() - startHeap};
+    std::optional<size_t> rssGrowth{};
+    if (startRss)
+    {
+        if (const std::optional<size_t> peakRss{readStatus("VmHWM"sv)})
+        {
+            rssGrowth = *peakRss - std::min(*peakRss, *startRss);
+        }
+    }
+
+    Breakdown breakdown{};
+    for (const qc::json::Value & val : vals)
+    {
+        walk(val, breakdown);
+    }
+
+    std::printf("%-9s %10zu %10zu %8s %10s %10s | %7s %7s %7s %7s %7s %8s %10s\n",
+        std::string(corpusName(corpus)).c_str(),
+        json.size(),
+        heap,
+        ratio(heap, json.size()).c_str(),
+        ratio(peakHeap, json.size()).c_str(),
+        ratio(rssGrowth, json.size()).c_str(),
+        percent(breakdown.objects, heap).c_str(),
+        percent(breakdown.keys, heap).c_str(),
+        percent(breakdown.arrays, heap).c_str(),
+        percent(breakdown.slack, heap).c_str(),
+        percent(breakdown.strings, heap).c_str(),
+        percent(breakdown.comments, heap).c_str(),
+        percent(breakdown.total(), heap).c_str());
+    std::fflush(stdout);
+}
+
+int main(const int argc, const char * const * const argv)
+{
+    size_t size{8u * 1024u * 1024u};
+    std::vector<Corpus> selected{std::begin(corpora), std::end(corpora)};
+
+    for (int i{1}; i + 1 < argc; i += 2)
+    {
+        const std::string_view arg{argv[i]};
+        const std::string_view value{argv[i + 1]};
+
+        if (arg == "--size"sv)
+        {
+            size = size_t(std::strtoull(argv[i + 1], nullptr, 10));
+        }
+        else if (arg == "--corpus"sv)
+        {
+            const auto it{std::find_if(std::begin(corpora), std::end(corpora), [&](const Corpus c) { return corpusName(c) == value; })};
+            if (it == std::end(corpora))
+            {
+                std::fprintf(stderr, "Unknown corpus `%s`\n", argv[i + 1]);
+                return 2;
+            }
+            selected = {*it};
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown argument `%s`\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::printf("%-9s %10s %10s %8s %10s %10s | %7s %7s %7s %7s %7s %8s %10s\n",
+        "corpus", "input", "heap", "heap/in", "peak heap", "peak rss", "objects", "keys", "arrays", "slack", "strings", "comments", "accounted");
+
+    for (const Corpus corpus : selected)
+    {
+        measure(corpus, size);
+    }
+
+    return 0;
+}
@@ -0,0 +1,466 @@
+///
+/// Hardware performance counter harness for the decode and encode kernels
+///
+/// Measures cycles, instructions, branch misses, and cache misses per byte using `perf_event_open`, writes a JSON
+/// report, and optionally compares it against a stored baseline report
+///
+/// Usage: qc-json-perf [--out <file>] [--baseline <file>] [--threshold <percent>] [--repetitions <n>] [--filter <str>]
+///
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <qc-json.hpp>
+
+#include "corpus.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Density;
+
+// A single counter for the calling thread, user space only
+class PerfCounter
+{
+    public: //------------------------------------------------------------------
+
+    PerfCounter(const uint32_t type, const uint64_t config) noexcept
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        _fd = int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        _error = _fd == -1 ? errno : 0;
+    }
+
+    PerfCounter(const PerfCounter &) = delete;
+
+    PerfCounter(PerfCounter && other) noexcept :
+        _fd{std::exchange(other._fd, -1)},
+        _error{other._error}
+    {}
+
+    ~PerfCounter() noexcept
+    {
+        if (_fd != -1)
+        {
+            ::close(_fd);
+        }
+    }
+
+    bool available() const noexcept
+    {
+        return _fd != -1;
+    }
+
+    int error() const noexcept
+    {
+        return _error;
+    }
+
+    void start() noexcept
+    {
+        if (_fd != -1)
+        {
+            ::ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void stop() noexcept
+    {
+        if (_fd != -1)
+        {
+            ::ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    // Scaled to account for multiplexing
+    std::optional<double> read() const noexcept
+    {
+        struct { uint64_t value, enabled, running; } data{};
+        if (_fd == -1 || ::read(_fd, &data, sizeof(data)) != ssize_t(sizeof(data)) || !data.running)
+        {
+            return std::nullopt;
+        }
+        return double(data.value) * double(data.enabled) / double(data.running);
+    }
+
+    private: //-----------------------------------------------------------------
+
+    int _fd{-1};
+    int _error{0};
+};
+
+struct Metric
+{
+    std::string_view name;
+    uint32_t type;
+    uint64_t config;
+    double scale; // Count is divided by bytes, then multiplied by this
+};
+
+static constexpr Metric metrics[]{
+    {"cyclesPerByte"sv, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1.0},
+    {"instructionsPerByte"sv, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1.0},
+    {"branchMissesPerKiB"sv, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 1024.0},
+    {"cacheMissesPerKiB"sv, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 1024.0}};
+
+static constexpr size_t metricCount{std::size(metrics)};
+
+struct Kernel
+{
+    std::string name;
+    size_t bytes;
+    std::function<void()> run;
+};
+
+struct Result
+{
+    double nanosecondsPerByte;
+    std::optional<double> values[metricCount];
+};
+
+// Inputs that each stress one scanning primitive of the decoder
+static std::string whitespaceInput(const size_t size)
+{
+    std::string str{"["};
+    while (str.size() < size)
+    {
+        str += "    \n\t  \r\n        \n";
+        str += (str.size() % 7u ? "0," : "1,");
+    }
+    str += "]";
+    return str;
+}
+
+static std::string stringInput(const size_t size, const bool escapes)
+{
+    std::string str{"["};
+    for (size_t i{0u}; str.size() < size; ++i)
+    {
+        str += '"';
+        for (size_t j{0u}; j < 64u; ++j)
+        {
+            str += char('a' + (i + j) % 26u);
+            if (escapes && j % 4u == 0u)
+            {
+                str += (j % 8u ? "\\n"sv : "\\u00E9"sv);
+            }
+        }
+        str += "\",";
+    }
+    str += "\"\"]";
+    return str;
+}
+
+static std::string numberInput(const size_t size, const bool floaters)
+{
+    std::string str{"["};
+    uint64_t x{12345u};
+    while (str.size() < size)
+    {
+        x = x * 6364136223846793005u + 1442695040888963407u;
+        str += std::to_string(int64_t(x >> 20) - (int64_t(1) << 42));
+        if (floaters)
+        {
+            str += '.';
+            str += std::to_string(x % 1000000u);
+            str += "e-";
+            str += std::to_string(x % 300u);
+        }
+        str += ',';
+    }
+    str += "0]";
+    return str;
+}
+
+static std::vector<Kernel> makeKernels(std::vector<std::string> & inputs, std::vector<qc::json::Value> & doms)
+{
+    static constexpr size_t size{1024u * 1024u};
+
+    // Stable addresses are required as the kernels hold views
+    inputs.reserve(64u);
+    doms.reserve(64u);
+
+    std::vector<Kernel> kernels{};
+
+    const auto addSaxDecode{[&](std::string name, std::string input) {
+        const std::string_view json{inputs.emplace_back(std::move(input))};
+        kernels.push_back(Kernel{std::move(name), json.size(), [json]() {
+            qc::json::DummyComposer composer{};
+            qc::json::decode(json, composer, nullptr);
+        }});
+    }};
+
+    addSaxDecode("primitive/whitespace", whitespaceInput(size));
+    addSaxDecode("primitive/string", stringInput(size, false));
+    addSaxDecode("primitive/stringEscapes", stringInput(size, true));
+    addSaxDecode("primitive/integer", numberInput(size, false));
+    addSaxDecode("primitive/floater", numberInput(size, true));
+
+    for (const Corpus corpus : corpora)
+    {
+        if (corpus == Corpus::ndjson)
+        {
+            continue;
+        }
+
+        const std::string_view json{inputs.emplace_back(generateCorpus(corpus, size))};
+        const std::string name{corpusName(corpus)};
+
+        kernels.push_back(Kernel{"saxDecode/" + name, json.size(), [json]() {
+            qc::json::DummyComposer composer{};
+            qc::json::decode(json, composer, nullptr);
+        }});
+
+        kernels.push_back(Kernel{"domDecode/" + name, json.size(), [json]() {
+            const qc::json::Value val{qc::json::decode(json)};
+        }});
+
+        const qc::json::Value & dom{doms.emplace_back(qc::json::decode(json))};
+        kernels.push_back(Kernel{"domEncode/" + name, qc::json::encode(dom, Density::unspecified).size(), [&dom]() {
+            const std::string str{qc::json::encode(dom, Density::unspecified)};
+        }});
+    }
+
+    return kernels;
+}
+
+// Runs the kernel the given number of times, keeping the minimum of each metric
+static Result measure(const Kernel & kernel, std::vector<PerfCounter> & counters, const size_t repetitions)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Result result{.nanosecondsPerByte = INFINITY, .values = {}};
+
+    // Warm up
+    kernel.run();
+
+    for (size_t rep{0u}; rep < repetitions; ++rep)
+    {
+        const Clock::time_point start{Clock::now()};
+        for (PerfCounter & counter : counters) counter.start();
+        kernel.run();
+        for (PerfCounter & counter : counters) counter.stop();
+        const Clock::time_point end{Clock::now()};
+
+        const double bytes{double(kernel.bytes)};
+        result.nanosecondsPerByte = std::min(result.nanosecondsPerByte, std::chrono::duration<double, std::nano>(end - start).count() / bytes);
+
+        for (size_t i{0u}; i < metricCount; ++i)
+        {
+            if (const std::optional<double> count{counters[i].read()})
+            {
+                const double value{*count / bytes * metrics[i].scale};
+                result.values[i] = result.values[i] ? std::min(*result.values[i], value) : value;
+            }
+        }
+    }
+
+    return result;
+}
+
+static std::string readFile(const std::string & path)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error{"Failed to open `" + path + '`'};
+    }
+    std::ostringstream ss{};
+    ss << file.rdbuf();
+    return std::move(ss).str();
+}
+
+// Returns the kernels object of a report
+static const qc::json::Object & reportKernels(const qc::json::Value & report)
+{
+    const qc::json::Object & root{report.asObject()};
+    const auto it{root.find("kernels")};
+    if (it == root.end())
+    {
+        throw std::runtime_error{"Report is missing `kernels`"};
+    }
+    return it->second.asObject();
+}
+
+// Returns the maximum regression, in percent, of any metric of any kernel
+static double compare(const qc::json::Value & report, const qc::json::Value & baseline)
+{
+    double maxRegression{-INFINITY};
+
+    std::fprintf(stderr, "\n%-28s %-20s %12s %12s %9s\n", "kernel", "metric", "baseline", "current", "change");
+
+    const qc::json::Object & baseKernels{reportKernels(baseline)};
+    for (const auto & [kernelName, kernel] : reportKernels(report))
+    {
+        const auto baseIt{baseKernels.find(kernelName)};
+        if (baseIt == baseKernels.end())
+        {
+            continue;
+        }
+
+        for (const auto & [metricName, value] : kernel.asObject())
+        {
+            const qc::json::Object & baseMetrics{baseIt->second.asObject()};
+            const auto metricIt{baseMetrics.find(metricName)};
+            if (metricName == "bytes"sv || metricIt == baseMetrics.end() || !value.isNumber() || !metricIt->second.isNumber())
+            {
+                continue;
+            }
+
+            const double current{value.get<double>()};
+            const double base{metricIt->second.get<double>()};
+            const double change{base > 0.0 ? (current - base) / base * 100.0 : 0.0};
+
+            // Wall time is too noisy to gate on, so is only informational
+            if (metricName != "nanosecondsPerByte"sv)
+            {
+                maxRegression = std::max(maxRegression, change);
+            }
+
+            std::fprintf(stderr, "%-28s %-20s %12.4f %12.4f %+8.1f%%\n", kernelName.c_str(), metricName.c_str(), base, current, change);
+        }
+    }
+
+    return maxRegression;
+}
+
+int main(const int argc, const char * const * const argv)
+{
+    std::optional<std::string> outPath{};
+    std::optional<std::string> baselinePath{};
+    std::string filter{};
+    double threshold{5.0};
+    size_t repetitions{5u};
+
+    for (int i{1}; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for `" << arg << "`\n";
+            return 2;
+        }
+
+        if (arg == "--out"sv) outPath = argv[++i];
+        else if (arg == "--baseline"sv) baselinePath = argv[++i];
+        else if (arg == "--threshold"sv) threshold = std::strtod(argv[++i], nullptr);
+        else if (arg == "--repetitions"sv) repetitions = std::max(size_t(std::strtoull(argv[++i], nullptr, 10)), size_t{1u});
+        else if (arg == "--filter"sv) filter = argv[++i];
+        else
+        {
+            std::cerr << "Unknown argument `" << arg << "`\n";
+            return 2;
+        }
+    }
+
+    try
+    {
+        std::vector<PerfCounter> counters{};
+        for (const Metric & metric : metrics)
+        {
+            if (const PerfCounter & counter{counters.emplace_back(metric.type, metric.config)}; !counter.available())
+            {
+                std::cerr << "Counter for `" << metric.name << "` is unavailable: " << std::strerror(counter.error()) << '\n';
+            }
+        }
+
+        std::vector<std::string> inputs{};
+        std::vector<qc::json::Value> doms{};
+        const std::vector<Kernel> kernels{makeKernels(inputs, doms)};
+
+        qc::json::Object kernelReports{};
+
+        std::fprintf(stderr, "%-28s %10s", "kernel", "ns/byte");
+        for (const Metric & metric : metrics) std::fprintf(stderr, " %20.*s", int(metric.name.size()), metric.name.data());
+        std::fprintf(stderr, "\n");
+
+        for (const Kernel & kernel : kernels)
+        {
+            if (kernel.name.find(filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            const Result result{measure(kernel, counters, repetitions)};
+
+            qc::json::Object entry{};
+            entry["bytes"] = uint64_t(kernel.bytes);
+            entry["nanosecondsPerByte"] = result.nanosecondsPerByte;
+
+            std::fprintf(stderr, "%-28s %10.4f", kernel.name.c_str(), result.nanosecondsPerByte);
+            for (size_t i{0u}; i < metricCount; ++i)
+            {
+                if (result.values[i])
+                {
+                    entry[std::string(metrics[i].name)] = *result.values[i];
+                    std::fprintf(stderr, " %20.4f", *result.values[i]);
+                }
+                else
+                {
+                    entry[std::string(metrics[i].name)] = nullptr;
+                    std::fprintf(stderr, " %20s", "-");
+                }
+            }
+            std::fprintf(stderr, "\n");
+
+            kernelReports.emplace(kernel.name, std::move(entry));
+        }
+
+        qc::json::Object reportRoot{};
+        reportRoot.emplace("kernels", std::move(kernelReports));
+        const qc::json::Value report{std::move(reportRoot)};
+
+        const std::string reportStr{qc::json::encode(report) + '\n'};
+        if (outPath)
+        {
+            std::ofstream{*outPath, std::ios::binary} << reportStr;
+        }
+        else
+        {
+            std::cout << reportStr;
+        }
+
+        if (baselinePath)
+        {
+            const double maxRegression{compare(report, qc::json::decode(readFile(*baselinePath)))};
+            if (maxRegression > threshold)
+            {
+                std::fprintf(stderr, "\nRegression of %.1f%% exceeds threshold of %.1f%%\n", maxRegression, threshold);
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception & e)
+    {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,340 @@
+///
+/// Multi-core scaling benchmark for concurrent independent decoders and encoders
+///
+/// Each thread repeatedly decodes and encodes its own copy of a set of documents, as a server handling one request per
+/// thread would. The aggregate and per-thread throughput and scaling efficiency are reported for several allocator
+/// configurations:
+/// - `global`: the default global allocator
+/// - `pool`: a thread-local, unsynchronized `std::pmr` pool
+/// - `arena`: a thread-local, monotonic `std::pmr` arena, released after each document
+///
+/// The library always allocates with the global `operator new`, so the configurations are selected by replacing it
+/// with a version that defers to the current thread's memory resource, if any
+///
+/// Usage: qc-json-scaling [--threads <n,n,...>] [--seconds <n>] [--corpus <name>]
+///
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <qc-json.hpp>
+
+#include "corpus.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+// Global allocation routing /////////////////////////////////////////////////////////////////////////////////////////
+
+// Precedes every allocation so that deallocation knows where it came from
+struct alignas(alignof(std::max_align_t)) AllocationHeader
+{
+    std::pmr::memory_resource * resource; // Null if from `malloc`
+    void * base;
+    size_t size;
+    size_t alignment;
+};
+
+static thread_local std::pmr::memory_resource * threadResource{nullptr};
+
+static void * allocate(const size_t size, size_t alignment)
+{
+    alignment = std::max(alignment, alignof(AllocationHeader));
+    const size_t offset{(sizeof(AllocationHeader) + alignment - 1u) / alignment * alignment};
+    const size_t total{(offset + size + alignment - 1u) / alignment * alignment};
+
+    std::pmr::memory_resource * const resource{threadResource};
+    void * const base{resource ? resource->allocate(total, alignment) : std::aligned_alloc(alignment, total)};
+    if (!base)
+    {
+        throw std::bad_alloc{};
+    }
+
+    void * const ptr{static_cast<char *>(base) + offset};
+    static_cast<AllocationHeader *>(ptr)[-1] = AllocationHeader{resource, base, total, alignment};
+    return ptr;
+}
+
+static void deallocate(void * const ptr) noexcept
+{
+    if (ptr)
+    {
+        const AllocationHeader & header{static_cast<AllocationHeader *>(ptr)[-1]};
+        if (header.resource)
+        {
+            header.resource->deallocate(header.base, header.size, header.alignment);
+        }
+        else
+        {
+            std::free(header.base);
+        }
+    }
+}
+
+void * operator new(const size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void * operator new[](const size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void * operator new(const size_t size, const std::align_val_t alignment) { return allocate(size, size_t(alignment)); }
+void * operator new[](const size_t size, const std::align_val_t alignment) { return allocate(size, size_t(alignment)); }
+
+void operator delete(void * const ptr) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr) noexcept { deallocate(ptr); }
+void operator delete(void * const ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete(void * const ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void * const ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void * const ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+
+// Upstream for the thread-local resources, which must not recurse into `operator new`
+class MallocResource : public std::pmr::memory_resource
+{
+    void * do_allocate(const size_t size, size_t alignment) override
+    {
+        alignment = std::max(alignment, alignof(std::max_align_t));
+        if (void * const ptr{std::aligned_alloc(alignment, (size + alignment - 1u) / alignment * alignment)})
+        {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void do_deallocate(void * const ptr, size_t, size_t) override
+    {
+        std::free(ptr);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// Benchmark /////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum class Allocator { global, pool, arena };
+
+enum class Workload { dom, sax };
+
+static constexpr std::string_view allocatorNames[]{"global"sv, "pool"sv, "arena"sv};
+static constexpr std::string_view workloadNames[]{"dom"sv, "sax"sv};
+
+struct ThreadResult
+{
+    size_t bytes{0u};
+    double seconds{0.0};
+};
+
+// One thread's work. Copies the documents so that threads share nothing
+static ThreadResult work(const std::vector<std::string> & sharedDocs, const Workload workload, const Allocator allocator, std::barrier<> & barrier, const std::atomic<bool> & stop)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const std::vector<std::string> docs{sharedDocs};
+
+    MallocResource upstream{};
+    std::pmr::unsynchronized_pool_resource pool{&upstream};
+    std::pmr::monotonic_buffer_resource arena{size_t{1u} << 20, &upstream};
+
+    ThreadResult result{};
+    qc::json::DummyComposer composer{};
+
+    barrier.arrive_and_wait();
+    const Clock::time_point start{Clock::now()};
+
+    switch (allocator)
+    {
+        case Allocator::global: threadResource = nullptr; break;
+        case Allocator::pool: threadResource = &pool; break;
+        case Allocator::arena: threadResource = &arena; break;
+    }
+
+    for (size_t i{0u}; !stop.load(std::memory_order_relaxed); i = (i + 1u) % docs.size())
+    {
+        const std::string & doc{docs[i]};
+
+        if (workload == Workload::dom)
+        {
+            const qc::json::Value val{qc::json::decode(doc)};
+            const std::string str{qc::json::encode(val)};
+        }
+        else
+        {
+            qc::json::decode(doc, composer, nullptr);
+        }
+
+        if (allocator == Allocator::arena)
+        {
+            arena.release();
+        }
+
+        result.bytes += doc.size();
+    }
+
+    threadResource = nullptr;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    return result;
+}
+
+static std::vector<ThreadResult> run(const std::vector<std::string> & docs, const Workload workload, const Allocator allocator, const size_t threadCount, const double seconds)
+{
+    std::vector<ThreadResult> results(threadCount);
+    std::atomic<bool> stop{false};
+    std::barrier barrier{std::ptrdiff_t(threadCount + 1u)};
+
+    std::vector<std::thread> threads{};
+    for (size_t t{0u}; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]() { results[t] = work(docs, workload, allocator, barrier, stop); });
+    }
+
+    barrier.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true, std::memory_order_relaxed);
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    return results;
+}
+
+static std::vector<size_t> parseThreadCounts(const std::string_view str)
+{
+    std::vector<size_t> counts{};
+    size_t start{0u};
+    while (start <= str.size())
+    {
+        size_t end{str.find(',', start)};
+        if (end == std::string_view::npos) end = str.size();
+        if (const size_t count{size_t(std::strtoull(std::string{str.substr(start, end - start)}.c_str(), nullptr, 10))})
+        {
+            counts.push_back(count);
+        }
+        start = end + 1u;
+    }
+    return counts;
+}
+
+int main(const int argc, const char * const * const argv)
+{
+    std::vector<size_t> threadCounts{};
+    double seconds{1.0};
+    Corpus corpus{Corpus::ndjson};
+
+    for (int i{1}; i + 1 < argc; i += 2)
+    {
+        const std::string_view arg{argv[i]};
+        const std::string_view value{argv[i + 1]};
+
+        if (arg == "--threads"sv)
+        {
+            threadCounts = parseThreadCounts(value);
+        }
+        else if (arg == "--seconds"sv)
+        {
+            seconds = std::strtod(argv[i + 1], nullptr);
+        }
+        else if (arg == "--corpus"sv)
+        {
+            const auto it{std::find_if(std::begin(corpora), std::end(corpora), [&](const Corpus c) { return corpusName(c) == value; })};
+            if (it == std::end(corpora))
+            {
+                std::fprintf(stderr, "Unknown corpus `%s`\n", argv[i + 1]);
+                return 2;
+            }
+            corpus = *it;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown argument `%s`\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (threadCounts.empty())
+    {
+        const size_t hardwareThreads{std::max(std::thread::hardware_concurrency(), 1u)};
+        for (size_t n{1u}; n < hardwareThreads; n *= 2u)
+        {
+            threadCounts.push_back(n);
+        }
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    // Split the corpus into documents, which for NDJSON are the lines, and otherwise the whole corpus
+    const std::string json{generateCorpus(corpus, corpus == Corpus::ndjson ? 1024u * 1024u : 64u * 1024u)};
+    std::vector<std::string> docs{};
+    if (corpus == Corpus::ndjson)
+    {
+        for (size_t start{0u}, end; (end = json.find('\n', start)) != std::string::npos; start = end + 1u)
+        {
+            docs.push_back(json.substr(start, end - start));
+        }
+    }
+    else
+    {
+        docs.push_back(json);
+    }
+
+    std::printf("corpus: %s, %zu documents, %zu bytes\n\n", std::string(corpusName(corpus)).c_str(), docs.size(), json.size());
+    std::printf("%-8s %-8s %8s %14s %16s %16s %11s\n", "workload", "alloc", "threads", "total MiB/s", "thread avg MiB/s", "thread min MiB/s", "efficiency");
+
+    for (const Workload workload : {Workload::dom, Workload::sax})
+    {
+        for (const Allocator allocator : {Allocator::global, Allocator::pool, Allocator::arena})
+        {
+            // The allocator is irrelevant to SAX decoding, which does not allocate
+            if (workload == Workload::sax && allocator != Allocator::global)
+            {
+                continue;
+            }
+
+            double singleThreadRate{0.0};
+
+            for (const size_t threadCount : threadCounts)
+            {
+                const std::vector<ThreadResult> results{run(docs, workload, allocator, threadCount, seconds)};
+
+                double total{0.0}, min{INFINITY};
+                for (const ThreadResult & result : results)
+                {
+                    const double rate{double(result.bytes) / result.seconds / (1024.0 * 1024.0)};
+                    total += rate;
+                    min = std::min(min, rate);
+                }
+                const double average{total / double(threadCount)};
+
+                if (threadCount == threadCounts.front())
+                {
+                    singleThreadRate = average;
+                }
+                const double efficiency{average / singleThreadRate * 100.0};
+
+                std::printf("%-8s %-8s %8zu %14.1f %16.1f %16.1f %10.1f%%\n",
+                    workloadNames[size_t(workload)].data(),
+                    allocatorNames[size_t(allocator)].data(),
+                    threadCount,
+                    total,
+                    average,
+                    min,
+                    efficiency);
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    return 0;
+}
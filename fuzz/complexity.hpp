@@ -0,0 +1,93 @@
+#pragma once
+
+///
+/// Complexity tracking for the fuzz targets
+///
+/// Inputs of at least `QC_JSON_FUZZ_MIN_SIZE` bytes (default 4096) are timed in ticks, which are CPU cycles on x86 and
+/// nanoseconds elsewhere. Whenever an input sets a new high for ticks per byte, it is reported to stderr. Smaller inputs
+/// are dominated by constant overhead, so are run without being timed
+///
+/// Timed inputs are additionally run on only their first half. The work done on a prefix should be roughly proportional
+/// to its length, so if the full input takes more than `QC_JSON_FUZZ_MAX_RATIO` (default 3.0) times as long as its first
+/// half, the behavior is super-linear and the input is aborted on so that libFuzzer records it as a crash
+///
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+inline uint64_t _ticks() noexcept
+{
+    #if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+    #else
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    #endif
+}
+
+inline double _envOr(const char * const name, const double fallback) noexcept
+{
+    const char * const str{std::getenv(name)};
+    return str ? std::strtod(str, nullptr) : fallback;
+}
+
+// The fewest ticks of several runs, to reduce noise from preemption and cold caches
+template <typename F>
+inline uint64_t _minTicks(const std::string_view input, F & f, const int runs)
+{
+    uint64_t min{UINT64_MAX};
+    for (int i{0}; i < runs; ++i)
+    {
+        const uint64_t start{_ticks()};
+        f(input);
+        const uint64_t ticks{_ticks() - start};
+        if (ticks < min) min = ticks;
+    }
+    return min;
+}
+
+///
+/// Runs the operation on the input, tracking its cost and aborting if it scales super-linearly
+///
+/// @param data the fuzz input
+/// @param size the size of the fuzz input
+/// @param f the operation, which is called with the input as a `std::string_view`. It may be called several times,
+///     but the last call is always with the full input
+///
+template <typename F>
+inline void checkComplexity(const uint8_t * const data, const size_t size, F && f)
+{
+    static const size_t minSize{size_t(_envOr("QC_JSON_FUZZ_MIN_SIZE", 4096.0))};
+    static const double maxRatio{_envOr("QC_JSON_FUZZ_MAX_RATIO", 3.0)};
+    static double maxTicksPerByte{0.0};
+
+    const std::string_view input{reinterpret_cast<const char *>(data), size};
+
+    if (size < minSize)
+    {
+        f(input);
+        return;
+    }
+
+    const uint64_t halfTicks{_minTicks(input.substr(0u, size / 2u), f, 3)};
+    const uint64_t fullTicks{_minTicks(input, f, 3)};
+
+    if (double(fullTicks) / double(size) > maxTicksPerByte)
+    {
+        maxTicksPerByte = double(fullTicks) / double(size);
+        std::fprintf(stderr, "qc-json: new max %.1f ticks/byte for %zu byte input\n", maxTicksPerByte, size);
+    }
+
+    const double ratio{double(fullTicks) / double(halfTicks ? halfTicks : 1u)};
+    if (ratio > maxRatio)
+    {
+        std::fprintf(stderr, "qc-json: super-linear behavior, %zu bytes took %.2fx as long as %zu bytes\n", size, ratio, size / 2u);
+        std::abort();
+    }
+}
@@ -0,0 +1,20 @@
+///
+/// Fuzzes DOM decoding
+///
+
+#include <qc-json.hpp>
+
+#include "complexity.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * const data, const size_t size)
+{
+    checkComplexity(data, size, [](const std::string_view json) {
+        try
+        {
+            const qc::json::Value val{qc::json::decode(json)};
+        }
+        catch (const qc::json::DecodeError &) {}
+    });
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+///
+/// Fuzzes SAX decoding with the `DummyComposer`
+///
+
+#include <qc-json.hpp>
+
+#include "complexity.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * const data, const size_t size)
+{
+    checkComplexity(data, size, [](const std::string_view json) {
+        qc::json::DummyComposer composer{};
+        try
+        {
+            qc::json::decode(json, composer, nullptr);
+        }
+        catch (const qc::json::DecodeError &) {}
+    });
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+///
+/// Fuzzes `Encoder` token sequences
+///
+/// The first byte selects the encoder options. Each following byte is an opcode selecting the next token, with any
+/// operands read from the bytes after it. Misuse must be reported by an `EncodeError` and nothing else
+///
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <qc-json.hpp>
+
+#include "complexity.hpp"
+
+class Reader
+{
+    public: //------------------------------------------------------------------
+
+    explicit Reader(const std::string_view input) noexcept :
+        _input{input}
+    {}
+
+    bool empty() const noexcept
+    {
+        return _input.empty();
+    }
+
+    uint8_t byte() noexcept
+    {
+        if (_input.empty())
+        {
+            return 0u;
+        }
+        const uint8_t b{uint8_t(_input.front())};
+        _input.remove_prefix(1u);
+        return b;
+    }
+
+    template <typename T>
+    T scalar() noexcept
+    {
+        T val{};
+        const size_t n{std::min(sizeof(T), _input.size())};
+        std::memcpy(&val, _input.data(), n);
+        _input.remove_prefix(n);
+        return val;
+    }
+
+    std::string_view str() noexcept
+    {
+        const std::string_view s{_input.substr(0u, byte())};
+        _input.remove_prefix(s.size());
+        return s;
+    }
+
+    qc::json::Density density() noexcept
+    {
+        static constexpr qc::json::Density densities[]{qc::json::Density::unspecified, qc::json::Density::multiline, qc::json::Density::uniline, qc::json::Density::nospace};
+        return densities[byte() % 4u];
+    }
+
+    private: //-----------------------------------------------------------------
+
+    std::string_view _input;
+};
+
+static void encode(Reader & reader)
+{
+    const uint8_t options{reader.byte()};
+    qc::json::Encoder encoder{reader.density(), size_t(options & 0b111u), bool(options & 0b1000u), bool(options & 0b10000u), bool(options & 0b100000u)};
+
+    while (!reader.empty())
+    {
+        switch (reader.byte() % 20u)
+        {
+            case 0u: encoder << qc::json::object(reader.density()); break;
+            case 1u: encoder << qc::json::array(reader.density()); break;
+            case 2u: encoder << qc::json::end; break;
+            case 3u: encoder << reader.str(); break;
+            case 4u: encoder << reader.scalar<char>(); break;
+            case 5u: encoder << reader.scalar<int64_t>(); break;
+            case 6u: encoder << reader.scalar<uint64_t>(); break;
+            case 7u: encoder << reader.scalar<double>(); break;
+            case 8u: encoder << reader.scalar<float>(); break;
+            case 9u: encoder << bool(reader.byte() & 1u); break;
+            case 10u: encoder << nullptr; break;
+            case 11u: encoder << qc::json::comment(reader.str()); break;
+            case 12u: encoder << qc::json::binary(reader.scalar<uint64_t>()); break;
+            case 13u: encoder << qc::json::octal(reader.scalar<uint64_t>()); break;
+            case 14u: encoder << qc::json::hex(reader.scalar<uint64_t>()); break;
+            case 15u: encoder.beginString(); break;
+            case 16u: encoder.appendString(reader.str()); break;
+            case 17u: encoder.endString(); break;
+            case 18u: encoder << qc::json::base64(std::as_bytes(std::span{reader.str()})); break;
+            default: static_cast<void>(encoder.finish());
+        }
+    }
+
+    static_cast<void>(encoder.finish());
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * const data, const size_t size)
+{
+    checkComplexity(data, size, [](const std::string_view input) {
+        Reader reader{input};
+        try
+        {
+            encode(reader);
+        }
+        catch (const qc::json::EncodeError &) {}
+    });
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+///
+/// Fuzzes decoding, encoding, and decoding again
+///
+/// Any input that decodes successfully must encode to JSON that also decodes successfully, and which encodes to exactly
+/// the same JSON again. Comparing the encoded strings rather than the values keeps NaN from comparing unequal
+///
+/// Only the initial decode is checked for complexity, as a valid input does several times more work than its invalid
+/// prefix
+///
+
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include <qc-json.hpp>
+
+#include "complexity.hpp"
+
+static void fail(const char * const msg, const std::string & json)
+{
+    std::fprintf(stderr, "qc-json: round trip failed, %s:\n%s\n", msg, json.c_str());
+    std::abort();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * const data, const size_t size)
+{
+    std::optional<qc::json::Value> val{};
+    checkComplexity(data, size, [&](const std::string_view json) {
+        val.reset();
+        try
+        {
+            val = qc::json::decode(json);
+        }
+        catch (const qc::json::DecodeError &) {}
+    });
+
+    if (!val)
+    {
+        return 0;
+    }
+
+    const std::string encoded{qc::json::encode(*val)};
+
+    qc::json::Value reval{};
+    try
+    {
+        reval = qc::json::decode(encoded);
+    }
+    catch (const qc::json::DecodeError &)
+    {
+        fail("encoded JSON does not decode", encoded);
+    }
+
+    if (qc::json::encode(reval) != encoded)
+    {
+        fail("re-encoded JSON differs", encoded);
+    }
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides a cache for DOM decoding
+///
+/// Uses `qc-json.hpp` to do the decoding and `qc-json-hash.hpp` to key the cache
+///
+/// See the README for more info and examples!
+///
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <qc-json.hpp>
+#include <qc-json-hash.hpp>
+
+namespace qc::json
+{
+    ///
+    /// A bounded, thread safe, least-recently-used cache in front of `qc::json::decode`
+    ///
+    /// Entries are keyed by the 128 bit hash of the JSON string, and keep a copy of the string so that a hit is only
+    /// ever an exact match. On a hit, the previously decoded value is shared rather than decoding again, so repeatedly
+    /// decoding the same handful of strings is nearly free
+    ///
+    class DecodeCache
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param capacity the maximum total size, in bytes of JSON string, of all cached entries. Strings larger than
+        ///     this are decoded but never cached
+        ///
+        explicit DecodeCache(size_t capacity) noexcept;
+
+        DecodeCache(const DecodeCache &) = delete;
+        DecodeCache & operator=(const DecodeCache &) = delete;
+
+        ///
+        /// Returns the cached value for the JSON string if there is one, otherwise decodes and caches it, evicting the
+        /// least recently used entries as necessary
+        ///
+        /// @param json the JSON string to decode
+        /// @return the shared, immutable decoded value
+        /// @throw `DecodeError` if the JSON string is invalid. Nothing is cached in this case
+        ///
+        std::shared_ptr<const Value> decode(string_view json);
+
+        ///
+        /// Removes all entries. Values still referenced elsewhere remain valid
+        ///
+        void clear() noexcept;
+
+        ///
+        /// @return the maximum total size of all cached entries
+        ///
+        size_t capacity() const noexcept;
+
+        ///
+        /// @return the current total size of all cached entries
+        ///
+        size_t size() const noexcept;
+
+        ///
+        /// @return the number of cached entries
+        ///
+        size_t count() const noexcept;
+
+        ///
+        /// @return the number of calls to `decode` that were served from the cache
+        ///
+        size_t hits() const noexcept;
+
+        ///
+        /// @return the number of calls to `decode` that had to decode
+        ///
+        size_t misses() const noexcept;
+
+        private: //-------------------------------------------------------------
+
+        struct _Entry
+        {
+            Digest digest;
+            string json;
+            std::shared_ptr<const Value> value;
+        };
+
+        struct _DigestHash
+        {
+            size_t operator()(const Digest & digest) const noexcept { return size_t(digest.low); }
+        };
+
+        size_t _capacity;
+        size_t _size{0u};
+        size_t _hits{0u};
+        size_t _misses{0u};
+        std::list<_Entry> _entries{}; // Most recently used first
+        std::unordered_map<Digest, std::list<_Entry>::iterator, _DigestHash> _lookup{};
+        mutable std::mutex _mutex{};
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    inline DecodeCache::DecodeCache(const size_t capacity) noexcept :
+        _capacity{capacity}
+    {}
+
+    inline std::shared_ptr<const Value> DecodeCache::decode(const string_view json)
+    {
+        Hasher hasher{};
+        hasher.update(json);
+        const Digest digest{hasher.digest()};
+
+        {
+            const std::scoped_lock lock{_mutex};
+
+            const auto it{_lookup.find(digest)};
+            if (it != _lookup.end() && it->second->json == json)
+            {
+                ++_hits;
+                _entries.splice(_entries.begin(), _entries, it->second);
+                return it->second->value;
+            }
+
+            ++_misses;
+        }
+
+        // Decode without holding the lock so other threads are not blocked
+        std::shared_ptr<const Value> value{std::make_shared<const Value>(::qc::json::decode(json))};
+
+        if (json.size() > _capacity)
+        {
+            return value;
+        }
+
+        const std::scoped_lock lock{_mutex};
+
+        // Another thread may have cached the same string in the meantime. A different string with the same digest is left
+        // uncached
+        if (const auto it{_lookup.find(digest)}; it != _lookup.end())
+        {
+            return it->second->json == json ? it->second->value : value;
+        }
+
+        _entries.push_front(_Entry{digest, string{json}, value});
+        _lookup.emplace(digest, _entries.begin());
+        _size += json.size();
+
+        while (_size > _capacity)
+        {
+            _size -= _entries.back().json.size();
+            _lookup.erase(_entries.back().digest);
+            _entries.pop_back();
+        }
+
+        return value;
+    }
+
+    inline void DecodeCache::clear() noexcept
+    {
+        const std::scoped_lock lock{_mutex};
+        _lookup.clear();
+        _entries.clear();
+        _size = 0u;
+    }
+
+    inline size_t DecodeCache::capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    inline size_t DecodeCache::size() const noexcept
+    {
+        const std::scoped_lock lock{_mutex};
+        return _size;
+    }
+
+    inline size_t DecodeCache::count() const noexcept
+    {
+        const std::scoped_lock lock{_mutex};
+        return _entries.size();
+    }
+
+    inline size_t DecodeCache::hits() const noexcept
+    {
+        const std::scoped_lock lock{_mutex};
+        return _hits;
+    }
+
+    inline size_t DecodeCache::misses() const noexcept
+    {
+        const std::scoped_lock lock{_mutex};
+        return _misses;
+    }
+}
@@ -0,0 +1,534 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides composer adaptors which allow multiple composers to be driven by a single decode
+///
+/// Uses `qc-json-decode.hpp` for the composer interface
+///
+/// See the README for more info and examples!
+///
+
+#include <charconv>
+#include <concepts>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <qc-json-decode.hpp>
+
+namespace qc::json
+{
+    template <typename T> struct _ObjectMethodTraits;
+    template <typename Return, typename Class, typename Arg> struct _ObjectMethodTraits<Return (Class::*)(Arg)> { using State = Return; };
+    template <typename Return, typename Class, typename Arg> struct _ObjectMethodTraits<Return (Class::*)(Arg) noexcept> { using State = Return; };
+
+    ///
+    /// The state type of a composer, as deduced from the return type of its `object` method
+    ///
+    /// This only works if `object` is neither overloaded nor a template. Otherwise, the state type must be provided
+    /// explicitly to the adaptors below
+    ///
+    template <typename Composer> using ComposerState = typename _ObjectMethodTraits<decltype(&Composer::object)>::State;
+
+    ///
+    /// A composer which forwards everything to two other composers, in order
+    ///
+    /// Tees may be nested to drive any number of composers
+    ///
+    /// Example:
+    ///     qc::json::Tee tee{composer1, composer2};
+    ///     qc::json::decode(jsonStr, tee, decltype(tee)::State{state1, state2});
+    ///
+    template <typename Composer1, typename Composer2, typename State1 = ComposerState<Composer1>, typename State2 = ComposerState<Composer2>>
+    class Tee
+    {
+        public: //--------------------------------------------------------------
+
+        struct State
+        {
+            State1 state1;
+            State2 state2;
+        };
+
+        ///
+        /// @param composer1 the first composer to forward to. Must outlive the tee
+        /// @param composer2 the second composer to forward to. Must outlive the tee
+        ///
+        Tee(Composer1 & composer1, Composer2 & composer2) noexcept;
+
+        State object(State & outerState);
+        State array(State & outerState);
+        void end(Density density, State && innerState, State & outerState);
+        void key(string_view key, State & state);
+        void val(string_view val, State & state);
+        void val(int64_t val, State & state);
+        void val(uint64_t val, State & state);
+        void val(double val, State & state);
+        void val(bool val, State & state);
+        void val(std::nullptr_t, State & state);
+        void comment(string_view comment, State & state);
+
+        private: //-------------------------------------------------------------
+
+        Composer1 & _composer1;
+        Composer2 & _composer2;
+
+        template <typename T> void _val(T val, State & state);
+    };
+
+    ///
+    /// A composer which forwards to another composer only those elements whose path is accepted by a predicate
+    ///
+    /// The path of an element is the sequence of object keys and array indices, in decimal, leading to it from the
+    /// root. The root has an empty path. The predicate is called with the path of each element before it is forwarded,
+    /// and if it returns false, that element and its entire subtree are dropped, along with its key. The predicate is
+    /// not called within dropped subtrees
+    ///
+    /// Comments are forwarded so long as their container is not dropped
+    ///
+    /// Example:
+    ///     // Drops the `password` member of the root object
+    ///     qc::json::Filter filter{composer, [](const std::vector<std::string> & path) {
+    ///         return !(path.size() == 1u && path[0] == "password");
+    ///     }};
+    ///     qc::json::decode(jsonStr, filter, decltype(filter)::State{state});
+    ///
+    template <typename Predicate, typename Composer, typename InnerState = ComposerState<Composer>>
+    class Filter
+    {
+        public: //--------------------------------------------------------------
+
+        struct State
+        {
+            std::optional<InnerState> state; // Empty if dropped
+            Container container{Container::none};
+            size_t index{0u};
+        };
+
+        ///
+        /// @param composer the composer to forward to. Must outlive the filter
+        /// @param predicate called with the path of each element, returning whether to keep it
+        ///
+        Filter(Composer & composer, Predicate predicate);
+
+        State object(State & outerState);
+        State array(State & outerState);
+        void end(Density density, State && innerState, State & outerState);
+        void key(string_view key, State & state);
+        void val(string_view val, State & state);
+        void val(int64_t val, State & state);
+        void val(uint64_t val, State & state);
+        void val(double val, State & state);
+        void val(bool val, State & state);
+        void val(std::nullptr_t, State & state);
+        void comment(string_view comment, State & state);
+
+        private: //-------------------------------------------------------------
+
+        Composer & _composer;
+        Predicate _predicate;
+        std::vector<string> _path{};
+
+        bool _accept(State & state);
+
+        template <typename T> void _val(T val, State & state);
+    };
+
+    ///
+    /// A composer which forwards to another composer, passing scalar values through a transform function first
+    ///
+    /// Each scalar value is passed to the transform if it is invocable with that value's type, otherwise the value is
+    /// forwarded unchanged. The transform may return any bool, integral, floating point, string-like, or null type,
+    /// which is forwarded as the corresponding JSON type. Beware of implicit conversions; a transform taking a `double`
+    /// will also receive integers and booleans. Constrained parameters such as `std::same_as<double> auto` avoid this
+    ///
+    /// Example:
+    ///     // Doubles all integers
+    ///     qc::json::Map map{composer, [](const std::same_as<int64_t> auto v) { return v * 2; }};
+    ///     qc::json::decode(jsonStr, map, state);
+    ///
+    template <typename Transform, typename Composer, typename State = ComposerState<Composer>>
+    class Map
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param composer the composer to forward to. Must outlive the map
+        /// @param transform the function to apply to scalar values
+        ///
+        Map(Composer & composer, Transform transform);
+
+        State object(State & outerState);
+        State array(State & outerState);
+        void end(Density density, State && innerState, State & outerState);
+        void key(string_view key, State & state);
+        void val(string_view val, State & state);
+        void val(int64_t val, State & state);
+        void val(uint64_t val, State & state);
+        void val(double val, State & state);
+        void val(bool val, State & state);
+        void val(std::nullptr_t, State & state);
+        void comment(string_view comment, State & state);
+
+        private: //-------------------------------------------------------------
+
+        Composer & _composer;
+        Transform _transform;
+
+        template <typename T> void _val(T val, State & state);
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline Tee<Composer1, Composer2, State1, State2>::Tee(Composer1 & composer1, Composer2 & composer2) noexcept :
+        _composer1{composer1},
+        _composer2{composer2}
+    {}
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline auto Tee<Composer1, Composer2, State1, State2>::object(State & outerState) -> State
+    {
+        State1 innerState1{_composer1.object(outerState.state1)};
+        return State{std::move(innerState1), _composer2.object(outerState.state2)};
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline auto Tee<Composer1, Composer2, State1, State2>::array(State & outerState) -> State
+    {
+        State1 innerState1{_composer1.array(outerState.state1)};
+        return State{std::move(innerState1), _composer2.array(outerState.state2)};
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::end(const Density density, State && innerState, State & outerState)
+    {
+        _composer1.end(density, std::move(innerState.state1), outerState.state1);
+        _composer2.end(density, std::move(innerState.state2), outerState.state2);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::key(const string_view key, State & state)
+    {
+        _composer1.key(key, state.state1);
+        _composer2.key(key, state.state2);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::val(const string_view val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::val(const int64_t val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::val(const uint64_t val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::val(const double val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::val(const bool val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::val(const std::nullptr_t, State & state)
+    {
+        _val(nullptr, state);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    inline void Tee<Composer1, Composer2, State1, State2>::comment(const string_view comment, State & state)
+    {
+        _composer1.comment(comment, state.state1);
+        _composer2.comment(comment, state.state2);
+    }
+
+    template <typename Composer1, typename Composer2, typename State1, typename State2>
+    template <typename T>
+    inline void Tee<Composer1, Composer2, State1, State2>::_val(const T val, State & state)
+    {
+        _composer1.val(val, state.state1);
+        _composer2.val(val, state.state2);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline Filter<Predicate, Composer, InnerState>::Filter(Composer & composer, Predicate predicate) :
+        _composer{composer},
+        _predicate{std::move(predicate)}
+    {}
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline auto Filter<Predicate, Composer, InnerState>::object(State & outerState) -> State
+    {
+        if (_accept(outerState))
+        {
+            _path.emplace_back();
+            return State{_composer.object(*outerState.state), Container::object};
+        }
+        else
+        {
+            return State{std::nullopt, Container::object};
+        }
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline auto Filter<Predicate, Composer, InnerState>::array(State & outerState) -> State
+    {
+        if (_accept(outerState))
+        {
+            _path.emplace_back();
+            return State{_composer.array(*outerState.state), Container::array};
+        }
+        else
+        {
+            return State{std::nullopt, Container::array};
+        }
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::end(const Density density, State && innerState, State & outerState)
+    {
+        if (innerState.state)
+        {
+            _path.pop_back();
+            _composer.end(density, std::move(*innerState.state), *outerState.state);
+        }
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::key(const string_view key, State & state)
+    {
+        // The key is only forwarded once its value is accepted
+        if (state.state)
+        {
+            _path.back() = key;
+        }
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::val(const string_view val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::val(const int64_t val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::val(const uint64_t val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::val(const double val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::val(const bool val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::val(const std::nullptr_t, State & state)
+    {
+        _val(nullptr, state);
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline void Filter<Predicate, Composer, InnerState>::comment(const string_view comment, State & state)
+    {
+        if (state.state)
+        {
+            _composer.comment(comment, *state.state);
+        }
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    inline bool Filter<Predicate, Composer, InnerState>::_accept(State & state)
+    {
+        if (!state.state)
+        {
+            return false;
+        }
+
+        if (state.container == Container::array)
+        {
+            char buffer[24];
+            const auto [end, ec]{std::to_chars(buffer, buffer + sizeof(buffer), state.index)};
+            _path.back().assign(buffer, end);
+            ++state.index;
+        }
+
+        if (!_predicate(std::as_const(_path)))
+        {
+            return false;
+        }
+
+        if (state.container == Container::object)
+        {
+            _composer.key(_path.back(), *state.state);
+        }
+
+        return true;
+    }
+
+    template <typename Predicate, typename Composer, typename InnerState>
+    template <typename T>
+    inline void Filter<Predicate, Composer, InnerState>::_val(const T val, State & state)
+    {
+        if (_accept(state))
+        {
+            _composer.val(val, *state.state);
+        }
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline Map<Transform, Composer, State>::Map(Composer & composer, Transform transform) :
+        _composer{composer},
+        _transform{std::move(transform)}
+    {}
+
+    template <typename Transform, typename Composer, typename State>
+    inline State Map<Transform, Composer, State>::object(State & outerState)
+    {
+        return _composer.object(outerState);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline State Map<Transform, Composer, State>::array(State & outerState)
+    {
+        return _composer.array(outerState);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::end(const Density density, State && innerState, State & outerState)
+    {
+        _composer.end(density, std::move(innerState), outerState);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::key(const string_view key, State & state)
+    {
+        _composer.key(key, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::val(const string_view val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::val(const int64_t val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::val(const uint64_t val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::val(const double val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::val(const bool val, State & state)
+    {
+        _val(val, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::val(const std::nullptr_t, State & state)
+    {
+        _val(nullptr, state);
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    inline void Map<Transform, Composer, State>::comment(const string_view comment, State & state)
+    {
+        _composer.comment(comment, state);
+    }
+
+    template <typename T>
+    inline auto _normalizeScalar(T && val) noexcept
+    {
+        using U = std::remove_cvref_t<T>;
+
+        if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, std::nullptr_t>)
+        {
+            return val;
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+        {
+            return int64_t(val);
+        }
+        else if constexpr (std::is_integral_v<U>)
+        {
+            return uint64_t(val);
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            return double(val);
+        }
+        else
+        {
+            static_assert(std::is_convertible_v<T &&, string_view>, "Transform must return a JSON scalar type");
+            // Any temporary lives until the end of the full expression in `Map::_val`
+            return string_view(val);
+        }
+    }
+
+    template <typename Transform, typename Composer, typename State>
+    template <typename T>
+    inline void Map<Transform, Composer, State>::_val(const T val, State & state)
+    {
+        if constexpr (std::is_invocable_v<Transform &, T>)
+        {
+            _composer.val(_normalizeScalar(_transform(val)), state);
+        }
+        else
+        {
+            _composer.val(val, state);
+        }
+    }
+}
@@ -0,0 +1,992 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides streaming gzip and zstd decompression of JSON input and compression of encoder output
+///
+/// Requires `QC_JSON_ZLIB` and/or `QC_JSON_ZSTD` to be defined and the corresponding system library to be linked. The
+/// `QC_JSON_COMPRESSION` CMake option does both
+///
+/// See the README for more info and examples!
+///
+
+#if !defined(QC_JSON_ZLIB) && !defined(QC_JSON_ZSTD)
+    #error "qc-json-compress.hpp requires `QC_JSON_ZLIB` and/or `QC_JSON_ZSTD` to be defined"
+#endif
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#ifdef QC_JSON_ZLIB
+    #include <zlib.h>
+#endif
+#ifdef QC_JSON_ZSTD
+    #include <zstd.h>
+#endif
+
+#if defined(__linux__) && UINTPTR_MAX > 0xFFFFFFFFu && !defined(QC_JSON_NO_DECOMPRESS_MMAP)
+    #define QC_JSON_DECOMPRESS_MMAP
+    #include <sys/mman.h>
+#endif
+
+#include <qc-json.hpp>
+
+namespace qc::json
+{
+    ///
+    /// Thrown when compressed data is invalid or truncated, or when compression fails
+    ///
+    struct CompressionError : Error
+    {
+        explicit CompressionError(string_view msg) noexcept;
+    };
+
+    ///
+    /// The supported compression formats
+    ///
+    enum class Compression
+    {
+        none,
+        gzip, // Also accepts zlib when decompressing
+        zstd
+    };
+
+    ///
+    /// Detects the compression format from the first few bytes of the data
+    ///
+    /// @param data the start of the data, at least four bytes to detect zstd
+    /// @return the detected format, or `none` if the data is not recognized as compressed
+    ///
+    Compression detectCompression(string_view data) noexcept;
+
+    ///
+    /// Incrementally decompresses a gzip or zstd stream, appending the output directly to a destination string
+    ///
+    /// Concatenated gzip members and zstd frames are decompressed as one stream
+    ///
+    /// Example:
+    ///     qc::json::Decompressor decompressor{qc::json::Compression::zstd};
+    ///     std::string json{};
+    ///     while (...) decompressor.update(nextCompressedChunk, json);
+    ///     decompressor.finish();
+    ///     qc::json::decode(json, composer, state);
+    ///
+    class Decompressor
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param compression the format of the compressed stream. Must not be `none`
+        /// @throw `CompressionError` if support for the format was not compiled in
+        ///
+        explicit Decompressor(Compression compression);
+
+        Decompressor(const Decompressor &) = delete;
+
+        ~Decompressor() noexcept;
+
+        Decompressor & operator=(const Decompressor &) = delete;
+
+        ///
+        /// Decompresses the next chunk of the stream
+        ///
+        /// @param chunk the next chunk of compressed data, which may be any size
+        /// @param out the decompressed data is appended to this
+        /// @throw `CompressionError` if the data is invalid
+        ///
+        void update(string_view chunk, string & out);
+
+        ///
+        /// Decompresses as much of the stream as fits into a fixed buffer
+        ///
+        /// Returns once either all of `in` has been taken and all the output it gives has been written, or `out` has
+        /// reached `outEnd`. In the latter case, there may be more output pending, so this should be called again with
+        /// more room, even if `in` is empty
+        ///
+        /// @param in the next compressed data, from which what was taken is removed
+        /// @param out where to write the decompressed data, which is advanced past what was written
+        /// @param outEnd the end of the room to write to
+        /// @throw `CompressionError` if the data is invalid
+        ///
+        void update(string_view & in, char * & out, char * outEnd);
+
+        ///
+        /// Must be called once the last chunk has been passed to `update`
+        ///
+        /// @throw `CompressionError` if the stream ended partway through a gzip member or zstd frame
+        ///
+        void finish();
+
+        private: //-------------------------------------------------------------
+
+        Compression _compression;
+        bool _ended{false};
+        #ifdef QC_JSON_ZLIB
+        z_stream _zlib{};
+        #endif
+        #ifdef QC_JSON_ZSTD
+        ZSTD_DStream * _zstd{nullptr};
+        #endif
+    };
+
+    ///
+    /// Convenience function to decompress data held entirely in memory
+    ///
+    /// @param data the compressed data. Its format is detected automatically
+    /// @return the decompressed data, or a copy of `data` if it is not compressed
+    /// @throw `CompressionError` if the data is invalid
+    ///
+    string decompress(string_view data);
+
+    ///
+    /// Reads a file, decompressing it in chunks as it is read. Neither the whole compressed file nor a temporary file is
+    /// ever held; the decompressed data is written directly into the returned string. To decode a file too large to be
+    /// held decompressed, use `decodeCompressed` instead
+    ///
+    /// @param path the file to read. Its format is detected automatically, and uncompressed files are read as is
+    /// @return the decompressed contents of the file
+    /// @throw `CompressionError` if the file cannot be read or is invalid
+    ///
+    string readCompressed(const std::filesystem::path & path);
+
+    ///
+    /// Decodes a file while it is still being decompressed
+    ///
+    /// A background thread decompresses the file while the calling thread decodes whatever has come out so far. The
+    /// decompressed JSON is never held in full: decompression gets at most about `window` bytes ahead of the decoder, and
+    /// the memory behind what has been decoded is given back to the system, so files much larger than memory may be
+    /// decoded. This lays the input out in a region of address space reserved up front, which is only done on 64 bit
+    /// Linux. Elsewhere, or if the reservation fails, the file is read with `readCompressed` and then decoded
+    ///
+    /// String views given to the composer are only valid for the duration of the call
+    ///
+    /// @param path the file to decode. Its format is detected automatically, and uncompressed files are read as is
+    /// @param composer the composer to receive the decoded JSON, as with `decode`
+    /// @param initialState the state of the root, as with `decode`
+    /// @param window roughly how many decompressed bytes may be held ahead of the decoder
+    /// @throw `CompressionError` if the file cannot be read or is invalid
+    /// @throw `DecodeError` if the JSON is invalid
+    ///
+    template <typename Composer, typename State> void decodeCompressed(const std::filesystem::path & path, Composer & composer, State & initialState, size_t window = 64u << 20);
+    template <typename Composer, typename State> void decodeCompressed(const std::filesystem::path & path, Composer & composer, State && initialState, size_t window = 64u << 20);
+
+    ///
+    /// Decodes a compressed file to a DOM while it is still being decompressed. See the SAX `decodeCompressed` above
+    ///
+    /// @param path the file to decode
+    /// @param window roughly how many decompressed bytes may be held ahead of the decoder
+    /// @return the root value of the JSON
+    /// @throw `CompressionError` if the file cannot be read or is invalid
+    /// @throw `DecodeError` if the JSON is invalid
+    ///
+    Value decodeCompressed(const std::filesystem::path & path, size_t window = 64u << 20);
+
+    #ifdef QC_JSON_ZLIB
+    ///
+    /// A sink that gzip compresses the encoded JSON and writes it on to another sink
+    ///
+    /// The sink may be reused across multiple `Encoder::finish` calls, each producing a separate gzip member
+    ///
+    /// Example:
+    ///     FileSink fileSink{"out.json.gz"};
+    ///     qc::json::GzipSink sink{fileSink};
+    ///     encoder.setSink(&sink);
+    ///     encoder << ...;
+    ///     encoder.finish();
+    ///
+    class GzipSink : public Sink
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param sink the sink to receive the compressed data. Must outlive this sink
+        /// @param level the compression level, from 0 to 9
+        /// @param bufferSize roughly how many compressed bytes to buffer before each write to `sink`
+        /// @throw `CompressionError` if zlib fails to initialize
+        ///
+        explicit GzipSink(Sink & sink, int level = Z_DEFAULT_COMPRESSION, size_t bufferSize = 65536u);
+
+        GzipSink(const GzipSink &) = delete;
+
+        ~GzipSink() noexcept override;
+
+        GzipSink & operator=(const GzipSink &) = delete;
+
+        void write(string_view chunk) override;
+
+        void finish() override;
+
+        private: //-------------------------------------------------------------
+
+        Sink & _sink;
+        z_stream _zlib{};
+        string _buffer;
+
+        void _deflate(int flush);
+
+        void _flush();
+    };
+    #endif
+
+    #ifdef QC_JSON_ZSTD
+    ///
+    /// A sink that zstd compresses the encoded JSON and writes it on to another sink
+    ///
+    /// The sink may be reused across multiple `Encoder::finish` calls, each producing a separate zstd frame
+    ///
+    class ZstdSink : public Sink
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param sink the sink to receive the compressed data. Must outlive this sink
+        /// @param level the compression level, from 1 to 22
+        /// @param bufferSize roughly how many compressed bytes to buffer before each write to `sink`
+        /// @throw `CompressionError` if zstd fails to initialize
+        ///
+        explicit ZstdSink(Sink & sink, int level = 3, size_t bufferSize = 65536u);
+
+        ZstdSink(const ZstdSink &) = delete;
+
+        ~ZstdSink() noexcept override;
+
+        ZstdSink & operator=(const ZstdSink &) = delete;
+
+        void write(string_view chunk) override;
+
+        void finish() override;
+
+        private: //-------------------------------------------------------------
+
+        Sink & _sink;
+        ZSTD_CCtx * _zstd{nullptr};
+        string _buffer;
+        size_t _bufferPos{0u};
+
+        void _flush();
+    };
+    #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    // How much room to make in the output for each step of decompression, and how much of a file to read at a time
+    inline constexpr size_t _decompressChunkSize{65536u};
+
+    inline CompressionError::CompressionError(const string_view msg) noexcept :
+        Error{msg}
+    {}
+
+    inline Compression detectCompression(const string_view data) noexcept
+    {
+        if (data.size() >= 2u && uchar(data[0]) == 0x1Fu && uchar(data[1]) == 0x8Bu)
+        {
+            return Compression::gzip;
+        }
+        if (data.size() >= 4u && uchar(data[0]) == 0x28u && uchar(data[1]) == 0xB5u && uchar(data[2]) == 0x2Fu && uchar(data[3]) == 0xFDu)
+        {
+            return Compression::zstd;
+        }
+        return Compression::none;
+    }
+
+    inline Decompressor::Decompressor(const Compression compression) :
+        _compression{compression}
+    {
+        switch (compression)
+        {
+            case Compression::gzip:
+            {
+                #ifdef QC_JSON_ZLIB
+                // 15 bit window, +32 to detect gzip or zlib from the header
+                if (inflateInit2(&_zlib, 15 + 32) != Z_OK)
+                {
+                    _throw<CompressionError>("Failed to initialize zlib"sv);
+                }
+                return;
+                #else
+                _throw<CompressionError>("Built without gzip support"sv);
+                #endif
+            }
+            case Compression::zstd:
+            {
+                #ifdef QC_JSON_ZSTD
+                _zstd = ZSTD_createDStream();
+                if (!_zstd)
+                {
+                    _throw<CompressionError>("Failed to initialize zstd"sv);
+                }
+                return;
+                #else
+                _throw<CompressionError>("Built without zstd support"sv);
+                #endif
+            }
+            default:
+            {
+                _throw<CompressionError>("No compression to decompress"sv);
+            }
+        }
+    }
+
+    inline Decompressor::~Decompressor() noexcept
+    {
+        #ifdef QC_JSON_ZLIB
+        if (_compression == Compression::gzip)
+        {
+            inflateEnd(&_zlib);
+        }
+        #endif
+        #ifdef QC_JSON_ZSTD
+        ZSTD_freeDStream(_zstd);
+        #endif
+    }
+
+    inline void Decompressor::update(string_view chunk, string & out)
+    {
+        // Each step decompresses into a fixed amount of new room at the end of `out`. Only that room is filled before
+        // being written over, and the string's capacity still grows geometrically
+        while (true)
+        {
+            const size_t offset{out.size()};
+            out.resize(offset + _decompressChunkSize);
+            char * pos{out.data() + offset};
+            char * const end{out.data() + out.size()};
+            update(chunk, pos, end);
+            out.resize(size_t(pos - out.data()));
+
+            if (pos != end)
+            {
+                return;
+            }
+        }
+    }
+
+    inline void Decompressor::update(string_view & in, char * & out, char * const outEnd)
+    {
+        #ifdef QC_JSON_ZLIB
+        if (_compression == Compression::gzip)
+        {
+            while (true)
+            {
+                // Another gzip member follows the one just ended
+                if (_ended && !in.empty())
+                {
+                    inflateReset(&_zlib);
+                    _ended = false;
+                }
+
+                // zlib counts in `uInt`, so give it no more than it can take at a time
+                const size_t inSize{std::min(in.size(), size_t(UINT_MAX))};
+                const size_t room{std::min(size_t(outEnd - out), size_t(UINT_MAX))};
+                _zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+                _zlib.avail_in = uInt(inSize);
+                _zlib.next_out = reinterpret_cast<Bytef *>(out);
+                _zlib.avail_out = uInt(room);
+                const int result{inflate(&_zlib, Z_NO_FLUSH)};
+                in.remove_prefix(inSize - _zlib.avail_in);
+                out += room - _zlib.avail_out;
+                _zlib.next_in = nullptr;
+                _zlib.avail_in = 0u;
+
+                if (result == Z_STREAM_END)
+                {
+                    _ended = true;
+                }
+                else if (result != Z_OK && result != Z_BUF_ERROR)
+                {
+                    _throw<CompressionError>("Invalid gzip data"sv);
+                }
+
+                // Room left over means everything that could be was written
+                if (out == outEnd || (in.empty() && _zlib.avail_out))
+                {
+                    return;
+                }
+            }
+        }
+        #endif
+
+        #ifdef QC_JSON_ZSTD
+        if (_compression == Compression::zstd)
+        {
+            ZSTD_inBuffer inBuffer{in.data(), in.size(), 0u};
+            while (true)
+            {
+                const size_t inPos{inBuffer.pos};
+                ZSTD_outBuffer outBuffer{out, size_t(outEnd - out), 0u};
+                const size_t result{ZSTD_decompressStream(_zstd, &outBuffer, &inBuffer)};
+                out += outBuffer.pos;
+
+                if (ZSTD_isError(result))
+                {
+                    _throw<CompressionError>("Invalid zstd data"sv);
+                }
+                // Zero means a frame was just completed. A call that did nothing, as when the output was filled exactly
+                // by the end of the frame, says nothing about that
+                if (inBuffer.pos != inPos || outBuffer.pos)
+                {
+                    _ended = result == 0u;
+                }
+
+                if (out == outEnd || inBuffer.pos == inBuffer.size)
+                {
+                    break;
+                }
+            }
+            in.remove_prefix(inBuffer.pos);
+        }
+        #endif
+    }
+
+    inline void Decompressor::finish()
+    {
+        if (!_ended)
+        {
+            _throw<CompressionError>(_compression == Compression::gzip ? "Truncated gzip data"sv : "Truncated zstd data"sv);
+        }
+    }
+
+    inline string decompress(const string_view data)
+    {
+        const Compression compression{detectCompression(data)};
+        if (compression == Compression::none)
+        {
+            return string{data};
+        }
+
+        string out{};
+        Decompressor decompressor{compression};
+        decompressor.update(data, out);
+        decompressor.finish();
+        return out;
+    }
+
+    inline string readCompressed(const std::filesystem::path & path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file)
+        {
+            _throw<CompressionError>("Failed to open file"sv);
+        }
+
+        string chunk(_decompressChunkSize, '\0');
+        const auto readChunk{[&]() -> string_view {
+            file.read(chunk.data(), std::streamsize(chunk.size()));
+            if (file.bad())
+            {
+                _throw<CompressionError>("Failed to read file"sv);
+            }
+            return string_view{chunk.data(), size_t(file.gcount())};
+        }};
+
+        string_view current{readChunk()};
+        const Compression compression{detectCompression(current)};
+
+        string out{};
+
+        if (compression == Compression::none)
+        {
+            while (!current.empty())
+            {
+                out += current;
+                current = readChunk();
+            }
+            return out;
+        }
+
+        // Reserve up front if the decompressed size is known, saving the regrowth
+        #ifdef QC_JSON_ZSTD
+        if (compression == Compression::zstd)
+        {
+            const unsigned long long size{ZSTD_getFrameContentSize(current.data(), current.size())};
+            if (size != ZSTD_CONTENTSIZE_UNKNOWN && size != ZSTD_CONTENTSIZE_ERROR)
+            {
+                out.reserve(size_t(size));
+            }
+        }
+        #endif
+
+        Decompressor decompressor{compression};
+        while (!current.empty())
+        {
+            decompressor.update(current, out);
+            current = readChunk();
+        }
+        decompressor.finish();
+
+        return out;
+    }
+
+    #ifdef QC_JSON_DECOMPRESS_MMAP
+
+    // How much address space to reserve for the decompressed input. Only a small part of it is ever backed by memory
+    inline constexpr size_t _decompressReservation{size_t{1u} << 40};
+
+    // How much to decompress before each update of the decoder's limit
+    inline constexpr size_t _decompressStepSize{size_t{1u} << 20};
+
+    // Memory the decoder has passed is given back to the system in multiples of this
+    inline constexpr size_t _decompressReleaseSize{size_t{4u} << 20};
+
+    // Decompresses a file on a background thread into a reserved region of address space while the decoder reads it
+    //
+    // The region is large enough for any input so that the decoder sees it whole, but only the part between the decoder
+    // and the end of what has been decompressed is ever backed by memory. Decompression waits once it is `window` bytes
+    // ahead of the decoder, unless the decoder is waiting on it, and the pages the decoder has passed are released as it
+    // goes. The limit given to the decoder is found just as by `_FileReader`
+    class _DecompressReader final : public _InputSource
+    {
+        public: //--------------------------------------------------------------
+
+        _DecompressReader(const std::filesystem::path & path, const size_t window) :
+            _file{path, std::ios::binary},
+            _chunk(_decompressChunkSize, '\0'),
+            _window{std::max(window, 2u * _decompressStepSize)}
+        {
+            if (!_file)
+            {
+                _throw<CompressionError>("Failed to open file"sv);
+            }
+
+            _readChunk();
+            const Compression compression{detectCompression(_pending)};
+            if (compression != Compression::none)
+            {
+                _decompressor.emplace(compression);
+            }
+
+            // Done last so that nothing after it can fail. If it cannot be reserved, the caller falls back on other means
+            void * const data{::mmap(nullptr, _decompressReservation, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0)};
+            if (data == MAP_FAILED)
+            {
+                return;
+            }
+            _data.reset(static_cast<char *>(data));
+            _ready = _data.get();
+            _consumed = _data.get();
+            _thread = std::thread{&_DecompressReader::_run, this};
+        }
+
+        _DecompressReader(const _DecompressReader &) = delete;
+
+        ~_DecompressReader() noexcept
+        {
+            if (_thread.joinable())
+            {
+                {
+                    const std::lock_guard<std::mutex> lock{_mutex};
+                    _stop = true;
+                }
+                _roomCondition.notify_one();
+                _thread.join();
+            }
+        }
+
+        _DecompressReader & operator=(const _DecompressReader &) = delete;
+
+        bool mapped() const noexcept
+        {
+            return bool(_data);
+        }
+
+        string_view view() const noexcept
+        {
+            return string_view{_data.get(), _decompressReservation};
+        }
+
+        const char * await(const char * const pos, bool & complete) override
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _consumed = pos;
+            _roomCondition.notify_one();
+            _readyCondition.wait(lock, [&]() { return _done || _ready > pos; });
+
+            if (!_error.empty())
+            {
+                _throw<CompressionError>(_error);
+            }
+
+            complete = _done;
+            return _ready;
+        }
+
+        private: //-------------------------------------------------------------
+
+        struct _Unmap
+        {
+            void operator()(char * const data) const noexcept
+            {
+                ::munmap(data, _decompressReservation);
+            }
+        };
+
+        std::ifstream _file;
+        string _chunk;
+        string_view _pending{};
+        std::optional<Decompressor> _decompressor{};
+        size_t _window;
+        std::unique_ptr<char, _Unmap> _data{};
+        std::thread _thread{};
+        std::atomic<bool> _stop{false};
+
+        // Guarded by `_mutex`
+        std::mutex _mutex{};
+        std::condition_variable _readyCondition{};
+        std::condition_variable _roomCondition{};
+        const char * _ready{nullptr};
+        const char * _consumed{nullptr};
+        bool _done{false};
+        string _error{};
+
+        // Only touched by the decompressing thread once started
+        _ReadAheadLexer _lexer{};
+        size_t _written{0u};
+        size_t _released{0u};
+
+        void _run() noexcept
+        {
+            #ifdef QC_JSON_NO_EXCEPTIONS
+            _decompress();
+            #else
+            try
+            {
+                _decompress();
+            }
+            catch (const CompressionError & e)
+            {
+                {
+                    const std::lock_guard<std::mutex> lock{_mutex};
+                    _error = e.what();
+                    _done = true;
+                }
+                _readyCondition.notify_one();
+            }
+            #endif
+        }
+
+        void _decompress()
+        {
+            char * const data{_data.get()};
+            bool eof{false};
+
+            while (true)
+            {
+                const char * consumed;
+                {
+                    std::unique_lock<std::mutex> lock{_mutex};
+                    _roomCondition.wait(lock, [&]() { return _stop || _ready <= _consumed || size_t(data + _written - _consumed) < _window; });
+                    consumed = _consumed;
+                }
+                if (_stop)
+                {
+                    return;
+                }
+
+                // The decoder holds nothing behind where it last waited
+                const size_t passed{size_t(consumed - data) / _decompressReleaseSize * _decompressReleaseSize};
+                if (passed > _released)
+                {
+                    ::madvise(data + _released, passed - _released, MADV_DONTNEED);
+                    _released = passed;
+                }
+
+                if (_written + _decompressStepSize > _decompressReservation)
+                {
+                    _throw<CompressionError>("Decompressed data is too large"sv);
+                }
+
+                char * out{data + _written};
+                char * const outEnd{out + _decompressStepSize};
+                bool finished{false};
+                while (out != outEnd)
+                {
+                    if (_pending.empty() && !eof)
+                    {
+                        _readChunk();
+                        eof = _pending.empty();
+                    }
+
+                    _fill(out, outEnd);
+
+                    // Room left over means all input has been taken and all its output written
+                    if (out != outEnd && eof)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                _written = size_t(out - data);
+
+                if (finished)
+                {
+                    if (_decompressor)
+                    {
+                        _decompressor->finish();
+                    }
+                    {
+                        const std::lock_guard<std::mutex> lock{_mutex};
+                        _ready = out;
+                        _done = true;
+                    }
+                    _readyCondition.notify_one();
+                    return;
+                }
+
+                const size_t limit{_lexer.lexTo(data, _written - _readAheadLookahead)};
+                if (limit)
+                {
+                    const std::lock_guard<std::mutex> lock{_mutex};
+                    _ready = data + limit;
+                }
+                _readyCondition.notify_one();
+            }
+        }
+
+        void _readChunk()
+        {
+            _file.read(_chunk.data(), std::streamsize(_chunk.size()));
+            if (_file.bad())
+            {
+                _throw<CompressionError>("Failed to read file"sv);
+            }
+            _pending = string_view{_chunk.data(), size_t(_file.gcount())};
+        }
+
+        // Decompresses, or copies if uncompressed, as much pending input as fits
+        void _fill(char * & out, char * const outEnd)
+        {
+            if (_decompressor)
+            {
+                _decompressor->update(_pending, out, outEnd);
+            }
+            else
+            {
+                const size_t n{std::min(_pending.size(), size_t(outEnd - out))};
+                std::memcpy(out, _pending.data(), n);
+                out += n;
+                _pending.remove_prefix(n);
+            }
+        }
+    };
+
+    #endif
+
+    template <typename Composer, typename State>
+    inline void decodeCompressed(const std::filesystem::path & path, Composer & composer, State & initialState, [[maybe_unused]] const size_t window)
+    {
+        #ifdef QC_JSON_DECOMPRESS_MMAP
+        {
+            _DecompressReader reader{path, window};
+            if (reader.mapped())
+            {
+                const DecodeResult result{_decode<true>(reader.view(), composer, initialState, &reader)};
+                #ifdef QC_JSON_NO_EXCEPTIONS
+                if (!result)
+                {
+                    std::abort();
+                }
+                #else
+                static_cast<void>(result);
+                #endif
+                return;
+            }
+        }
+        #endif
+
+        decode(readCompressed(path), composer, initialState);
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeCompressed(const std::filesystem::path & path, Composer & composer, State && initialState, const size_t window)
+    {
+        decodeCompressed(path, composer, initialState, window);
+    }
+
+    inline Value decodeCompressed(const std::filesystem::path & path, const size_t window)
+    {
+        Value root{};
+        _Composer::State rootState{&root, Container::none};
+        _Composer composer{};
+        decodeCompressed(path, composer, rootState, window);
+        return root;
+    }
+
+    #ifdef QC_JSON_ZLIB
+
+    inline GzipSink::GzipSink(Sink & sink, const int level, const size_t bufferSize) :
+        _sink{sink},
+        _buffer(std::clamp(bufferSize, size_t{64u}, size_t(UINT_MAX)), '\0')
+    {
+        // 15 bit window, +16 for a gzip header and trailer rather than zlib
+        if (deflateInit2(&_zlib, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            _throw<CompressionError>("Failed to initialize zlib"sv);
+        }
+        _zlib.next_out = reinterpret_cast<Bytef *>(_buffer.data());
+        _zlib.avail_out = uInt(_buffer.size());
+    }
+
+    inline GzipSink::~GzipSink() noexcept
+    {
+        deflateEnd(&_zlib);
+    }
+
+    inline void GzipSink::write(string_view chunk)
+    {
+        while (!chunk.empty())
+        {
+            const size_t n{std::min(chunk.size(), size_t(UINT_MAX))};
+            _zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(chunk.data()));
+            _zlib.avail_in = uInt(n);
+            _deflate(Z_NO_FLUSH);
+            chunk.remove_prefix(n);
+        }
+    }
+
+    inline void GzipSink::finish()
+    {
+        _zlib.next_in = nullptr;
+        _zlib.avail_in = 0u;
+        _deflate(Z_FINISH);
+        _flush();
+
+        // Ready for the next member
+        deflateReset(&_zlib);
+
+        _sink.finish();
+    }
+
+    inline void GzipSink::_deflate(const int flush)
+    {
+        while (true)
+        {
+            if (!_zlib.avail_out)
+            {
+                _flush();
+            }
+
+            const int result{deflate(&_zlib, flush)};
+            if (result == Z_STREAM_END)
+            {
+                return;
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                _throw<CompressionError>("Failed to compress"sv);
+            }
+            // Only done once all input is consumed and there was room to spare, or else there may be more pending
+            if (flush == Z_NO_FLUSH && !_zlib.avail_in && _zlib.avail_out)
+            {
+                return;
+            }
+        }
+    }
+
+    inline void GzipSink::_flush()
+    {
+        const size_t size{_buffer.size() - _zlib.avail_out};
+        if (size)
+        {
+            _sink.write(string_view{_buffer.data(), size});
+        }
+        _zlib.next_out = reinterpret_cast<Bytef *>(_buffer.data());
+        _zlib.avail_out = uInt(_buffer.size());
+    }
+
+    #endif
+
+    #ifdef QC_JSON_ZSTD
+
+    inline ZstdSink::ZstdSink(Sink & sink, const int level, const size_t bufferSize) :
+        _sink{sink},
+        _zstd{ZSTD_createCCtx()},
+        _buffer(std::max(bufferSize, size_t{64u}), '\0')
+    {
+        if (!_zstd || ZSTD_isError(ZSTD_CCtx_setParameter(_zstd, ZSTD_c_compressionLevel, level)))
+        {
+            ZSTD_freeCCtx(_zstd);
+            _throw<CompressionError>("Failed to initialize zstd"sv);
+        }
+    }
+
+    inline ZstdSink::~ZstdSink() noexcept
+    {
+        ZSTD_freeCCtx(_zstd);
+    }
+
+    inline void ZstdSink::write(const string_view chunk)
+    {
+        ZSTD_inBuffer in{chunk.data(), chunk.size(), 0u};
+        while (in.pos < in.size)
+        {
+            ZSTD_outBuffer out{_buffer.data(), _buffer.size(), _bufferPos};
+            const size_t result{ZSTD_compressStream2(_zstd, &out, &in, ZSTD_e_continue)};
+            if (ZSTD_isError(result))
+            {
+                _throw<CompressionError>("Failed to compress"sv);
+            }
+            _bufferPos = out.pos;
+            if (_bufferPos == _buffer.size())
+            {
+                _flush();
+            }
+        }
+    }
+
+    inline void ZstdSink::finish()
+    {
+        // Ends the frame. A new one is started automatically by the next write
+        ZSTD_inBuffer in{nullptr, 0u, 0u};
+        size_t remaining;
+        do
+        {
+            ZSTD_outBuffer out{_buffer.data(), _buffer.size(), _bufferPos};
+            remaining = ZSTD_compressStream2(_zstd, &out, &in, ZSTD_e_end);
+            if (ZSTD_isError(remaining))
+            {
+                _throw<CompressionError>("Failed to compress"sv);
+            }
+            _bufferPos = out.pos;
+            if (remaining)
+            {
+                _flush();
+            }
+        } while (remaining);
+        _flush();
+
+        _sink.finish();
+    }
+
+    inline void ZstdSink::_flush()
+    {
+        if (_bufferPos)
+        {
+            _sink.write(string_view{_buffer.data(), _bufferPos});
+            _bufferPos = 0u;
+        }
+    }
+
+    #endif
+}
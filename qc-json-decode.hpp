@@ -15,18 +15,35 @@
 ///
 
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 
+#include <algorithm>
+#include <array>
 #include <charconv>
+#include <concepts>
 #include <limits>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <system_error>
 #include <utility>
+#include <vector>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+    #include <tmmintrin.h>
+    #define QC_JSON_DECODE_SSSE3
+#endif
 
 #ifndef QC_JSON_COMMON
 #define QC_JSON_COMMON
 
+// Defined automatically when compiling with exceptions disabled (`-fno-exceptions`, `/EHs-c-`), or may be defined manually
+#if !defined(QC_JSON_NO_EXCEPTIONS) && (defined(_MSC_VER) ? !defined(_CPPUNWIND) : !defined(__cpp_exceptions))
+    #define QC_JSON_NO_EXCEPTIONS
+#endif
+
 namespace qc::json
 {
     using std::string;
@@ -42,10 +59,22 @@ namespace qc::json
     struct Error : std::runtime_error
     {
         explicit Error(const string_view msg = {}) noexcept :
-            std::runtime_error(msg.data())
+            std::runtime_error(string{msg})
         {}
     };
 
+    // Throws the error, or aborts if exceptions are disabled. Either way, reaching it in constant evaluation is a compile
+    // error
+    template <typename E, typename... Args>
+    [[noreturn]] constexpr void _throw([[maybe_unused]] Args &&... args)
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        std::abort();
+        #else
+        throw E{std::forward<Args>(args)...};
+        #endif
+    }
+
     ///
     /// Simple enum representing a json container type
     ///
@@ -70,6 +99,85 @@ namespace qc::json
 
 #endif // QC_JSON_COMMON
 
+#if defined(QC_JSON_TRACE) && !defined(QC_JSON_TRACE_COMMON)
+#define QC_JSON_TRACE_COMMON
+
+#include <atomic>
+#include <chrono>
+
+#if __has_include(<sys/sdt.h>)
+    #include <sys/sdt.h>
+    #define QC_JSON_USDT
+#endif
+
+namespace qc::json
+{
+    ///
+    /// The operations reported when `QC_JSON_TRACE` is defined
+    ///
+    enum class TraceOperation : int8_t
+    {
+        saxDecode, /// Any `decode` with a composer, including those used by the others
+        domDecode, /// `decode(string_view)`, including building the DOM
+        saxEncode, /// `Encoder::finish`, covering everything since the first element of the JSON
+        domEncode  /// `encode(const Value &)`
+    };
+
+    ///
+    /// Details of a traced operation
+    ///
+    struct TraceInfo
+    {
+        TraceOperation operation;
+        size_t bytes; /// The number of bytes decoded or encoded. For a failed decode, the position of the failure
+        size_t nodes; /// The number of values, including objects and arrays
+        size_t depth; /// The maximum depth of nested objects and arrays
+        std::chrono::nanoseconds elapsed;
+        bool failed;
+    };
+
+    ///
+    /// Called upon completion of every traced operation, on the thread that did it. Must not throw
+    ///
+    using TraceHook = void (*)(const TraceInfo & info);
+
+    inline std::atomic<TraceHook> _traceHook{nullptr};
+
+    // The most recent trace on this thread, so that the DOM operations can report what the SAX operations counted
+    inline thread_local TraceInfo _lastTrace{};
+
+    ///
+    /// Sets the function to call upon completion of each traced operation. Pass `nullptr` to stop
+    ///
+    inline void setTraceHook(const TraceHook hook) noexcept
+    {
+        _traceHook.store(hook, std::memory_order_relaxed);
+    }
+
+    inline void _trace(const TraceInfo & info) noexcept
+    {
+        _lastTrace = info;
+
+        #ifdef QC_JSON_USDT
+        const long long elapsed{info.elapsed.count()};
+        switch (info.operation)
+        {
+            case TraceOperation::saxDecode: DTRACE_PROBE5(qc_json, sax_decode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+            case TraceOperation::domDecode: DTRACE_PROBE5(qc_json, dom_decode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+            case TraceOperation::saxEncode: DTRACE_PROBE5(qc_json, sax_encode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+            case TraceOperation::domEncode: DTRACE_PROBE5(qc_json, dom_encode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+        }
+        #endif
+
+        if (const TraceHook hook{_traceHook.load(std::memory_order_relaxed)})
+        {
+            hook(info);
+        }
+    }
+}
+
+#endif // QC_JSON_TRACE_COMMON
+
 namespace qc::json
 {
     ///
@@ -82,6 +190,16 @@ namespace qc::json
         DecodeError(const string_view msg, size_t position) noexcept;
     };
 
+    ///
+    /// A composer may throw this, or a type derived from it, to abort decoding. The decoder fills in the position
+    ///
+    /// Composers have no means of aborting decoding when exceptions are disabled
+    ///
+    struct ComposeError : DecodeError
+    {
+        explicit ComposeError(const string_view msg) noexcept;
+    };
+
     ///
     /// Decodes the JSON string
     ///
@@ -95,15 +213,56 @@ namespace qc::json
     /// @param json the string to decode
     /// @param composer the contents of the JSON are decoded in order and passed to this to do something with
     /// @param initialState the initial state object to be passed to the composer
+    /// @throw `DecodeError` if the JSON is invalid. If exceptions are disabled, aborts instead
     ///
     template <typename Composer, typename State> void decode(string_view json, Composer & composer, State & initialState);
     template <typename Composer, typename State> void decode(string_view json, Composer & composer, State && initialState);
 
+    ///
+    /// The outcome of `tryDecode`
+    ///
+    struct DecodeResult
+    {
+        bool success{true}; /// Whether the JSON was decoded in its entirety
+        string message{}; /// What went wrong, if anything
+        size_t position{0u}; /// The index into the string where the error occurred
+
+        explicit operator bool() const noexcept;
+    };
+
+    ///
+    /// Same as `decode`, but reports errors via the result rather than by throwing, and so may be used when exceptions
+    /// are disabled
+    ///
+    /// On failure, the composer receives no further calls, so any objects or arrays it has open are never ended
+    ///
+    /// @return the result, which converts to `true` on success
+    ///
+    template <typename Composer, typename State> DecodeResult tryDecode(string_view json, Composer & composer, State & initialState);
+    template <typename Composer, typename State> DecodeResult tryDecode(string_view json, Composer & composer, State && initialState);
+
+    ///
+    /// The maximum size of the chunks passed to a composer's `stringChunk` method
+    ///
+    inline constexpr size_t stringChunkSize{64u * 1024u};
+
     ///
     /// An example composer whose operations are all no-ops
     ///
     /// Any custom composer must provide matching methods. This class may be extended for baseline no-ops
     ///
+    /// A composer may additionally provide all three of the following methods to receive string values in chunks of up
+    /// to `stringChunkSize` bytes rather than all at once, in which case string values are never passed to `val`. Keys
+    /// are still passed whole to `key`
+    ///     void stringBegin(State & state);
+    ///     void stringChunk(std::string_view chunk, State & state);
+    ///     void stringEnd(State & state);
+    ///
+    /// A composer may also provide both of the following methods to receive base64 string values as decoded bytes.
+    /// `isBase64` is called before each string value, and if it returns true, the string must be valid base64
+    ///     bool isBase64(State & state);
+    ///     void val(std::span<const std::byte> val, State & state);
+    ///
     template <typename State = nullptr_t>
     class DummyComposer
     {
@@ -139,20 +298,341 @@ namespace qc::json
         return d1;
     }
 
+    #ifdef QC_JSON_DECODE_SSSE3
+    // Decodes 16 characters from `src` into 12 bytes at `dst`, writing 16 bytes. Returns false without writing if any of
+    // the characters are not base64, including padding. See "Base64 decoding with SIMD instructions" by Wojciech Muła
+    inline bool _decodeBase64Block(const char * const src, std::byte * const dst) noexcept
+    {
+        __m128i in{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src))};
+
+        // Validate by nibble lookup. A character is valid only if its low and high nibble classes share no bits
+        const __m128i hiNibbles{_mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F))};
+        const __m128i loNibbles{_mm_and_si128(in, _mm_set1_epi8(0x0F))};
+        const __m128i lo{_mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), loNibbles)};
+        const __m128i hi{_mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hiNibbles)};
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())))
+        {
+            return false;
+        }
+
+        // Translate characters to their six bit values. `/` is the only character that differs from its neighbors
+        const __m128i isSlash{_mm_cmpeq_epi8(in, _mm_set1_epi8('/'))};
+        in = _mm_add_epi8(in, _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), _mm_add_epi8(isSlash, hiNibbles)));
+
+        // Pack each four six bit values into three bytes
+        const __m128i pairs{_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140))};
+        const __m128i quads{_mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000))};
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+
+        return true;
+    }
+    #endif
+
+    // Padding is optional. Returns false if the string is not valid base64
+    inline bool _decodeBase64(string_view in, std::vector<std::byte> & out)
+    {
+        static constexpr std::array<uint8_t, 256u> values{[]() {
+            std::array<uint8_t, 256u> arr{};
+            arr.fill(0xFFu);
+            constexpr string_view chars{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+            for (size_t i{0u}; i < chars.size(); ++i) arr[uchar(chars[i])] = uint8_t(i);
+            return arr;
+        }()};
+
+        if (in.size() % 4u == 0u && !in.empty() && in.back() == '=')
+        {
+            in.remove_suffix(in[in.size() - 2u] == '=' ? 2u : 1u);
+        }
+        if (in.size() % 4u == 1u)
+        {
+            return false;
+        }
+
+        const size_t size{in.size() / 4u * 3u + (in.size() % 4u ? in.size() % 4u - 1u : 0u)};
+        // Extra room for the final vectorized block to overwrite
+        out.resize(size + 4u);
+
+        const char * src{in.data()};
+        const char * const end{src + in.size()};
+        std::byte * dst{out.data()};
+
+        #ifdef QC_JSON_DECODE_SSSE3
+        for (; end - src >= 16 && _decodeBase64Block(src, dst); src += 16, dst += 12);
+        #endif
+
+        for (; end - src >= 4; src += 4, dst += 3)
+        {
+            const uint32_t a{values[uchar(src[0])]}, b{values[uchar(src[1])]}, c{values[uchar(src[2])]}, d{values[uchar(src[3])]};
+            if ((a | b | c | d) & 0x80u)
+            {
+                return false;
+            }
+            const uint32_t v{a << 18 | b << 12 | c << 6 | d};
+            dst[0] = std::byte(v >> 16);
+            dst[1] = std::byte(v >> 8);
+            dst[2] = std::byte(v);
+        }
+
+        if (end - src >= 2)
+        {
+            const uint32_t a{values[uchar(src[0])]}, b{values[uchar(src[1])]}, c{end - src == 3 ? values[uchar(src[2])] : 0u};
+            if ((a | b | c) & 0x80u)
+            {
+                return false;
+            }
+            const uint32_t v{a << 18 | b << 12 | c << 6};
+            dst[0] = std::byte(v >> 16);
+            if (end - src == 3) dst[1] = std::byte(v >> 8);
+        }
+
+        out.resize(size);
+        return true;
+    }
+
+    template <typename Composer, typename State> concept _ComposerHasBase64Methods = requires (Composer composer, const std::span<const std::byte> val, State state) { { composer.isBase64(state) } -> std::convertible_to<bool>; composer.val(val, state); };
+    template <typename Composer, typename State> concept _ComposerHasStringChunkMethods = requires (Composer composer, const string_view chunk, State state) { composer.stringBegin(state); composer.stringChunk(chunk, state); composer.stringEnd(state); };
+
+    // Lets the decoder run over input that is still being filled in, such as by `decodeFile` in `qc-json-file.hpp`
+    class _InputSource
+    {
+        public: //--------------------------------------------------------------
+
+        // Blocks until the input at and somewhat beyond `pos` is ready, then returns the limit up to which whitespace may
+        // be skipped before asking again. Once all the input has been filled in, sets `complete` and returns its true
+        // end, which may be before the end the decoder was given. The decoder holds nothing before `pos` across this
+        // call, so the source may release that input
+        virtual const char * await(const char * pos, bool & complete) = 0;
+
+        protected: //-----------------------------------------------------------
+
+        ~_InputSource() noexcept = default;
+    };
+
+    // Room an `_InputSource` leaves for the decoder to look past the limit, e.g. when matching `Infinity`
+    inline constexpr size_t _readAheadLookahead{16u};
+
+    // Tracks strings and comments through input as it arrives to find the last structural character, which is the limit
+    // an `_InputSource` may give the decoder
+    class _ReadAheadLexer
+    {
+        public: //--------------------------------------------------------------
+
+        // Lexes onward up to `end`, returning one past the last structural character so far, or zero if there is none
+        size_t lexTo(const char * data, size_t end) noexcept;
+
+        private: //-------------------------------------------------------------
+
+        enum class _Lex : uint8_t
+        {
+            normal,
+            string,
+            escape,
+            slash,
+            lineComment,
+            blockComment,
+            blockCommentStar
+        };
+
+        _Lex _lex{_Lex::normal};
+        char _quote{'"'};
+        size_t _lexed{0u};
+        size_t _limit{0u};
+    };
+
+    inline size_t _ReadAheadLexer::lexTo(const char * const data, const size_t end) noexcept
+    {
+        size_t i{_lexed};
+        // The closing quote of the current string, once found
+        const char * quoteAt{nullptr};
+
+        while (i < end)
+        {
+            const char c{data[i]};
+
+            switch (_lex)
+            {
+                case _Lex::normal:
+                {
+                    // Only the last structural character before the next string or comment matters, so skip ahead to
+                    // that and look back
+                    const char * const next{std::find_if(data + i, data + end, [](const char ch) { return ch == '"' || ch == '\'' || ch == '/'; })};
+                    for (const char * pos{next}; pos > data + i; --pos)
+                    {
+                        const char ch{pos[-1]};
+                        if (ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ',' || ch == ':')
+                        {
+                            _limit = size_t(pos - data);
+                            break;
+                        }
+                    }
+                    i = size_t(next - data);
+                    if (i < end)
+                    {
+                        if (*next == '/')
+                        {
+                            _lex = _Lex::slash;
+                        }
+                        else
+                        {
+                            _lex = _Lex::string;
+                            _quote = *next;
+                            quoteAt = nullptr;
+                        }
+                        ++i;
+                    }
+                    break;
+                }
+                case _Lex::string:
+                {
+                    // Find the closing quote, then only look for escapes before it. The quote found may turn out to be
+                    // escaped, in which case it is searched for again
+                    if (!quoteAt || quoteAt < data + i)
+                    {
+                        quoteAt = static_cast<const char *>(std::memchr(data + i, _quote, end - i));
+                        if (!quoteAt) quoteAt = data + end;
+                    }
+                    const char * next{static_cast<const char *>(std::memchr(data + i, '\\', size_t(quoteAt - (data + i))))};
+                    if (!next) next = quoteAt;
+                    i = size_t(next - data);
+                    if (i < end)
+                    {
+                        _lex = next == quoteAt ? _Lex::normal : _Lex::escape;
+                        ++i;
+                    }
+                    break;
+                }
+                case _Lex::escape:
+                {
+                    _lex = _Lex::string;
+                    ++i;
+                    break;
+                }
+                case _Lex::slash:
+                {
+                    // Not consumed, as a lone `/` is invalid anyway and should not hide what follows
+                    _lex = c == '/' ? _Lex::lineComment : c == '*' ? _Lex::blockComment : _Lex::normal;
+                    if (_lex != _Lex::normal) ++i;
+                    break;
+                }
+                case _Lex::lineComment:
+                {
+                    const char * const next{std::find(data + i, data + end, '\n')};
+                    i = size_t(next - data);
+                    if (i < end)
+                    {
+                        _lex = _Lex::normal;
+                        ++i;
+                    }
+                    break;
+                }
+                case _Lex::blockComment:
+                {
+                    if (c == '*') _lex = _Lex::blockCommentStar;
+                    ++i;
+                    break;
+                }
+                case _Lex::blockCommentStar:
+                {
+                    _lex = c == '/' ? _Lex::normal : c == '*' ? _Lex::blockCommentStar : _Lex::blockComment;
+                    ++i;
+                    break;
+                }
+            }
+        }
+
+        _lexed = i;
+        return _limit;
+    }
+
     // This functionality is wrapped in a class purely as a convenient way to keep track of state
-    template <typename Composer, typename State>
+    // `readAhead` adds the checks for input still being filled in by an `_InputSource`, at no cost to other decoding
+    template <typename Composer, typename State, bool readAhead = false>
     class _Decoder
     {
         public: //--------------------------------------------------------------
 
-        _Decoder(const string_view str, Composer & composer) :
+        _Decoder(const string_view str, Composer & composer, _InputSource * const source = nullptr) :
             _start{str.data()},
             _end{_start + str.length()},
             _pos{_start},
-            _composer{composer}
+            _composer{composer},
+            _source{source},
+            _ready{source ? _start : _end}
         {}
 
-        void operator()(State & initialState)
+        DecodeResult operator()(State & initialState)
+        {
+            #ifdef QC_JSON_TRACE
+            const std::chrono::steady_clock::time_point traceStart{std::chrono::steady_clock::now()};
+            #endif
+
+            #ifdef QC_JSON_NO_EXCEPTIONS
+            _decode(initialState);
+            #ifdef QC_JSON_TRACE
+            _traceEnd(traceStart, _failed());
+            #endif
+            #else
+            try
+            {
+                _decode(initialState);
+            }
+            catch (ComposeError & e)
+            {
+                // The composer doesn't know where we are, so fill that in for it
+                e.position = size_t(_pos - _start);
+                #ifdef QC_JSON_TRACE
+                _traceEnd(traceStart, true);
+                #endif
+                throw;
+            }
+            #ifdef QC_JSON_TRACE
+            catch (...)
+            {
+                _traceEnd(traceStart, true);
+                throw;
+            }
+
+            _traceEnd(traceStart, false);
+            #endif
+            #endif
+
+            return std::move(_result);
+        }
+
+        private: //-------------------------------------------------------------
+
+        const char * const _start{nullptr};
+        const char * _end{nullptr}; // Only moves when an `_InputSource` finds its input ends sooner
+        const char * _pos{nullptr};
+        size_t _line{0u};
+        size_t _column{0u};
+        Composer & _composer;
+        _InputSource * _source{nullptr};
+        const char * _ready{nullptr};
+        string _stringBuffer{};
+        std::vector<std::byte> _byteBuffer{};
+        DecodeResult _result{};
+        #ifdef QC_JSON_TRACE
+        size_t _traceNodes{0u};
+        size_t _traceDepth{0u};
+        size_t _traceMaxDepth{0u};
+
+        void _traceEnd(const std::chrono::steady_clock::time_point start, const bool failed) noexcept
+        {
+            const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() - start};
+            _trace(TraceInfo{TraceOperation::saxDecode, size_t(_pos - _start), _traceNodes, _traceMaxDepth, elapsed, failed});
+        }
+
+        void _traceEnter() noexcept
+        {
+            if (++_traceDepth > _traceMaxDepth)
+            {
+                _traceMaxDepth = _traceDepth;
+            }
+        }
+        #endif
+
+        void _decode(State & initialState)
         {
             _skipSpaceAndIngestComments(initialState);
             _ingestValue(initialState);
@@ -166,22 +646,56 @@ namespace qc::json
 
             if (_pos != _end)
             {
-                throw DecodeError{"Extraneous content"sv, size_t(_pos - _start)};
+                _fail("Extraneous content"sv, size_t(_pos - _start));
             }
         }
 
-        private: //-------------------------------------------------------------
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        // Records the first error and skips to the end of the input so that decoding unwinds without further work
+        void _fail(const string_view msg, const size_t position)
+        {
+            if (_result.success)
+            {
+                _result.success = false;
+                _result.message = msg;
+                _result.position = position;
+            }
+            _pos = _end;
+            // The end may yet move if input is still arriving, so stop waiting on it
+            if constexpr (readAhead)
+            {
+                _source = nullptr;
+            }
+        }
 
-        const char * const _start{nullptr};
-        const char * const _end{nullptr};
-        const char * _pos{nullptr};
-        size_t _line{0u};
-        size_t _column{0u};
-        Composer & _composer;
-        string _stringBuffer{};
+        bool _failed() const
+        {
+            return !_result.success;
+        }
+        #else
+        [[noreturn]] void _fail(const string_view msg, const size_t position)
+        {
+            throw DecodeError{msg, position};
+        }
+
+        // Errors are thrown, so if we're still going, nothing has failed
+        constexpr bool _failed() const
+        {
+            return false;
+        }
+        #endif
 
         Density _skipWhitespace()
         {
+            // Every token is preceded by a call to this, so this is the one place input still being read is waited on
+            if constexpr (readAhead)
+            {
+                if (_pos >= _ready && _source)
+                {
+                    _awaitInput();
+                }
+            }
+
             Density density{Density::nospace};
 
             while (_pos < _end)
@@ -201,81 +715,103 @@ namespace qc::json
             return density;
         }
 
-        Density _ingestLineComment(bool concat, State & state)
+        void _awaitInput()
         {
-            // We already know we have `//`
-            _pos += 2;
-            const char * commentStart{_pos};
-
-            // Seek to end of line
-            while (_pos < _end && *_pos != '\n')
+            bool complete{false};
+            _ready = _source->await(_pos, complete);
+            if (complete)
             {
-                ++_pos;
-            }
-            const char * commentEnd{_pos};
-
-            // Trim space after `//`
-            if (commentStart < commentEnd && *commentStart == ' ')
-            {
-                ++commentStart;
+                _end = _ready;
+                _source = nullptr;
             }
+        }
 
-            // Trim `\r` from end
-            if (commentEnd[-1] == '\r')
-            {
-                --commentEnd;
-            }
+        // Iterates rather than recursing per line so that long runs of continued comments cannot exhaust the stack
+        Density _ingestLineComment(State & state)
+        {
+            Density density{Density::nospace};
+            bool concat{false};
 
-            // If this is a continuation, add it to the buffer
-            if (concat)
+            while (true)
             {
-                _stringBuffer.push_back('\n');
-                _stringBuffer.append(commentStart, commentEnd);
-            }
+                // We already know we have `//`
+                _pos += 2;
+                const char * commentStart{_pos};
 
-            // Check for continuation on next line
-            bool isContinuation{false};
-            Density density{Density::nospace};
+                // Seek to end of line
+                while (_pos < _end && *_pos != '\n')
+                {
+                    ++_pos;
+                }
+                const char * commentEnd{_pos};
 
-            // This comment ended with a newline (as opposed to the end of the json)
-            if (_pos < _end)
-            {
-                // Skip newline
-                ++_pos;
-                density = Density::multiline;
+                // Trim space after `//`
+                if (commentStart < commentEnd && *commentStart == ' ')
+                {
+                    ++commentStart;
+                }
 
-                // There are no additional newlines
-                if (_skipWhitespace() > Density::multiline)
+                // Trim `\r` from end
+                if (commentEnd[-1] == '\r')
                 {
-                    isContinuation = _pos + 2 < _end && _pos[0] == '/' && _pos[1] == '/';
+                    --commentEnd;
                 }
-            }
 
-            // There is more comment to come
-            if (isContinuation)
-            {
-                if (!concat)
+                // The source may release input once it has been passed, so the comment is kept before skipping ahead
+                if constexpr (readAhead)
                 {
-                    _stringBuffer.assign(commentStart, commentEnd);
+                    if (concat)
+                    {
+                        _stringBuffer.push_back('\n');
+                        _stringBuffer.append(commentStart, commentEnd);
+                    }
+                    else
+                    {
+                        _stringBuffer.assign(commentStart, commentEnd);
+                    }
+                    concat = true;
                 }
 
-                _ingestLineComment(true, state);
+                // Check for continuation on next line
+                bool isContinuation{false};
 
-                if (!concat)
+                // This comment ended with a newline (as opposed to the end of the json)
+                if (_pos < _end)
                 {
-                    _composer.comment(string_view{_stringBuffer}, state);
+                    // Skip newline
+                    ++_pos;
+                    density = Density::multiline;
+
+                    // There are no additional newlines
+                    if (_skipWhitespace() > Density::multiline)
+                    {
+                        isContinuation = _pos + 2 < _end && _pos[0] == '/' && _pos[1] == '/';
+                    }
                 }
-            }
-            // This is the end of the comment
-            else
-            {
-                if (!concat)
+
+                // If this is a continuation, add it to the buffer
+                if constexpr (readAhead)
+                {}
+                else if (concat)
                 {
-                    _composer.comment(string_view{commentStart, size_t(commentEnd - commentStart)}, state);
+                    _stringBuffer.push_back('\n');
+                    _stringBuffer.append(commentStart, commentEnd);
+                }
+                // If this is the first line and there is more comment to come, start the buffer
+                else if (isContinuation)
+                {
+                    _stringBuffer.assign(commentStart, commentEnd);
                 }
-            }
 
-            return density;
+                // This is the end of the comment
+                if (!isContinuation)
+                {
+                    _composer.comment(concat ? string_view{_stringBuffer} : string_view{commentStart, size_t(commentEnd - commentStart)}, state);
+                    return density;
+                }
+
+                concat = true;
+            }
         }
 
         void _ingestBlockComment(State & state)
@@ -312,7 +848,7 @@ namespace qc::json
             }
             else
             {
-                throw DecodeError{"Block comment is unterminated"sv, size_t(commentStart - 2 - _start)};
+                _fail("Block comment is unterminated"sv, size_t(commentStart - 2 - _start));
             }
         }
 
@@ -329,7 +865,7 @@ namespace qc::json
                     // Ingest line comment
                     if (_pos[1] == '/')
                     {
-                        density &= _ingestLineComment(false, state);
+                        density &= _ingestLineComment(state);
                         // `_ingesetLineComment` skips trailing whitespace already
                         continue;
                     }
@@ -366,7 +902,7 @@ namespace qc::json
         {
             if (!_tryConsumeChar(c))
             {
-                throw DecodeError{("Expected `"s += c) += '`', size_t(_pos - _start)};
+                _fail(("Expected `"s += c) += '`', size_t(_pos - _start));
             }
         }
 
@@ -394,15 +930,20 @@ namespace qc::json
         {
             if (!_tryConsumeChars(str))
             {
-                throw DecodeError{("Expected `"s += str) += '`', size_t(_pos - _start)};
+                _fail(("Expected `"s += str) += '`', size_t(_pos - _start));
             }
         }
 
         void _ingestValue(State & state)
         {
+            #ifdef QC_JSON_TRACE
+            ++_traceNodes;
+            #endif
+
             if (_pos >= _end)
             {
-                throw DecodeError{"Expected value"sv, size_t(_pos - _start)};
+                _fail("Expected value"sv, size_t(_pos - _start));
+                return;
             }
 
             char c{*_pos};
@@ -442,7 +983,8 @@ namespace qc::json
                 ++_pos;
                 if (_pos >= _end)
                 {
-                    throw DecodeError{"Expected number"sv, size_t(_pos - _start)};
+                    _fail("Expected number"sv, size_t(_pos - _start));
+                    return;
                 }
                 c = *_pos;
             }
@@ -485,12 +1027,15 @@ namespace qc::json
             }
 
             // Nothing matched, throw an error
-            throw DecodeError{"Unknown value"sv, size_t(_pos - _start)};
+            _fail("Unknown value"sv, size_t(_pos - _start));
         }
 
         void _ingestObject(State & outerState)
         {
             State innerState{_composer.object(outerState)};
+            #ifdef QC_JSON_TRACE
+            _traceEnter();
+            #endif
 
             ++_pos; // We already know we have `{`
             Density density{_skipSpaceAndIngestComments(innerState)};
@@ -502,17 +1047,21 @@ namespace qc::json
                     // Parse key
                     if (_pos >= _end)
                     {
-                        throw DecodeError{"Expected key"sv, size_t(_pos - _start)};
+                        _fail("Expected key"sv, size_t(_pos - _start));
+                        return;
                     }
                     const char c{*_pos};
-                    const string_view key{(c == '"' || c == '\'') ? _consumeString(c) : _consumeIdentifier()};
+                    const string_view key{(c == '"' || c == '\'') ? _consumeString<false>(c, innerState) : _consumeIdentifier()};
+                    if (_failed()) return;
                     _composer.key(key, innerState);
                     density &= _skipSpaceAndIngestComments(innerState);
 
                     _consumeChar(':');
+                    if (_failed()) return;
                     density &= _skipSpaceAndIngestComments(innerState);
 
                     _ingestValue(innerState);
+                    if (_failed()) return;
                     density &= _skipSpaceAndIngestComments(innerState);
 
                     if (_tryConsumeChar('}'))
@@ -522,6 +1071,7 @@ namespace qc::json
                     else
                     {
                         _consumeChar(',');
+                        if (_failed()) return;
                         density &= _skipSpaceAndIngestComments(innerState);
 
                         // Allow trailing comma
@@ -533,12 +1083,18 @@ namespace qc::json
                 }
             }
 
+            #ifdef QC_JSON_TRACE
+            --_traceDepth;
+            #endif
             _composer.end(density, std::move(innerState), outerState);
         }
 
         void _ingestArray(State & outerState)
         {
             State innerState{_composer.array(outerState)};
+            #ifdef QC_JSON_TRACE
+            _traceEnter();
+            #endif
 
             ++_pos; // We already know we have `[`
             Density density{_skipSpaceAndIngestComments(innerState)};
@@ -548,6 +1104,7 @@ namespace qc::json
                 while (true)
                 {
                     _ingestValue(innerState);
+                    if (_failed()) return;
                     density &= _skipSpaceAndIngestComments(innerState);
 
                     if (_tryConsumeChar(']'))
@@ -557,6 +1114,7 @@ namespace qc::json
                     else
                     {
                         _consumeChar(',');
+                        if (_failed()) return;
                         density &= _skipSpaceAndIngestComments(innerState);
 
                         // Allow trailing comma
@@ -568,15 +1126,73 @@ namespace qc::json
                 }
             }
 
+            #ifdef QC_JSON_TRACE
+            --_traceDepth;
+            #endif
             _composer.end(density, std::move(innerState), outerState);
         }
 
         void _ingestString(const char quote, State & state)
         {
-            _composer.val(_consumeString(quote), state);
+            if constexpr (_ComposerHasBase64Methods<Composer, State>)
+            {
+                if (_composer.isBase64(state))
+                {
+                    _ingestBase64(quote, state);
+                    return;
+                }
+            }
+
+            if constexpr (_ComposerHasStringChunkMethods<Composer, State>)
+            {
+                _composer.stringBegin(state);
+                const string_view lastChunk{_consumeString<true>(quote, state)};
+                if (_failed()) return;
+                if (!lastChunk.empty())
+                {
+                    _composer.stringChunk(lastChunk, state);
+                }
+                _composer.stringEnd(state);
+            }
+            else
+            {
+                const string_view str{_consumeString<false>(quote, state)};
+                if (_failed()) return;
+                _composer.val(str, state);
+            }
+        }
+
+        void _ingestBase64(const char quote, State & state) requires _ComposerHasBase64Methods<Composer, State>
+        {
+            const char * const stringStart{_pos};
+
+            // Base64 needs no escapes, so in the usual case decode straight from the input. Only if there is an escape
+            // is the string first copied out
+            string_view encoded{};
+            const char * const contentEnd{std::find_if(_pos + 1, _end, [quote](const char c) { return c == quote || c == '\\'; })};
+            if (contentEnd < _end && *contentEnd == quote)
+            {
+                encoded = string_view{_pos + 1, size_t(contentEnd - _pos - 1)};
+                _pos = contentEnd + 1;
+            }
+            else
+            {
+                encoded = _consumeString<false>(quote, state);
+                if (_failed()) return;
+            }
+
+            if (!_decodeBase64(encoded, _byteBuffer))
+            {
+                _fail("Invalid base64"sv, size_t(stringStart - _start));
+                return;
+            }
+
+            _composer.val(std::span<const std::byte>{_byteBuffer}, state);
         }
 
-        string_view _consumeString(const char quote)
+        // If `chunked`, the buffer is passed to the composer whenever it fills, and only the remainder is returned
+        template <bool chunked>
+        string_view _consumeString(const char quote, [[maybe_unused]] State & state)
         {
             _stringBuffer.clear();
 
@@ -586,7 +1202,8 @@ namespace qc::json
             {
                 if (_pos >= _end)
                 {
-                    throw DecodeError{"Expected end quote"sv, size_t(_pos - _start)};
+                    _fail("Expected end quote"sv, size_t(_pos - _start));
+                    return {};
                 }
 
                 const char c{*_pos};
@@ -620,7 +1237,17 @@ namespace qc::json
                 }
                 else
                 {
-                    throw DecodeError{"Invalid string content"sv, size_t(_pos - _start)};
+                    _fail("Invalid string content"sv, size_t(_pos - _start));
+                    return {};
+                }
+
+                if constexpr (chunked)
+                {
+                    if (_stringBuffer.size() >= stringChunkSize)
+                    {
+                        _composer.stringChunk(string_view{_stringBuffer}, state);
+                        _stringBuffer.clear();
+                    }
                 }
             }
         }
@@ -629,7 +1256,8 @@ namespace qc::json
         {
             if (_pos >= _end)
             {
-                throw DecodeError{"Expected escape sequence"sv, size_t(_pos - _start)};
+                _fail("Expected escape sequence"sv, size_t(_pos - _start));
+                return '\0';
             }
 
             const char c{*_pos};
@@ -654,7 +1282,8 @@ namespace qc::json
                     }
                     else
                     {
-                        throw DecodeError{"Invalid escape sequence"sv, size_t(_pos - _start - 1)};
+                        _fail("Invalid escape sequence"sv, size_t(_pos - _start - 1));
+                        return '\0';
                     }
             }
         }
@@ -663,14 +1292,16 @@ namespace qc::json
         {
             if (_end - _pos < digits)
             {
-                throw DecodeError{("Expected "s += std::to_string(digits)) += " code point digits"sv, size_t(_pos - _start)};
+                _fail(("Expected "s += std::to_string(digits)) += " code point digits"sv, size_t(_pos - _start));
+                return '\0';
             }
 
             uint32_t val;
             const std::from_chars_result res{std::from_chars(_pos, _pos + digits, val, 16)};
             if (res.ec != std::errc{})
             {
-                throw DecodeError{"Invalid code point"sv, size_t(_pos - _start)};
+                _fail("Invalid code point"sv, size_t(_pos - _start));
+                return '\0';
             }
 
             _pos += digits;
@@ -691,7 +1322,8 @@ namespace qc::json
             }
             else
             {
-                throw DecodeError{"Expected identifier"sv, size_t(_pos - _start)};
+                _fail("Expected identifier"sv, size_t(_pos - _start));
+                return {};
             }
 
             while (true)
@@ -771,7 +1403,8 @@ namespace qc::json
                 {
                     if (sign)
                     {
-                        throw DecodeError{"Hex, octal, and binary numbers must not be signed"sv, size_t(_pos - _start)};
+                        _fail("Hex, octal, and binary numbers must not be signed"sv, size_t(_pos - _start));
+                        return;
                     }
                     _pos += 2;
                     _ingestHexOctalBinary(base, state);
@@ -805,7 +1438,8 @@ namespace qc::json
             // There was an issue parsing
             if (res.ec != std::errc{})
             {
-                throw DecodeError{base == 2 ? "Invalid binary"sv : base == 8 ? "Invalid octal"sv : "Invalid hex"sv, size_t(_pos - _start)};
+                _fail(base == 2 ? "Invalid binary"sv : base == 8 ? "Invalid octal"sv : "Invalid hex"sv, size_t(_pos - _start));
+                return;
             }
 
             _pos = res.ptr;
@@ -823,6 +1457,12 @@ namespace qc::json
             {
                 val = 0;
             }
+            // Too many digits to possibly fit, so parse as a floater without first attempting to parse as an integer
+            else if (*_pos != '0' && size_t(std::find(_pos, _pos + length, '.') - _pos) > size_t(std::numeric_limits<uint64_t>::digits10 + 1))
+            {
+                _ingestFloater(negative, state);
+                return;
+            }
             else
             {
                 const std::from_chars_result res{std::from_chars(_pos - negative, _end, val)};
@@ -839,7 +1479,8 @@ namespace qc::json
                     // Some other issue
                     else
                     {
-                        throw DecodeError{"Invalid integer"sv, size_t(_pos - _start)};
+                        _fail("Invalid integer"sv, size_t(_pos - _start));
+                        return;
                     }
                 }
             }
@@ -867,7 +1508,8 @@ namespace qc::json
             // There was an issue parsing
             if (res.ec != std::errc{})
             {
-                throw DecodeError{"Invalid floater"sv, size_t(_pos - _start)};
+                _fail("Invalid floater"sv, size_t(_pos - _start));
+                return;
             }
 
             _pos = res.ptr;
@@ -880,6 +1522,15 @@ namespace qc::json
         position{position}
     {}
 
+    inline ComposeError::ComposeError(const string_view msg) noexcept :
+        DecodeError{msg, 0u}
+    {}
+
+    inline DecodeResult::operator bool() const noexcept
+    {
+        return success;
+    }
+
     template <typename Composer, typename State> concept _ComposerHasObjectMethod = requires (Composer composer, State state) { State{composer.object(state)}; };
     template <typename Composer, typename State> concept _ComposerHasArrayMethod = requires (Composer composer, State state) { State{composer.array(state)}; };
     template <typename Composer, typename State> concept _ComposerHasEndMethod = requires (Composer composer, const Density density, State innerState, State outerState) { composer.end(density, std::move(innerState), outerState); };
@@ -892,8 +1543,8 @@ namespace qc::json
     template <typename Composer, typename State> concept _ComposerHasNullValMethod = requires (Composer composer, State state) { composer.val(nullptr, state); };
     template <typename Composer, typename State> concept _ComposerHasCommentMethod = requires (Composer composer, const string_view comment, State state) { composer.comment(comment, state); };
 
-    template <typename Composer, typename State>
-    inline void decode(string_view json, Composer & composer, State & initialState)
+    template <bool readAhead = false, typename Composer, typename State>
+    inline DecodeResult _decode(const string_view json, Composer & composer, State & initialState, _InputSource * const source = nullptr)
     {
         // Much more understandable compile errors than just letting the template code fly
         static_assert(_ComposerHasObjectMethod<Composer, State>);
@@ -908,12 +1559,48 @@ namespace qc::json
         static_assert(_ComposerHasNullValMethod<Composer, State>);
         static_assert(_ComposerHasCommentMethod<Composer, State>);
 
-        return _Decoder<Composer, State>{json, composer}(initialState);
+        return _Decoder<Composer, State, readAhead>{json, composer, source}(initialState);
+    }
+
+    template <typename Composer, typename State>
+    inline void decode(const string_view json, Composer & composer, State & initialState)
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        if (!_decode(json, composer, initialState))
+        {
+            std::abort();
+        }
+        #else
+        _decode(json, composer, initialState);
+        #endif
     }
 
     template <typename Composer, typename State>
-    inline void decode(string_view json, Composer & composer, State && initialState)
+    inline void decode(const string_view json, Composer & composer, State && initialState)
     {
         return decode(json, composer, initialState);
     }
+
+    template <typename Composer, typename State>
+    inline DecodeResult tryDecode(const string_view json, Composer & composer, State & initialState)
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        return _decode(json, composer, initialState);
+        #else
+        try
+        {
+            return _decode(json, composer, initialState);
+        }
+        catch (const DecodeError & e)
+        {
+            return DecodeResult{false, e.what(), e.position};
+        }
+        #endif
+    }
+
+    template <typename Composer, typename State>
+    inline DecodeResult tryDecode(const string_view json, Composer & composer, State && initialState)
+    {
+        return tryDecode(json, composer, initialState);
+    }
 }
@@ -15,18 +15,32 @@
 ///
 
 #include <cctype>
+#include <cmath>
 #include <cstddef>
+#include <cstdlib>
 
+#include <algorithm>
 #include <charconv>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if defined(__SSSE3__) || defined(__AVX__)
+    #include <tmmintrin.h>
+    #define QC_JSON_ENCODE_SSSE3
+#endif
+
 #ifndef QC_JSON_COMMON
 #define QC_JSON_COMMON
 
+// Defined automatically when compiling with exceptions disabled (`-fno-exceptions`, `/EHs-c-`), or may be defined manually
+#if !defined(QC_JSON_NO_EXCEPTIONS) && (defined(_MSC_VER) ? !defined(_CPPUNWIND) : !defined(__cpp_exceptions))
+    #define QC_JSON_NO_EXCEPTIONS
+#endif
+
 namespace qc::json
 {
     using std::string;
@@ -42,10 +56,22 @@ namespace qc::json
     struct Error : std::runtime_error
     {
         explicit Error(const string_view msg = {}) noexcept :
-            std::runtime_error{msg.data()}
+            std::runtime_error(string{msg})
         {}
     };
 
+    // Throws the error, or aborts if exceptions are disabled. Either way, reaching it in constant evaluation is a compile
+    // error
+    template <typename E, typename... Args>
+    [[noreturn]] constexpr void _throw([[maybe_unused]] Args &&... args)
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        std::abort();
+        #else
+        throw E{std::forward<Args>(args)...};
+        #endif
+    }
+
     ///
     /// Simple enum representing a json container type
     ///
@@ -70,6 +96,85 @@ namespace qc::json
 
 #endif // QC_JSON_COMMON
 
+#if defined(QC_JSON_TRACE) && !defined(QC_JSON_TRACE_COMMON)
+#define QC_JSON_TRACE_COMMON
+
+#include <atomic>
+#include <chrono>
+
+#if __has_include(<sys/sdt.h>)
+    #include <sys/sdt.h>
+    #define QC_JSON_USDT
+#endif
+
+namespace qc::json
+{
+    ///
+    /// The operations reported when `QC_JSON_TRACE` is defined
+    ///
+    enum class TraceOperation : int8_t
+    {
+        saxDecode, /// Any `decode` with a composer, including those used by the others
+        domDecode, /// `decode(string_view)`, including building the DOM
+        saxEncode, /// `Encoder::finish`, covering everything since the first element of the JSON
+        domEncode  /// `encode(const Value &)`
+    };
+
+    ///
+    /// Details of a traced operation
+    ///
+    struct TraceInfo
+    {
+        TraceOperation operation;
+        size_t bytes; /// The number of bytes decoded or encoded. For a failed decode, the position of the failure
+        size_t nodes; /// The number of values, including objects and arrays
+        size_t depth; /// The maximum depth of nested objects and arrays
+        std::chrono::nanoseconds elapsed;
+        bool failed;
+    };
+
+    ///
+    /// Called upon completion of every traced operation, on the thread that did it. Must not throw
+    ///
+    using TraceHook = void (*)(const TraceInfo & info);
+
+    inline std::atomic<TraceHook> _traceHook{nullptr};
+
+    // The most recent trace on this thread, so that the DOM operations can report what the SAX operations counted
+    inline thread_local TraceInfo _lastTrace{};
+
+    ///
+    /// Sets the function to call upon completion of each traced operation. Pass `nullptr` to stop
+    ///
+    inline void setTraceHook(const TraceHook hook) noexcept
+    {
+        _traceHook.store(hook, std::memory_order_relaxed);
+    }
+
+    inline void _trace(const TraceInfo & info) noexcept
+    {
+        _lastTrace = info;
+
+        #ifdef QC_JSON_USDT
+        const long long elapsed{info.elapsed.count()};
+        switch (info.operation)
+        {
+            case TraceOperation::saxDecode: DTRACE_PROBE5(qc_json, sax_decode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+            case TraceOperation::domDecode: DTRACE_PROBE5(qc_json, dom_decode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+            case TraceOperation::saxEncode: DTRACE_PROBE5(qc_json, sax_encode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+            case TraceOperation::domEncode: DTRACE_PROBE5(qc_json, dom_encode, info.bytes, info.nodes, info.depth, elapsed, info.failed); break;
+        }
+        #endif
+
+        if (const TraceHook hook{_traceHook.load(std::memory_order_relaxed)})
+        {
+            hook(info);
+        }
+    }
+}
+
+#endif // QC_JSON_TRACE_COMMON
+
 namespace qc::json
 {
     ///
@@ -92,8 +197,32 @@ namespace qc::json
     struct _OctalToken { uint64_t val{}; };
     struct _HexToken { uint64_t val{}; };
 
+    struct _Base64Token { std::span<const std::byte> bytes{}; };
+
     struct _CommentToken { string_view comment{}; };
 
+    ///
+    /// Extend this to receive the encoded JSON incrementally rather than all at once from `Encoder::finish`
+    ///
+    class Sink
+    {
+        public: //--------------------------------------------------------------
+
+        virtual ~Sink() noexcept = default;
+
+        ///
+        /// Called with each successive chunk of encoded JSON
+        ///
+        /// @param chunk the next chunk. *Note: this view becomes invalid upon return*
+        ///
+        virtual void write(string_view chunk) = 0;
+
+        ///
+        /// Called by `Encoder::finish` once the last chunk has been written
+        ///
+        virtual void finish() {}
+    };
+
     ///
     /// Namespace provided to allow the user to `using namespace qc::json::tokens` to avoid the verbosity of fully
     /// qualifying the tokens namespace
@@ -103,29 +232,34 @@ namespace qc::json
         ///
         /// Stream this `object` variable to start a new object. Optionally specify a density
         ///
-        constexpr _ObjectToken object{};
+        inline constexpr _ObjectToken object{};
 
         ///
         /// Stream this `array` variable to start a new array. Optionally specify a density
         ///
-        constexpr _ArrayToken array{};
+        inline constexpr _ArrayToken array{};
 
         ///
         /// Stream this to end the current object or array
         ///
-        constexpr _EndToken end{};
+        inline constexpr _EndToken end{};
 
         ///
         /// Stream ` << binary(val) `, ` << octal(val) `, or ` << hex(val) ` to encode an unsigned integer in that base
         ///
-        constexpr struct { constexpr _BinaryToken operator()(uint64_t v) const noexcept { return _BinaryToken{v}; } } binary{};
-        constexpr struct { constexpr  _OctalToken operator()(uint64_t v) const noexcept { return  _OctalToken{v}; } }  octal{};
-        constexpr struct { constexpr    _HexToken operator()(uint64_t v) const noexcept { return    _HexToken{v}; } }    hex{};
+        inline constexpr struct { constexpr _BinaryToken operator()(uint64_t v) const noexcept { return _BinaryToken{v}; } } binary{};
+        inline constexpr struct { constexpr  _OctalToken operator()(uint64_t v) const noexcept { return  _OctalToken{v}; } }  octal{};
+        inline constexpr struct { constexpr    _HexToken operator()(uint64_t v) const noexcept { return    _HexToken{v}; } }    hex{};
+
+        ///
+        /// Stream ` << base64(bytes) ` to encode binary data as a base64 string
+        ///
+        inline constexpr struct { constexpr _Base64Token operator()(std::span<const std::byte> v) const noexcept { return _Base64Token{v}; } } base64{};
 
         ///
         /// Stream ` << comment(str) ` to encode a comment
         ///
-        constexpr struct { constexpr _CommentToken operator()(string_view str) const noexcept { return _CommentToken{str}; } } comment{};
+        inline constexpr struct { constexpr _CommentToken operator()(string_view str) const noexcept { return _CommentToken{str}; } } comment{};
     }
 
     ///
@@ -142,8 +276,12 @@ namespace qc::json
         /// @param indentSpaces the number of spaces to insert per level of indentation
         /// @param singleQuotes whether to use `'` instead of `"` for strings
         /// @param identifiers whether to encode all eligible keys as identifiers instead of strings
+        /// @param canonical whether to produce canonical JSON, in which case all other options are ignored. See the
+        ///     README for details
+        /// @param strict whether to produce strict JSON rather than JSON5, in which case strings use `"` and JSON's
+        ///     escapes, identifiers and comments are disabled, numbers are decimal, and infinity and NaN are an error
         ///
-        Encoder(Density density = Density::unspecified, size_t indentSpaces = 4u, bool singleQuotes = false, bool identifiers = false);
+        Encoder(Density density = Density::unspecified, size_t indentSpaces = 4u, bool singleQuotes = false, bool identifiers = false, bool canonical = false, bool strict = false);
 
         Encoder(const Encoder &) = delete;
 
@@ -202,6 +340,14 @@ namespace qc::json
         Encoder & operator<<(_OctalToken v);
         Encoder & operator<<(_HexToken v);
 
+        ///
+        /// Encode binary data as a standard, padded base64 string. The base64 is written directly into the output
+        ///
+        /// @param v the bytes to encode
+        /// @return this
+        ///
+        Encoder & operator<<(_Base64Token v);
+
         ///
         /// Insert a comment. Comments always logically precede a value. Comments will be in line form (`// ...`) in
         /// multiline contexts, block form (`/* ... */`) in uniline contexts, and nospace block form (`/*...*/`) in
@@ -243,14 +389,71 @@ namespace qc::json
         Encoder & operator<<(bool v);
         Encoder & operator<<(std::nullptr_t);
 
+        ///
+        /// Start a string value whose content is provided incrementally by `appendString`, such that the whole string
+        /// never needs to be in memory. Keys cannot be written this way
+        ///
+        /// Nothing else may be encoded until the string is ended by `endString`
+        ///
+        /// @return this
+        ///
+        Encoder & beginString();
+
+        ///
+        /// Escape and append more content to the open string. If a sink is set, output is flushed as it goes, even
+        /// within a single call
+        ///
+        /// @param v the content to append
+        /// @return this
+        ///
+        Encoder & appendString(string_view v);
+
+        ///
+        /// End the open string
+        ///
+        /// @return this
+        ///
+        Encoder & endString();
+
         ///
         /// Collapses the internal string stream into the encoded JSON string. This function resets the internal state
         /// of the encoder to a "clean slate" such that it can be safely reused
         ///
+        /// If a sink is set, any remaining JSON is written to it and an empty string is returned instead
+        ///
         /// @return the encoded JSON string
+        /// @throw `EncodeError` if the JSON is incomplete
         ///
         string finish();
 
+        ///
+        /// Discards any partially encoded JSON and error, returning the encoder to a "clean slate"
+        ///
+        void reset() noexcept;
+
+        ///
+        /// When exceptions are disabled, misuse of the encoder is recorded rather than thrown. The error is sticky, and
+        /// all subsequent operations, including `finish`, do nothing until `reset` is called. With exceptions enabled,
+        /// this is always false
+        ///
+        /// @return whether the encoder has failed
+        ///
+        bool failed() const noexcept;
+
+        ///
+        /// @return the message of the error that caused the encoder to fail, or empty if it has not failed
+        ///
+        string_view error() const noexcept;
+
+        ///
+        /// Directs all subsequent output to the given sink. Output is buffered and written to the sink in chunks of
+        /// roughly `bufferSize` bytes
+        ///
+        /// @param sink the sink to write to, or `nullptr` to go back to accumulating the full string
+        /// @param bufferSize the number of bytes to buffer before writing to the sink
+        ///
+        void setSink(Sink * sink, size_t bufferSize = 4096u) noexcept;
+
         ///
         /// @return the current container
         ///
@@ -261,6 +464,11 @@ namespace qc::json
         ///
         Density density() const noexcept;
 
+        ///
+        /// @return whether canonical JSON is being produced
+        ///
+        bool canonical() const noexcept;
+
         private: //-------------------------------------------------------------
 
         enum class _Element { none, key, val, start, comment };
@@ -276,15 +484,43 @@ namespace qc::json
         size_t _indentSpaces;
         char _quote;
         bool _useIdentifiers;
+        bool _canonical;
+        bool _strict; // Also set when canonical
 
         std::string _str{};
+        Sink * _sink{nullptr};
+        size_t _sinkBufferSize{0u};
         std::vector<_ScopeDelta> _scopeDeltas{};
+        std::vector<string> _canonicalKeys{};
         Container _container{Container::none};
         Density _density{_baseDensity};
         size_t _indentation{0u};
         _Element _prevElement{_Element::none};
         bool _isContent{false};
         bool _isKey{false};
+        bool _isString{false};
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        string _error{};
+        #endif
+        #ifdef QC_JSON_TRACE
+        struct
+        {
+            size_t nodes{0u};
+            size_t depth{0u};
+            size_t flushedBytes{0u};
+            std::chrono::steady_clock::time_point start{};
+        } _traceStats{};
+        #endif
+
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        void _fail(string_view msg);
+        #else
+        [[noreturn]] void _fail(string_view msg);
+        #endif
+
+        bool _failed() const noexcept;
+
+        bool _checkNoOpenString();
 
         void _start(Container container, Density density);
 
@@ -298,13 +534,19 @@ namespace qc::json
 
         void _putSpace();
 
+        void _tryFlush();
+
         void _encode(string_view val);
+        void _encodeContent(string_view val);
+        void _encodeStrictContent(string_view val);
         void _encode(int64_t val);
         void _encode(uint64_t val);
         void _encode(_BinaryToken v);
         void _encode(_OctalToken v);
         void _encode(_HexToken v);
+        void _encode(_Base64Token v);
         void _encode(double val);
+        void _encodeCanonical(double val);
         void _encode(bool val);
         void _encode(std::nullptr_t);
     };
@@ -328,11 +570,104 @@ namespace qc::json
         Error{msg}
     {}
 
-    inline Encoder::Encoder(const Density density, const size_t indentSpaces, bool singleQuotes, bool preferIdentifiers) :
-        _baseDensity{density},
-        _indentSpaces{indentSpaces},
-        _quote{singleQuotes ? '\'' : '"'},
-        _useIdentifiers{preferIdentifiers}
+    // The largest magnitude below which every integer is exactly a double
+    inline constexpr int64_t _maxExactInteger{int64_t{1} << 53};
+
+    // Orders UTF-8 keys by their UTF-16 code units, as RFC 8785 requires. This is the same as byte order, except that
+    // code points U+E000 to U+FFFF, led by 0xEE or 0xEF, come after the surrogate pairs of those above U+FFFF
+    inline bool _canonicalKeyLess(const string_view a, const string_view b) noexcept
+    {
+        const auto [aIt, bIt]{std::mismatch(a.begin(), a.end(), b.begin(), b.end())};
+        if (bIt == b.end())
+        {
+            return false;
+        }
+        if (aIt == a.end())
+        {
+            return true;
+        }
+
+        const uchar aC{uchar(*aIt)};
+        const uchar bC{uchar(*bIt)};
+        if (aC >= 0xEEu && bC >= 0xEEu && (aC >= 0xF0u) != (bC >= 0xF0u))
+        {
+            return aC >= 0xF0u;
+        }
+        return aC < bC;
+    }
+
+    #ifdef QC_JSON_ENCODE_SSSE3
+    // Encodes 12 bytes from `src` into 16 characters at `dst`, reading 16 bytes. See "Base64 encoding with SIMD
+    // instructions" by Wojciech Muła
+    inline void _encodeBase64Block(const std::byte * const src, char * const dst) noexcept
+    {
+        __m128i in{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src))};
+
+        // Spread each three bytes across four, then shift each six bits into its own byte
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0{_mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040))};
+        const __m128i t1{_mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010))};
+        const __m128i indices{_mm_or_si128(t0, t1)};
+
+        // Map each range of indices to the offset of its range of characters
+        __m128i ranges{_mm_subs_epu8(indices, _mm_set1_epi8(51))};
+        ranges = _mm_or_si128(ranges, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        const __m128i offsets{_mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), ranges)};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_add_epi8(indices, offsets));
+    }
+    #endif
+
+    // Writes exactly `(bytes.size() + 2) / 3 * 4` characters to `dst`
+    inline void _encodeBase64(const std::span<const std::byte> bytes, char * dst) noexcept
+    {
+        static constexpr char chars[65u]{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+        const std::byte * src{bytes.data()};
+        const std::byte * const end{src + bytes.size()};
+
+        #ifdef QC_JSON_ENCODE_SSSE3
+        // Each block reads 16 bytes but only consumes 12
+        for (; end - src >= 16; src += 12, dst += 16)
+        {
+            _encodeBase64Block(src, dst);
+        }
+        #endif
+
+        for (; end - src >= 3; src += 3, dst += 4)
+        {
+            const uint32_t v{uint32_t(src[0]) << 16 | uint32_t(src[1]) << 8 | uint32_t(src[2])};
+            dst[0] = chars[v >> 18];
+            dst[1] = chars[(v >> 12) & 0x3Fu];
+            dst[2] = chars[(v >> 6) & 0x3Fu];
+            dst[3] = chars[v & 0x3Fu];
+        }
+
+        if (end - src == 2)
+        {
+            const uint32_t v{uint32_t(src[0]) << 16 | uint32_t(src[1]) << 8};
+            dst[0] = chars[v >> 18];
+            dst[1] = chars[(v >> 12) & 0x3Fu];
+            dst[2] = chars[(v >> 6) & 0x3Fu];
+            dst[3] = '=';
+        }
+        else if (end - src == 1)
+        {
+            const uint32_t v{uint32_t(src[0]) << 16};
+            dst[0] = chars[v >> 18];
+            dst[1] = chars[(v >> 12) & 0x3Fu];
+            dst[2] = '=';
+            dst[3] = '=';
+        }
+    }
+
+    inline Encoder::Encoder(const Density density, const size_t indentSpaces, bool singleQuotes, bool preferIdentifiers, bool canonical, bool strict) :
+        _baseDensity{canonical ? Density::nospace : density},
+        _indentSpaces{canonical ? 0u : indentSpaces},
+        _quote{singleQuotes && !canonical && !strict ? '\'' : '"'},
+        _useIdentifiers{preferIdentifiers && !canonical && !strict},
+        _canonical{canonical},
+        _strict{canonical || strict}
     {}
 
     inline Encoder::Encoder(Encoder && other) noexcept :
@@ -340,14 +675,26 @@ namespace qc::json
         _indentSpaces{other._indentSpaces},
         _quote{other._quote},
         _useIdentifiers{other._useIdentifiers},
+        _canonical{other._canonical},
+        _strict{other._strict},
         _str{std::move(other._str)},
+        _sink{std::exchange(other._sink, nullptr)},
+        _sinkBufferSize{other._sinkBufferSize},
         _scopeDeltas{std::move(other._scopeDeltas)},
+        _canonicalKeys{std::move(other._canonicalKeys)},
         _container{std::exchange(other._container, Container::none)},
         _density{std::exchange(other._density, other._baseDensity)},
         _indentation{std::exchange(other._indentation, 0u)},
         _prevElement{std::exchange(other._prevElement, _Element::none)},
         _isContent{std::exchange(other._isContent, false)},
-        _isKey{std::exchange(other._isKey, false)}
+        _isKey{std::exchange(other._isKey, false)},
+        _isString{std::exchange(other._isString, false)}
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        , _error{std::move(other._error)}
+        #endif
+        #ifdef QC_JSON_TRACE
+        , _traceStats{std::exchange(other._traceStats, {})}
+        #endif
     {}
 
     inline Encoder & Encoder::operator=(Encoder && other) noexcept
@@ -356,14 +703,26 @@ namespace qc::json
         _indentSpaces = other._indentSpaces;
         _quote = other._quote;
         _useIdentifiers = other._useIdentifiers;
+        _canonical = other._canonical;
+        _strict = other._strict;
         _str = std::move(other._str);
+        _sink = std::exchange(other._sink, nullptr);
+        _sinkBufferSize = other._sinkBufferSize;
         _scopeDeltas = std::move(other._scopeDeltas);
+        _canonicalKeys = std::move(other._canonicalKeys);
         _container = std::exchange(other._container, Container::none);
         _density = std::exchange(other._density, other._baseDensity);
         _indentation = std::exchange(other._indentation, 0u);
         _prevElement = std::exchange(other._prevElement, _Element::none);
         _isContent = std::exchange(other._isContent, false);
         _isKey = std::exchange(other._isKey, false);
+        _isString = std::exchange(other._isString, false);
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        _error = std::move(other._error);
+        #endif
+        #ifdef QC_JSON_TRACE
+        _traceStats = std::exchange(other._traceStats, {});
+        #endif
 
         return *this;
     }
@@ -382,13 +741,19 @@ namespace qc::json
 
     inline Encoder & Encoder::operator<<(const _EndToken)
     {
+        if (_failed() || !_checkNoOpenString())
+        {
+            return *this;
+        }
         if (_container == Container::none)
         {
-            throw EncodeError{"No object or array to end"sv};
+            _fail("No object or array to end"sv);
+            return *this;
         }
         if (_isKey)
         {
-            throw EncodeError{"Cannot end object with a dangling key"sv};
+            _fail("Cannot end object with a dangling key"sv);
+            return *this;
         }
 
         _indentation -= _indentSpaces;
@@ -397,12 +762,18 @@ namespace qc::json
             _putSpace();
         }
         _str += (_container == Container::object ? '}' : ']');
+        if (_canonical && _container == Container::object)
+        {
+            _canonicalKeys.pop_back();
+        }
         _container = Container(int8_t(_container) - _scopeDeltas.back().containerDelta);
         _density = Density(int8_t(_density) - _scopeDeltas.back().densityDelta);
         _scopeDeltas.pop_back();
         _prevElement = _Element::val;
         _isContent = true;
 
+        _tryFlush();
+
         return *this;
     }
 
@@ -424,8 +795,20 @@ namespace qc::json
         return *this;
     }
 
+    inline Encoder & Encoder::operator<<(const _Base64Token v)
+    {
+        _val(v);
+        return *this;
+    }
+
     inline Encoder & Encoder::operator<<(const _CommentToken v)
     {
+        // Strict JSON has no comments
+        if (_strict || _failed() || !_checkNoOpenString())
+        {
+            return *this;
+        }
+
         Density commentDensity{_density};
 
         // Comment between key and value must be dense
@@ -452,7 +835,8 @@ namespace qc::json
                 }
                 else
                 {
-                    throw EncodeError{("Comment has invalid character `\\x"s += std::to_string(int(uchar(c)))) += '`'};
+                    _fail(("Comment has invalid character `\\x"s += std::to_string(int(uchar(c)))) += '`');
+                    return *this;
                 }
             }
         }
@@ -479,7 +863,8 @@ namespace qc::json
             // Ensure block comment does not contain `*/`
             if (v.comment.find("*/"sv) != string_view::npos)
             {
-                throw EncodeError{"Block comment must not contain `*/`"sv};
+                _fail("Block comment must not contain `*/`"sv);
+                return *this;
             }
 
             if (commentDensity == Density::uniline)
@@ -496,6 +881,8 @@ namespace qc::json
             }
         }
 
+        _tryFlush();
+
         return *this;
     }
 
@@ -598,14 +985,110 @@ namespace qc::json
         return *this;
     }
 
+    inline Encoder & Encoder::beginString()
+    {
+        if (_failed() || !_checkNoOpenString())
+        {
+            return *this;
+        }
+        if (_container == Container::none && _isContent)
+        {
+            _fail("Cannot add to complete JSON"sv);
+            return *this;
+        }
+        if (_container == Container::object && !_isKey)
+        {
+            _fail("Cannot add to object without first providing a key"sv);
+            return *this;
+        }
+
+        _prefix();
+        _str += _quote;
+        _isString = true;
+
+        return *this;
+    }
+
+    inline Encoder & Encoder::appendString(string_view v)
+    {
+        if (_failed())
+        {
+            return *this;
+        }
+        if (!_isString)
+        {
+            _fail("No string to append to"sv);
+            return *this;
+        }
+
+        // Escape in pieces so that output to a sink stays bounded even if `v` is huge
+        const size_t pieceSize{_sink && _sinkBufferSize ? _sinkBufferSize : v.size()};
+        do
+        {
+            const string_view piece{v.substr(0u, pieceSize)};
+            _encodeContent(piece);
+            _tryFlush();
+            v.remove_prefix(piece.size());
+        } while (!v.empty());
+
+        return *this;
+    }
+
+    inline Encoder & Encoder::endString()
+    {
+        if (_failed())
+        {
+            return *this;
+        }
+        if (!_isString)
+        {
+            _fail("No string to end"sv);
+            return *this;
+        }
+
+        _str += _quote;
+        #ifdef QC_JSON_TRACE
+        ++_traceStats.nodes;
+        #endif
+
+        _isString = false;
+        _prevElement = _Element::val;
+        _isContent = true;
+        _isKey = false;
+
+        _tryFlush();
+
+        return *this;
+    }
+
     inline string Encoder::finish()
     {
+        if (_failed() || !_checkNoOpenString())
+        {
+            return {};
+        }
         if (_container != Container::none || !_isContent)
         {
-            throw EncodeError{"Cannot finish, JSON is not yet complete"sv};
+            _fail("Cannot finish, JSON is not yet complete"sv);
+            return {};
         }
 
-        const string str{std::move(_str)};
+        #ifdef QC_JSON_TRACE
+        const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() - _traceStats.start};
+        _trace(TraceInfo{TraceOperation::saxEncode, _traceStats.flushedBytes + _str.size(), _traceStats.nodes, _traceStats.depth, elapsed, false});
+        _traceStats = {};
+        #endif
+
+        string str{};
+        if (_sink)
+        {
+            _sink->write(_str);
+            _sink->finish();
+        }
+        else
+        {
+            str = std::move(_str);
+        }
 
         // Reset state
         _str.clear();
@@ -615,6 +1098,46 @@ namespace qc::json
         return str;
     }
 
+    inline void Encoder::reset() noexcept
+    {
+        _str.clear();
+        _scopeDeltas.clear();
+        _canonicalKeys.clear();
+        _container = Container::none;
+        _density = _baseDensity;
+        _indentation = 0u;
+        _prevElement = _Element::none;
+        _isContent = false;
+        _isKey = false;
+        _isString = false;
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        _error.clear();
+        #endif
+        #ifdef QC_JSON_TRACE
+        _traceStats = {};
+        #endif
+    }
+
+    inline bool Encoder::failed() const noexcept
+    {
+        return _failed();
+    }
+
+    inline string_view Encoder::error() const noexcept
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        return _error;
+        #else
+        return {};
+        #endif
+    }
+
+    inline void Encoder::setSink(Sink * const sink, const size_t bufferSize) noexcept
+    {
+        _sink = sink;
+        _sinkBufferSize = bufferSize;
+    }
+
     inline Container Encoder::container() const noexcept
     {
         return _container;
@@ -625,24 +1148,75 @@ namespace qc::json
         return _density;
     }
 
+    inline bool Encoder::canonical() const noexcept
+    {
+        return _canonical;
+    }
+
+    inline void Encoder::_fail(const string_view msg)
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        _error = msg;
+        #else
+        throw EncodeError{msg};
+        #endif
+    }
+
+    inline bool Encoder::_failed() const noexcept
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        return !_error.empty();
+        #else
+        return false;
+        #endif
+    }
+
+    inline bool Encoder::_checkNoOpenString()
+    {
+        if (_isString)
+        {
+            _fail("An open string must first be ended"sv);
+            return false;
+        }
+        return true;
+    }
+
     inline void Encoder::_start(const Container container, const Density density)
     {
+        if (_failed() || !_checkNoOpenString())
+        {
+            return;
+        }
         if (_container == Container::none && _isContent)
         {
-            throw EncodeError{"Cannot add to complete JSON"sv};
+            _fail("Cannot add to complete JSON"sv);
+            return;
         }
         if (_container == Container::object && !_isKey)
         {
-            throw EncodeError{"Cannot add to object without first providing a key"sv};
+            _fail("Cannot add to object without first providing a key"sv);
+            return;
         }
 
         _prefix();
         _str += container == Container::object ? '{' : '[';
 
+        if (_canonical && container == Container::object)
+        {
+            _canonicalKeys.emplace_back();
+        }
+
         const int8_t containerDelta{int8_t(int8_t(container) - int8_t(_container))};
         const Density newDensity{density > _density ? density : _density};
         const int8_t densityDelta{int8_t(int8_t(newDensity) - int8_t(_density))};
         _scopeDeltas.push_back(_ScopeDelta{containerDelta, densityDelta});
+        #ifdef QC_JSON_TRACE
+        ++_traceStats.nodes;
+        if (_scopeDeltas.size() > _traceStats.depth)
+        {
+            _traceStats.depth = _scopeDeltas.size();
+        }
+        #endif
         _container = container;
         _density = newDensity;
         _indentation += _indentSpaces;
@@ -653,31 +1227,47 @@ namespace qc::json
     template <typename T>
     inline void Encoder::_val(const T v)
     {
+        if (_failed() || !_checkNoOpenString())
+        {
+            return;
+        }
         if (_container == Container::none && _isContent)
         {
-            throw EncodeError{"Cannot add to complete JSON"sv};
+            _fail("Cannot add to complete JSON"sv);
+            return;
         }
         if (_container == Container::object && !_isKey)
         {
-            throw EncodeError{"Cannot add to object without first providing a key"sv};
+            _fail("Cannot add to object without first providing a key"sv);
+            return;
         }
 
         _prefix();
         _encode(v);
+        #ifdef QC_JSON_TRACE
+        ++_traceStats.nodes;
+        #endif
 
         _prevElement = _Element::val;
         _isContent = true;
         _isKey = false;
+
+        _tryFlush();
     }
 
     inline void Encoder::_key(const string_view key)
     {
+        if (_failed() || !_checkNoOpenString())
+        {
+            return;
+        }
         bool identifier{false};
         if (_useIdentifiers)
         {
             if (key.empty())
             {
-                throw EncodeError{"Identifier must not be empty"sv};
+                _fail("Identifier must not be empty"sv);
+                return;
             }
 
             // Ensure the key has only alphanumeric and underscore characters
@@ -692,6 +1282,18 @@ namespace qc::json
             }
         }
 
+        // Canonical keys must be strictly ascending so that no reordering is needed and output may be streamed
+        if (_canonical)
+        {
+            string & prevKey{_canonicalKeys.back()};
+            if (_prevElement != _Element::start && !_canonicalKeyLess(prevKey, key))
+            {
+                _fail("Canonical keys must be unique and in ascending order"sv);
+                return;
+            }
+            prevKey = key;
+        }
+
         _prefix();
         if (identifier)
         {
@@ -720,7 +1322,13 @@ namespace qc::json
         {
             switch (_prevElement)
             {
-                case _Element::none: break;
+                case _Element::none:
+                {
+                    #ifdef QC_JSON_TRACE
+                    _traceStats.start = std::chrono::steady_clock::now();
+                    #endif
+                    break;
+                }
                 case _Element::key: break;
                 case _Element::val: _str += ','; [[fallthrough]];
                 case _Element::start: [[fallthrough]];
@@ -751,11 +1359,34 @@ namespace qc::json
         }
     }
 
+    inline void Encoder::_tryFlush()
+    {
+        if (_sink && _str.size() >= _sinkBufferSize)
+        {
+            #ifdef QC_JSON_TRACE
+            _traceStats.flushedBytes += _str.size();
+            #endif
+            _sink->write(_str);
+            _str.clear();
+        }
+    }
+
     inline void Encoder::_encode(const string_view v)
+    {
+        _str += _quote;
+        _encodeContent(v);
+        _str += _quote;
+    }
+
+    inline void Encoder::_encodeContent(const string_view v)
     {
         static constexpr char hexChars[16u]{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 
-        _str += _quote;
+        if (_strict)
+        {
+            _encodeStrictContent(v);
+            return;
+        }
 
         for (const char c : v)
         {
@@ -782,12 +1413,47 @@ namespace qc::json
                 }
             }
         }
+    }
 
-        _str += _quote;
+    inline void Encoder::_encodeStrictContent(const string_view v)
+    {
+        static constexpr char hexChars[16u]{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+        // Only `"`, `\`, and control characters are escaped. All other bytes, including UTF-8, are written as is
+        for (const char c : v)
+        {
+            if (uchar(c) >= 0x20u)
+            {
+                if (c == '"' || c == '\\') _str += '\\';
+                _str += c;
+            }
+            else
+            {
+                switch (c)
+                {
+                    case '\b': _str += R"(\b)"; break;
+                    case '\t': _str += R"(\t)"; break;
+                    case '\n': _str += R"(\n)"; break;
+                    case '\f': _str += R"(\f)"; break;
+                    case '\r': _str += R"(\r)"; break;
+                    default:
+                        _str += "\\u00"sv;
+                        _str += hexChars[(uchar(c) >> 4) & 0xF];
+                        _str += hexChars[uchar(c) & 0xF];
+                }
+            }
+        }
     }
 
     inline void Encoder::_encode(const int64_t v)
     {
+        // Beyond 2^53 ECMAScript formats the nearest double instead
+        if (_canonical && (v > _maxExactInteger || v < -_maxExactInteger))
+        {
+            _encodeCanonical(double(v));
+            return;
+        }
+
         char buffer[24u];
         const std::to_chars_result res{std::to_chars(buffer, buffer + sizeof(buffer), v)};
         _str.append(buffer, size_t(res.ptr - buffer));
@@ -795,6 +1461,12 @@ namespace qc::json
 
     inline void Encoder::_encode(const uint64_t v)
     {
+        if (_canonical && v > uint64_t(_maxExactInteger))
+        {
+            _encodeCanonical(double(v));
+            return;
+        }
+
         char buffer[24u];
         const std::to_chars_result res{std::to_chars(buffer, buffer + sizeof(buffer), v)};
         _str.append(buffer, size_t(res.ptr - buffer));
@@ -802,6 +1474,12 @@ namespace qc::json
 
     inline void Encoder::_encode(const _BinaryToken v)
     {
+        if (_strict)
+        {
+            _encode(v.val);
+            return;
+        }
+
         char buffer[66u];
         buffer[0] = '0';
         buffer[1] = 'b';
@@ -811,6 +1489,12 @@ namespace qc::json
 
     inline void Encoder::_encode(const _OctalToken v)
     {
+        if (_strict)
+        {
+            _encode(v.val);
+            return;
+        }
+
         char buffer[26u];
         buffer[0] = '0';
         buffer[1] = 'o';
@@ -818,8 +1502,33 @@ namespace qc::json
         _str.append(buffer, size_t(res.ptr - buffer));
     }
 
+    inline void Encoder::_encode(_Base64Token v)
+    {
+        _str += _quote;
+
+        // Encode in pieces so that output to a sink stays bounded even if there are a lot of bytes
+        const size_t pieceSize{_sink && _sinkBufferSize ? (_sinkBufferSize / 4u + 1u) * 3u : v.bytes.size()};
+        do
+        {
+            const std::span<const std::byte> piece{v.bytes.first(std::min(pieceSize, v.bytes.size()))};
+            const size_t prevSize{_str.size()};
+            _str.resize(prevSize + (piece.size() + 2u) / 3u * 4u);
+            _encodeBase64(piece, _str.data() + prevSize);
+            _tryFlush();
+            v.bytes = v.bytes.subspan(piece.size());
+        } while (!v.bytes.empty());
+
+        _str += _quote;
+    }
+
     inline void Encoder::_encode(const _HexToken v)
     {
+        if (_strict)
+        {
+            _encode(v.val);
+            return;
+        }
+
         // We're hand rolling this because `std::to_chars` doesn't support uppercase hex
         static constexpr char hexTable[16u]{
             '0', '1', '2', '3',
@@ -852,11 +1561,93 @@ namespace qc::json
 
     inline void Encoder::_encode(const double v)
     {
+        if (_canonical)
+        {
+            _encodeCanonical(v);
+            return;
+        }
+
+        if (_strict && !std::isfinite(v))
+        {
+            _fail("Strict JSON cannot represent NaN or infinity"sv);
+            return;
+        }
+
         char buffer[24u];
         const std::to_chars_result res{std::to_chars(buffer, buffer + sizeof(buffer), v)};
         _str.append(buffer, size_t(res.ptr - buffer));
     }
 
+    // Follows the ECMAScript `Number.prototype.toString` algorithm, as required by RFC 8785
+    inline void Encoder::_encodeCanonical(const double v)
+    {
+        if (!std::isfinite(v))
+        {
+            _fail("Canonical JSON cannot represent NaN or infinity"sv);
+            return;
+        }
+
+        // Also catches negative zero
+        if (v == 0.0)
+        {
+            _str += '0';
+            return;
+        }
+
+        // Shortest round-trip digits in the form `[-]d[.ddd]e[+-]xx`
+        char buffer[32u];
+        const std::to_chars_result res{std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::scientific)};
+        const char * pos{buffer};
+
+        if (*pos == '-')
+        {
+            _str += '-';
+            ++pos;
+        }
+
+        char digits[24u];
+        int digitCount{0};
+        for (; *pos != 'e'; ++pos)
+        {
+            if (*pos != '.') digits[digitCount++] = *pos;
+        }
+        int exponent{0};
+        std::from_chars(pos + 1 + (pos[1] == '+'), res.ptr, exponent);
+
+        // The position of the decimal point relative to the first digit
+        const int point{exponent + 1};
+
+        if (digitCount <= point && point <= 21)
+        {
+            _str.append(digits, size_t(digitCount));
+            _str.append(size_t(point - digitCount), '0');
+        }
+        else if (0 < point && point <= 21)
+        {
+            _str.append(digits, size_t(point));
+            _str += '.';
+            _str.append(digits + point, size_t(digitCount - point));
+        }
+        else if (-6 < point && point <= 0)
+        {
+            _str += "0."sv;
+            _str.append(size_t(-point), '0');
+            _str.append(digits, size_t(digitCount));
+        }
+        else
+        {
+            _str += digits[0];
+            if (digitCount > 1)
+            {
+                _str += '.';
+                _str.append(digits + 1, size_t(digitCount - 1));
+            }
+            _str += 'e';
+            _str += exponent < 0 ? '-' : '+';
+            _encode(int64_t(exponent < 0 ? -exponent : exponent));
+        }
+    }
+
     inline void Encoder::_encode(const bool v)
     {
         _str += v ? "true"sv : "false"sv;
@@ -0,0 +1,670 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides decoding of files with reading and decoding overlapped, and an encoder sink that writes files
+/// asynchronously
+///
+/// Uses `qc-json-decode.hpp` for the decoding, `qc-json-encode.hpp` for the sink, and `qc-json.hpp` for decoding to a DOM
+///
+/// On Linux, `FileSink` uses `io_uring` if the kernel headers are available, unless `QC_JSON_NO_IO_URING` is defined
+///
+/// See the README for more info and examples!
+///
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && !defined(QC_JSON_NO_IO_URING)
+    #define QC_JSON_IO_URING
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+#include <qc-json.hpp>
+
+namespace qc::json
+{
+    ///
+    /// Thrown when a file cannot be opened or read
+    ///
+    struct FileError : Error
+    {
+        explicit FileError(string_view msg) noexcept;
+    };
+
+    ///
+    /// Decodes a file while it is still being read
+    ///
+    /// A background thread reads the file a chunk at a time into a buffer the size of the file, while the calling thread
+    /// decodes whatever has arrived so far. Disk I/O and decoding therefore run at the same time rather than taking turns,
+    /// which is most useful for slow or networked filesystems where memory mapping is unsuitable
+    ///
+    /// @param path the file to decode
+    /// @param composer the composer to receive the decoded JSON, as with `decode`
+    /// @param initialState the state of the root, as with `decode`
+    /// @param chunkSize how many bytes to read at a time
+    /// @throw `FileError` if the file cannot be opened or read
+    /// @throw `DecodeError` if the JSON is invalid
+    ///
+    template <typename Composer, typename State> void decodeFile(const std::filesystem::path & path, Composer & composer, State & initialState, size_t chunkSize = 1u << 20);
+    template <typename Composer, typename State> void decodeFile(const std::filesystem::path & path, Composer & composer, State && initialState, size_t chunkSize = 1u << 20);
+
+    ///
+    /// Decodes a file to a DOM, overlapping reading and decoding. See the SAX `decodeFile` above
+    ///
+    /// @param path the file to decode
+    /// @param chunkSize how many bytes to read at a time
+    /// @return the root value of the JSON
+    /// @throw `FileError` if the file cannot be opened or read
+    /// @throw `DecodeError` if the JSON is invalid
+    ///
+    Value decodeFile(const std::filesystem::path & path, size_t chunkSize = 1u << 20);
+
+    // Closes a file held in a `std::unique_ptr`
+    struct _FileCloser
+    {
+        void operator()(std::FILE * file) const noexcept;
+    };
+
+    ///
+    /// A sink that writes the encoded JSON to a file without blocking the encoder on each write
+    ///
+    /// Output is copied into a pool of buffers. When a buffer fills, it is submitted to `io_uring` as a single write and
+    /// the encoder carries on with the next buffer while the write is in flight. The buffers are registered with the
+    /// kernel up front so that it need not map them for every write. If `io_uring` is unavailable, such as on other
+    /// platforms or when disabled by the system, each full buffer is instead written synchronously
+    ///
+    /// Example:
+    ///     qc::json::FileSink sink{"export.json"};
+    ///     encoder.setSink(&sink);
+    ///     encoder << ...;
+    ///     encoder.finish();
+    ///
+    class FileSink : public Sink
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param path the file to write, which is created or truncated
+        /// @param bufferSize the size of each buffer, and so of each write
+        /// @param bufferCount how many buffers there are, at most all but one of which may be in flight at once
+        /// @param async whether to use `io_uring` if available
+        /// @throw `FileError` if the file cannot be opened
+        ///
+        explicit FileSink(const std::filesystem::path & path, size_t bufferSize = 1u << 20, size_t bufferCount = 4u, bool async = true);
+
+        FileSink(const FileSink &) = delete;
+
+        ///
+        /// Writes anything left unwritten and waits for writes in flight. Errors are ignored; call `finish` first to see
+        /// them
+        ///
+        ~FileSink() noexcept override;
+
+        FileSink & operator=(const FileSink &) = delete;
+
+        ///
+        /// @throw `FileError` if an earlier write failed
+        ///
+        void write(string_view chunk) override;
+
+        ///
+        /// Writes the partially filled buffer and waits for all writes to complete. The file stays open, so that further
+        /// output, such as from reusing the encoder, is appended
+        ///
+        /// @throw `FileError` if a write failed
+        ///
+        void finish() override;
+
+        ///
+        /// @return whether writes are being made asynchronously through `io_uring`
+        ///
+        bool async() const noexcept;
+
+        private: //-------------------------------------------------------------
+
+        std::unique_ptr<std::FILE, _FileCloser> _file{};
+        size_t _bufferSize;
+        size_t _bufferCount;
+        std::unique_ptr<char[]> _buffers{};
+        size_t _current{0u};
+        size_t _currentSize{0u};
+        bool _async{false};
+
+        #ifdef QC_JSON_IO_URING
+        int _ring{-1};
+        bool _fixed{false};
+        void * _sqRing{nullptr};
+        size_t _sqRingSize{0u};
+        void * _cqRing{nullptr};
+        size_t _cqRingSize{0u};
+        io_uring_sqe * _sqes{nullptr};
+        size_t _sqesSize{0u};
+        unsigned * _sqTail{nullptr};
+        unsigned _sqMask{0u};
+        unsigned * _sqArray{nullptr};
+        unsigned * _cqHead{nullptr};
+        unsigned * _cqTail{nullptr};
+        unsigned _cqMask{0u};
+        io_uring_cqe * _cqes{nullptr};
+        uint64_t _offset{0u};
+        std::vector<size_t> _freeBuffers{};
+        std::vector<uint64_t> _bufferOffsets{};
+        std::vector<size_t> _bufferSizes{};
+        size_t _inFlight{0u};
+        bool _failed{false};
+
+        bool _setUpRing() noexcept;
+
+        void _tearDownRing() noexcept;
+
+        bool _submitAsync() noexcept;
+
+        void _reap(bool wait) noexcept;
+        #endif
+
+        char * _buffer(size_t i) const noexcept;
+
+        // Writes the current buffer, returning whether it and any earlier writes succeeded
+        bool _submit() noexcept;
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    inline FileError::FileError(const string_view msg) noexcept :
+        Error{msg}
+    {}
+
+    inline void _FileCloser::operator()(std::FILE * const file) const noexcept
+    {
+        std::fclose(file);
+    }
+
+    // Reads a file on a background thread, telling the decoder how far it may go as the file comes in
+    //
+    // The decoder skips whitespace before every token, so it only needs to know that the next token has been read in
+    // full. To that end, each chunk is lexed as it arrives, keeping track of strings and comments, and the limit is put
+    // just past the last structural character (`{}[],:`) read. The next token before that point must end before it, as
+    // no string or comment can span it. Past that, a small margin allows for the decoder's lookahead
+    class _FileReader final : public _InputSource
+    {
+        public: //--------------------------------------------------------------
+
+        _FileReader(const std::filesystem::path & path, const size_t chunkSize) :
+            _chunkSize{std::max(chunkSize, size_t{1u})}
+        {
+            std::error_code error{};
+            const uintmax_t size{std::filesystem::file_size(path, error)};
+            if (error)
+            {
+                _throw<FileError>("Failed to open file"sv);
+            }
+            _size = size_t(size);
+
+            // Held such that it is closed if anything below throws
+            _file.reset(std::fopen(path.string().c_str(), "rb"));
+            if (!_file)
+            {
+                _throw<FileError>("Failed to open file"sv);
+            }
+
+            _data = std::make_unique_for_overwrite<char[]>(_size);
+            _ready = _data.get();
+            _thread = std::thread{&_FileReader::_read, this};
+        }
+
+        _FileReader(const _FileReader &) = delete;
+
+        ~_FileReader() noexcept
+        {
+            _stop = true;
+            _thread.join();
+        }
+
+        _FileReader & operator=(const _FileReader &) = delete;
+
+        string_view view() const noexcept
+        {
+            return string_view{_data.get(), _size};
+        }
+
+        const char * await(const char * const pos, bool & complete) override
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [&]() { return _done || _ready > pos; });
+
+            if (_failed)
+            {
+                _throw<FileError>("Failed to read file"sv);
+            }
+
+            complete = _done;
+            return _done ? _data.get() + _size : _ready;
+        }
+
+        private: //-------------------------------------------------------------
+
+        size_t _chunkSize;
+        size_t _size{0u};
+        std::unique_ptr<std::FILE, _FileCloser> _file{};
+        std::unique_ptr<char[]> _data{};
+        std::thread _thread{};
+        std::atomic<bool> _stop{false};
+
+        // Guarded by `_mutex`
+        std::mutex _mutex{};
+        std::condition_variable _condition{};
+        const char * _ready{nullptr};
+        bool _done{false};
+        bool _failed{false};
+
+        // Only touched by the reading thread
+        _ReadAheadLexer _lexer{};
+
+        void _read() noexcept
+        {
+            size_t read{0u};
+            bool failed{false};
+
+            while (read < _size && !_stop)
+            {
+                const size_t n{std::fread(_data.get() + read, 1u, std::min(_chunkSize, _size - read), _file.get())};
+                // The file shrank or errored since its size was taken
+                if (n == 0u)
+                {
+                    failed = true;
+                    break;
+                }
+                read += n;
+
+                if (read < _size && read > _readAheadLookahead)
+                {
+                    const size_t limit{_lexer.lexTo(_data.get(), read - _readAheadLookahead)};
+                    if (limit)
+                    {
+                        const std::lock_guard<std::mutex> lock{_mutex};
+                        _ready = _data.get() + limit;
+                    }
+                    _condition.notify_one();
+                }
+            }
+
+            {
+                const std::lock_guard<std::mutex> lock{_mutex};
+                _done = true;
+                _failed = failed;
+            }
+            _condition.notify_one();
+        }
+    };
+
+    template <typename Composer, typename State>
+    inline void decodeFile(const std::filesystem::path & path, Composer & composer, State & initialState, const size_t chunkSize)
+    {
+        _FileReader reader{path, chunkSize};
+        const DecodeResult result{_decode<true>(reader.view(), composer, initialState, &reader)};
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        if (!result)
+        {
+            std::abort();
+        }
+        #else
+        static_cast<void>(result);
+        #endif
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeFile(const std::filesystem::path & path, Composer & composer, State && initialState, const size_t chunkSize)
+    {
+        decodeFile(path, composer, initialState, chunkSize);
+    }
+
+    inline Value decodeFile(const std::filesystem::path & path, const size_t chunkSize)
+    {
+        Value root{};
+        _Composer::State rootState{&root, Container::none};
+        _Composer composer{};
+        decodeFile(path, composer, rootState, chunkSize);
+        return root;
+    }
+
+    inline FileSink::FileSink(const std::filesystem::path & path, const size_t bufferSize, const size_t bufferCount, const bool async) :
+        _bufferSize{std::max(bufferSize, size_t{4096u})},
+        _bufferCount{std::clamp(bufferCount, size_t{2u}, size_t{64u})}
+    {
+        _file.reset(std::fopen(path.string().c_str(), "wb"));
+        if (!_file)
+        {
+            _throw<FileError>("Failed to open file"sv);
+        }
+        // Writes are already made a whole buffer at a time
+        std::setvbuf(_file.get(), nullptr, _IONBF, 0u);
+
+        #ifdef QC_JSON_IO_URING
+        if (async)
+        {
+            _buffers = std::make_unique_for_overwrite<char[]>(_bufferSize * _bufferCount);
+            _async = _setUpRing();
+        }
+        #else
+        static_cast<void>(async);
+        #endif
+
+        // Only the one buffer is needed when writing synchronously
+        if (!_async)
+        {
+            _buffers = std::make_unique_for_overwrite<char[]>(_bufferSize);
+        }
+    }
+
+    inline FileSink::~FileSink() noexcept
+    {
+        static_cast<void>(_submit());
+
+        #ifdef QC_JSON_IO_URING
+        if (_async)
+        {
+            while (_inFlight)
+            {
+                _reap(true);
+            }
+            _tearDownRing();
+        }
+        #endif
+    }
+
+    inline void FileSink::write(string_view chunk)
+    {
+        while (!chunk.empty())
+        {
+            const size_t n{std::min(chunk.size(), _bufferSize - _currentSize)};
+            std::memcpy(_buffer(_current) + _currentSize, chunk.data(), n);
+            _currentSize += n;
+            chunk.remove_prefix(n);
+
+            if (_currentSize == _bufferSize && !_submit())
+            {
+                _throw<FileError>("Failed to write file"sv);
+            }
+        }
+    }
+
+    inline void FileSink::finish()
+    {
+        bool succeeded{_submit()};
+
+        #ifdef QC_JSON_IO_URING
+        if (_async)
+        {
+            while (_inFlight)
+            {
+                _reap(true);
+            }
+            succeeded = succeeded && !_failed;
+        }
+        #endif
+
+        if (!succeeded)
+        {
+            _throw<FileError>("Failed to write file"sv);
+        }
+    }
+
+    inline bool FileSink::async() const noexcept
+    {
+        return _async;
+    }
+
+    inline char * FileSink::_buffer(const size_t i) const noexcept
+    {
+        return _buffers.get() + i * _bufferSize;
+    }
+
+    inline bool FileSink::_submit() noexcept
+    {
+        if (!_currentSize)
+        {
+            return true;
+        }
+
+        #ifdef QC_JSON_IO_URING
+        if (_async)
+        {
+            return _submitAsync();
+        }
+        #endif
+
+        const size_t size{std::exchange(_currentSize, 0u)};
+        return std::fwrite(_buffer(_current), 1u, size, _file.get()) == size;
+    }
+
+    #ifdef QC_JSON_IO_URING
+
+    // There is no libc wrapper for these, and liburing is deliberately not required
+    inline int _ioUringEnter(const int ring, const unsigned toSubmit, const unsigned minComplete, const unsigned flags) noexcept
+    {
+        int result;
+        do
+        {
+            result = int(syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0));
+        } while (result < 0 && errno == EINTR);
+        return result;
+    }
+
+    inline bool FileSink::_setUpRing() noexcept
+    {
+        io_uring_params params{};
+        _ring = int(syscall(__NR_io_uring_setup, unsigned(_bufferCount), &params));
+        if (_ring < 0)
+        {
+            return false;
+        }
+
+        _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap{bool(params.features & IORING_FEAT_SINGLE_MMAP)};
+        if (singleMap)
+        {
+            _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+        }
+
+        _sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+        if (_sqRing == MAP_FAILED)
+        {
+            _sqRing = nullptr;
+            _tearDownRing();
+            return false;
+        }
+        if (singleMap)
+        {
+            _cqRing = _sqRing;
+        }
+        else
+        {
+            _cqRing = mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+            if (_cqRing == MAP_FAILED)
+            {
+                _cqRing = nullptr;
+                _tearDownRing();
+                return false;
+            }
+        }
+        _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void * const sqes{mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES)};
+        if (sqes == MAP_FAILED)
+        {
+            _tearDownRing();
+            return false;
+        }
+        _sqes = static_cast<io_uring_sqe *>(sqes);
+
+        char * const sq{static_cast<char *>(_sqRing)};
+        char * const cq{static_cast<char *>(_cqRing)};
+        _sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        _cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        // Registration may fail, such as due to the locked memory limit, in which case plain writes are used instead
+        std::vector<iovec> iovecs(_bufferCount);
+        for (size_t i{0u}; i < _bufferCount; ++i)
+        {
+            iovecs[i] = iovec{_buffer(i), _bufferSize};
+        }
+        _fixed = syscall(__NR_io_uring_register, _ring, IORING_REGISTER_BUFFERS, iovecs.data(), unsigned(_bufferCount)) == 0;
+
+        // The first buffer is current to start
+        for (size_t i{_bufferCount - 1u}; i > 0u; --i)
+        {
+            _freeBuffers.push_back(i);
+        }
+        _bufferOffsets.resize(_bufferCount);
+        _bufferSizes.resize(_bufferCount);
+
+        return true;
+    }
+
+    inline void FileSink::_tearDownRing() noexcept
+    {
+        if (_sqes)
+        {
+            munmap(_sqes, _sqesSize);
+        }
+        if (_cqRing && _cqRing != _sqRing)
+        {
+            munmap(_cqRing, _cqRingSize);
+        }
+        if (_sqRing)
+        {
+            munmap(_sqRing, _sqRingSize);
+        }
+        // Also unregisters the buffers
+        close(_ring);
+    }
+
+    inline bool FileSink::_submitAsync() noexcept
+    {
+        if (_failed)
+        {
+            return false;
+        }
+
+        // There is always room in the submission queue, as it has an entry per buffer
+        const unsigned tail{*_sqTail};
+        const unsigned index{tail & _sqMask};
+        io_uring_sqe & sqe{_sqes[index]};
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = _fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe.fd = fileno(_file.get());
+        sqe.addr = uint64_t(reinterpret_cast<uintptr_t>(_buffer(_current)));
+        sqe.len = unsigned(_currentSize);
+        sqe.off = _offset;
+        sqe.buf_index = uint16_t(_current);
+        sqe.user_data = _current;
+        _sqArray[index] = index;
+        std::atomic_ref<unsigned>{*_sqTail}.store(tail + 1u, std::memory_order_release);
+
+        // The kernel only reads the entry once the tail is past it. If it was not submitted, it is taken back so that
+        // nothing waits on a write that will never complete
+        if (_ioUringEnter(_ring, 1u, 0u, 0u) < 1)
+        {
+            std::atomic_ref<unsigned>{*_sqTail}.store(tail, std::memory_order_release);
+            _failed = true;
+            return false;
+        }
+
+        _bufferOffsets[_current] = _offset;
+        _bufferSizes[_current] = _currentSize;
+        _offset += _currentSize;
+        ++_inFlight;
+
+        // Carry on with the next free buffer, waiting for one if they are all in flight. A failed wait gives up on them
+        _reap(false);
+        while (_freeBuffers.empty() && !_failed)
+        {
+            _reap(true);
+        }
+        if (_freeBuffers.empty())
+        {
+            return false;
+        }
+        _current = _freeBuffers.back();
+        _freeBuffers.pop_back();
+        _currentSize = 0u;
+
+        return true;
+    }
+
+    inline void FileSink::_reap(const bool wait) noexcept
+    {
+        if (wait && _ioUringEnter(_ring, 0u, 1u, IORING_ENTER_GETEVENTS) < 0)
+        {
+            // Without a way to know what completed, give up on the writes in flight
+            _failed = true;
+            _inFlight = 0u;
+            return;
+        }
+
+        unsigned head{*_cqHead};
+        const unsigned tail{std::atomic_ref<unsigned>{*_cqTail}.load(std::memory_order_acquire)};
+        for (; head != tail; ++head)
+        {
+            const io_uring_cqe & cqe{_cqes[head & _cqMask]};
+            const size_t buffer{size_t(cqe.user_data)};
+
+            if (cqe.res < 0)
+            {
+                _failed = true;
+            }
+            // A short write, which should not happen for regular files, is finished off synchronously
+            else if (size_t(cqe.res) < _bufferSizes[buffer])
+            {
+                size_t written{size_t(cqe.res)};
+                while (written < _bufferSizes[buffer])
+                {
+                    const ssize_t n{pwrite(fileno(_file.get()), _buffer(buffer) + written, _bufferSizes[buffer] - written, off_t(_bufferOffsets[buffer] + written))};
+                    if (n <= 0)
+                    {
+                        _failed = true;
+                        break;
+                    }
+                    written += size_t(n);
+                }
+            }
+
+            _freeBuffers.push_back(buffer);
+            --_inFlight;
+        }
+        std::atomic_ref<unsigned>{*_cqHead}.store(head, std::memory_order_release);
+    }
+
+    #endif
+}
@@ -0,0 +1,454 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides content hashing of JSON
+///
+/// Uses `qc-json-encode.hpp` to produce the canonical form that is hashed, and `qc-json-decode.hpp` to fingerprint
+/// JSON strings directly
+///
+/// See the README for more info and examples!
+///
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <string_view>
+
+#include <qc-json-decode.hpp>
+#include <qc-json-encode.hpp>
+
+namespace qc::json
+{
+    ///
+    /// A 128 bit hash digest. `low` may be used on its own as a 64 bit digest
+    ///
+    struct Digest
+    {
+        uint64_t low;
+        uint64_t high;
+
+        bool operator==(const Digest &) const noexcept = default;
+    };
+
+    ///
+    /// Incrementally computes the 128 bit MurmurHash3 (x64 variant) of a sequence of bytes
+    ///
+    /// The digest is the same no matter how the bytes are split between calls to `update`
+    ///
+    class Hasher
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param seed the hash seed
+        ///
+        explicit Hasher(uint64_t seed = 0u) noexcept;
+
+        ///
+        /// Hashes the next chunk of bytes
+        ///
+        /// @param bytes the next chunk
+        ///
+        void update(string_view bytes) noexcept;
+
+        ///
+        /// May be called at any point without affecting further updates
+        ///
+        /// @return the digest of all bytes hashed thus far
+        ///
+        Digest digest() const noexcept;
+
+        private: //-------------------------------------------------------------
+
+        uint64_t _h1;
+        uint64_t _h2;
+        uint64_t _length{0u};
+        uchar _tail[16u]{};
+        size_t _tailLength{0u};
+
+        void _block(const uchar * block) noexcept;
+    };
+
+    ///
+    /// A sink that hashes the encoded JSON as it is produced, without ever materializing the full string
+    ///
+    /// Example:
+    ///     qc::json::HashSink sink{};
+    ///     qc::json::Encoder encoder{Density::nospace, 0u, false, false, true};
+    ///     encoder.setSink(&sink);
+    ///     encoder << ...;
+    ///     encoder.finish();
+    ///     const qc::json::Digest digest{sink.digest()};
+    ///
+    class HashSink : public Sink
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param seed the hash seed
+        ///
+        explicit HashSink(uint64_t seed = 0u) noexcept;
+
+        void write(string_view chunk) override;
+
+        ///
+        /// @return the digest of all JSON written thus far
+        ///
+        Digest digest() const noexcept;
+
+        private: //-------------------------------------------------------------
+
+        Hasher _hasher;
+    };
+
+    ///
+    /// Computes the digest of the canonical encoding of the given value. Two values that encode to the same canonical
+    /// JSON have the same digest
+    ///
+    /// @param val the value to hash. May be anything that can be streamed to an `Encoder`, such as a `Value`
+    /// @param seed the hash seed
+    /// @return the digest
+    /// @throw `EncodeError` if the value cannot be canonically encoded
+    ///
+    template <typename T> Digest canonicalDigest(const T & val, uint64_t seed = 0u);
+
+    ///
+    /// A composer that computes a structural fingerprint of the JSON as it is decoded. No DOM is built
+    ///
+    /// The fingerprint is insensitive to whitespace, comments, key order, and number representation, e.g. `1`, `1.0`,
+    /// `1e0`, and `0x1` are all the same
+    ///
+    /// Example:
+    ///     qc::json::FingerprintComposer composer{};
+    ///     qc::json::decode(jsonStr, composer, qc::json::FingerprintComposer::State{});
+    ///     const qc::json::Digest digest{composer.digest()};
+    ///
+    class FingerprintComposer
+    {
+        public: //--------------------------------------------------------------
+
+        struct State
+        {
+            Container container{Container::none};
+            uint64_t count{0u};
+            Hasher elements{}; // Array elements are hashed in order
+            Digest members{}; // Object members are summed so that order does not matter
+            Digest key{};
+        };
+
+        State object(State & outerState);
+        State array(State & outerState);
+        void end(Density density, State && innerState, State & outerState);
+        void key(string_view key, State & state);
+        void val(string_view val, State & state);
+        void val(int64_t val, State & state);
+        void val(uint64_t val, State & state);
+        void val(double val, State & state);
+        void val(bool val, State & state);
+        void val(std::nullptr_t, State & state);
+        void comment(string_view comment, State & state);
+
+        ///
+        /// @return the fingerprint of the most recently decoded JSON
+        ///
+        Digest digest() const noexcept;
+
+        private: //-------------------------------------------------------------
+
+        Digest _digest{};
+
+        void _add(const Digest & digest, State & state);
+    };
+
+    ///
+    /// Convenience function to fingerprint a JSON string in a single decode pass. See `FingerprintComposer`
+    ///
+    /// @param json the JSON string to fingerprint
+    /// @return the fingerprint
+    /// @throw `DecodeError` if the JSON string is invalid
+    ///
+    Digest fingerprint(string_view json);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    inline constexpr uint64_t _rotl(const uint64_t v, const int n) noexcept
+    {
+        return (v << n) | (v >> (64 - n));
+    }
+
+    inline constexpr uint64_t _fmix(uint64_t k) noexcept
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDu;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53u;
+        k ^= k >> 33;
+        return k;
+    }
+
+    constexpr uint64_t _murmurC1{0x87C37B91114253D5u};
+    constexpr uint64_t _murmurC2{0x4CF5AD432745937Fu};
+
+    inline Hasher::Hasher(const uint64_t seed) noexcept :
+        _h1{seed},
+        _h2{seed}
+    {}
+
+    inline void Hasher::update(const string_view bytes) noexcept
+    {
+        if (bytes.empty())
+        {
+            return;
+        }
+
+        const uchar * pos{reinterpret_cast<const uchar *>(bytes.data())};
+        const uchar * const end{pos + bytes.size()};
+
+        _length += bytes.size();
+
+        // Complete any partial block left over from last time
+        if (_tailLength)
+        {
+            const size_t n{std::min(size_t(end - pos), 16u - _tailLength)};
+            std::memcpy(_tail + _tailLength, pos, n);
+            _tailLength += n;
+            pos += n;
+
+            if (_tailLength < 16u)
+            {
+                return;
+            }
+
+            _block(_tail);
+            _tailLength = 0u;
+        }
+
+        // Hash whole blocks directly from the input
+        for (; end - pos >= 16; pos += 16)
+        {
+            _block(pos);
+        }
+
+        // Save the remainder for next time
+        _tailLength = size_t(end - pos);
+        std::memcpy(_tail, pos, _tailLength);
+    }
+
+    inline Digest Hasher::digest() const noexcept
+    {
+        uint64_t h1{_h1};
+        uint64_t h2{_h2};
+        uint64_t k1{0u};
+        uint64_t k2{0u};
+
+        for (size_t i{_tailLength}; i > 8u; --i)
+        {
+            k2 ^= uint64_t(_tail[i - 1u]) << ((i - 9u) * 8u);
+        }
+        if (_tailLength > 8u)
+        {
+            k2 *= _murmurC2; k2 = _rotl(k2, 33); k2 *= _murmurC1; h2 ^= k2;
+        }
+
+        for (size_t i{std::min(_tailLength, size_t{8u})}; i > 0u; --i)
+        {
+            k1 ^= uint64_t(_tail[i - 1u]) << ((i - 1u) * 8u);
+        }
+        if (_tailLength)
+        {
+            k1 *= _murmurC1; k1 = _rotl(k1, 31); k1 *= _murmurC2; h1 ^= k1;
+        }
+
+        h1 ^= _length;
+        h2 ^= _length;
+        h1 += h2;
+        h2 += h1;
+        h1 = _fmix(h1);
+        h2 = _fmix(h2);
+        h1 += h2;
+        h2 += h1;
+
+        return Digest{h1, h2};
+    }
+
+    inline void Hasher::_block(const uchar * const block) noexcept
+    {
+        uint64_t k1;
+        uint64_t k2;
+        std::memcpy(&k1, block, 8u);
+        std::memcpy(&k2, block + 8, 8u);
+
+        k1 *= _murmurC1; k1 = _rotl(k1, 31); k1 *= _murmurC2; _h1 ^= k1;
+        _h1 = _rotl(_h1, 27); _h1 += _h2; _h1 = _h1 * 5u + 0x52DCE729u;
+
+        k2 *= _murmurC2; k2 = _rotl(k2, 33); k2 *= _murmurC1; _h2 ^= k2;
+        _h2 = _rotl(_h2, 31); _h2 += _h1; _h2 = _h2 * 5u + 0x38495AB5u;
+    }
+
+    inline HashSink::HashSink(const uint64_t seed) noexcept :
+        _hasher{seed}
+    {}
+
+    inline void HashSink::write(const string_view chunk)
+    {
+        _hasher.update(chunk);
+    }
+
+    inline Digest HashSink::digest() const noexcept
+    {
+        return _hasher.digest();
+    }
+
+    template <typename T>
+    inline Digest canonicalDigest(const T & val, const uint64_t seed)
+    {
+        HashSink sink{seed};
+        Encoder encoder{Density::nospace, 0u, false, false, true};
+        encoder.setSink(&sink);
+        encoder << val;
+        encoder.finish();
+        return sink.digest();
+    }
+
+    // Hashes a one byte type tag followed by the given bytes
+    inline Digest _taggedDigest(const char tag, const string_view bytes) noexcept
+    {
+        Hasher hasher{};
+        hasher.update(string_view{&tag, 1u});
+        hasher.update(bytes);
+        return hasher.digest();
+    }
+
+    // All integral numbers are hashed as a sign and magnitude, regardless of how they were represented
+    inline Digest _integralDigest(const bool negative, const uint64_t magnitude) noexcept
+    {
+        char bytes[9u];
+        bytes[0] = negative;
+        std::memcpy(bytes + 1, &magnitude, 8u);
+        return _taggedDigest('i', string_view{bytes, sizeof(bytes)});
+    }
+
+    inline FingerprintComposer::State FingerprintComposer::object(State & /*outerState*/)
+    {
+        return State{Container::object};
+    }
+
+    inline FingerprintComposer::State FingerprintComposer::array(State & /*outerState*/)
+    {
+        return State{Container::array};
+    }
+
+    inline void FingerprintComposer::end(const Density /*density*/, State && innerState, State & outerState)
+    {
+        const Digest contents{innerState.container == Container::object ? innerState.members : innerState.elements.digest()};
+        uint64_t bytes[3u]{innerState.count, contents.low, contents.high};
+        _add(_taggedDigest(innerState.container == Container::object ? 'o' : 'a', string_view{reinterpret_cast<const char *>(bytes), sizeof(bytes)}), outerState);
+    }
+
+    inline void FingerprintComposer::key(const string_view key, State & state)
+    {
+        state.key = _taggedDigest('k', key);
+    }
+
+    inline void FingerprintComposer::val(const string_view val, State & state)
+    {
+        _add(_taggedDigest('s', val), state);
+    }
+
+    inline void FingerprintComposer::val(const int64_t val, State & state)
+    {
+        _add(_integralDigest(val < 0, val < 0 ? uint64_t(0) - uint64_t(val) : uint64_t(val)), state);
+    }
+
+    inline void FingerprintComposer::val(const uint64_t val, State & state)
+    {
+        _add(_integralDigest(false, val), state);
+    }
+
+    inline void FingerprintComposer::val(double val, State & state)
+    {
+        // Integral floaters within the 64 bit range are hashed as integers
+        if (val == 0.0)
+        {
+            _add(_integralDigest(false, 0u), state);
+            return;
+        }
+        if (std::trunc(val) == val && val > -18446744073709551616.0 && val < 18446744073709551616.0)
+        {
+            _add(_integralDigest(val < 0.0, uint64_t(val < 0.0 ? -val : val)), state);
+            return;
+        }
+
+        if (std::isnan(val))
+        {
+            val = std::numeric_limits<double>::quiet_NaN();
+        }
+        const uint64_t bits{std::bit_cast<uint64_t>(val)};
+        _add(_taggedDigest('f', string_view{reinterpret_cast<const char *>(&bits), sizeof(bits)}), state);
+    }
+
+    inline void FingerprintComposer::val(const bool val, State & state)
+    {
+        _add(_taggedDigest('b', val ? "\1"sv : "\0"sv), state);
+    }
+
+    inline void FingerprintComposer::val(const std::nullptr_t, State & state)
+    {
+        _add(_taggedDigest('n', {}), state);
+    }
+
+    inline void FingerprintComposer::comment(const string_view /*comment*/, State & /*state*/)
+    {}
+
+    inline Digest FingerprintComposer::digest() const noexcept
+    {
+        return _digest;
+    }
+
+    inline void FingerprintComposer::_add(const Digest & digest, State & state)
+    {
+        switch (state.container)
+        {
+            case Container::object:
+            {
+                const uint64_t bytes[4u]{state.key.low, state.key.high, digest.low, digest.high};
+                const Digest member{_taggedDigest('m', string_view{reinterpret_cast<const char *>(bytes), sizeof(bytes)})};
+                state.members.low += member.low;
+                state.members.high += member.high;
+                break;
+            }
+            case Container::array:
+            {
+                state.elements.update(string_view{reinterpret_cast<const char *>(&digest), sizeof(digest)});
+                break;
+            }
+            default:
+            {
+                _digest = digest;
+            }
+        }
+
+        ++state.count;
+    }
+
+    inline Digest fingerprint(const string_view json)
+    {
+        FingerprintComposer composer{};
+        decode(json, composer, FingerprintComposer::State{});
+        return composer.digest();
+    }
+}
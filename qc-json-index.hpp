@@ -0,0 +1,1196 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides offset indices for random access into large JSON inputs without decoding all of it
+///
+/// Uses `qc-json-decode.hpp` to decode the indexed pieces and `qc-json.hpp` to decode them to a DOM
+///
+/// See the README for more info and examples!
+///
+
+#include <cctype>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define QC_JSON_INDEX_SSE2
+    #include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+    #define QC_JSON_INDEX_AVX2
+    #include <immintrin.h>
+#endif
+
+#include <qc-json.hpp>
+
+namespace qc::json
+{
+    ///
+    /// This will be thrown if an index cannot be saved or loaded, is not a valid index, or does not match its input
+    ///
+    struct IndexError : Error
+    {
+        explicit IndexError(string_view msg) noexcept;
+    };
+
+    // Byte offsets stored as a 64 bit anchor per 64 offsets plus a 32 bit delta per offset
+    struct _OffsetTable
+    {
+        std::vector<uint64_t> anchors{};
+        std::vector<uint32_t> deltas{};
+        std::vector<std::pair<uint64_t, uint64_t>> far{}; // Index and offset of those too far from their anchor
+
+        size_t size() const noexcept;
+
+        uint64_t operator[](size_t i) const noexcept;
+
+        void add(uint64_t offset);
+
+        void write(std::ostream & file) const;
+
+        void read(std::istream & file, size_t count, size_t farCount);
+
+        static uint64_t fileSize(uint64_t count, uint64_t farCount) noexcept;
+    };
+
+    ///
+    /// The offset of each record of a JSON Lines (NDJSON) input, for decoding any one record without scanning those
+    /// before it
+    ///
+    /// Offsets are stored compactly, as a 64 bit anchor per 64 records plus a 32 bit delta per record
+    ///
+    class LineIndex
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @return the number of records
+        ///
+        size_t size() const noexcept;
+
+        ///
+        /// @return the size in bytes of the input that was indexed
+        ///
+        uint64_t sourceSize() const noexcept;
+
+        ///
+        /// @param i the index of the record
+        /// @return the byte offset at which the record starts
+        /// @throw `IndexError` if `i` is out of range
+        ///
+        uint64_t offset(size_t i) const;
+
+        ///
+        /// @param ndjson the same input that was indexed
+        /// @param i the index of the record
+        /// @return the text of the record, without its trailing newline
+        /// @throw `IndexError` if `i` is out of range or `ndjson` is not the same size as the indexed input
+        ///
+        string_view record(string_view ndjson, size_t i) const;
+
+        private: //-------------------------------------------------------------
+
+        uint64_t _sourceSize{0u};
+        _OffsetTable _offsets{};
+
+        friend LineIndex indexLines(string_view ndjson);
+        friend void saveIndex(const LineIndex & index, const std::filesystem::path & path);
+        friend LineIndex loadLineIndex(const std::filesystem::path & path);
+    };
+
+    ///
+    /// The offset of each element of a root array, or each member of a root object along with its key, for decoding any
+    /// one element without parsing the rest of the document
+    ///
+    class ElementIndex
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @return whether the root is an object or an array
+        ///
+        Container container() const noexcept;
+
+        ///
+        /// @return the number of elements or members
+        ///
+        size_t size() const noexcept;
+
+        ///
+        /// @return the size in bytes of the input that was indexed
+        ///
+        uint64_t sourceSize() const noexcept;
+
+        ///
+        /// @param json the same input that was indexed
+        /// @param i the index of the element or member
+        /// @return the text of the element, or of the member's value, without surrounding whitespace
+        /// @throw `IndexError` if `i` is out of range or `json` is not the same size as the indexed input
+        ///
+        string_view element(string_view json, size_t i) const;
+
+        ///
+        /// @param i the index of the member
+        /// @return the decoded key of the member
+        /// @throw `IndexError` if the root is not an object or `i` is out of range
+        ///
+        string_view key(size_t i) const;
+
+        ///
+        /// @param key the key to look for
+        /// @return the index of the first member with the key, or `size()` if there is none
+        /// @throw `IndexError` if the root is not an object
+        ///
+        size_t find(string_view key) const;
+
+        private: //-------------------------------------------------------------
+
+        uint64_t _sourceSize{0u};
+        Container _container{Container::none};
+        _OffsetTable _starts{}; // Just past the delimiter before each element, or the colon of each member
+        _OffsetTable _ends{}; // The delimiter after each member, for objects only
+        uint64_t _end{0u}; // The delimiter after the last element
+        std::string _keyChars{};
+        std::vector<uint64_t> _keyStarts{}; // Into `_keyChars`, with an extra for the end of the last key
+        std::vector<uint64_t> _keyOrder{}; // Member indices sorted by key, stably
+
+        string_view _keyAt(size_t i) const noexcept;
+
+        void _sortKeys();
+
+        friend ElementIndex indexElements(string_view json);
+        friend void saveIndex(const ElementIndex & index, const std::filesystem::path & path);
+        friend ElementIndex loadElementIndex(const std::filesystem::path & path);
+    };
+
+    ///
+    /// Scans a JSON Lines (NDJSON) input for the start of each record
+    ///
+    /// Newlines are searched for using SIMD, skipping over strings and comments such that a JSON5 string continued onto
+    /// the next line or a block comment spanning lines does not end the record. Lines with nothing but whitespace are not
+    /// records. The records themselves are not validated
+    ///
+    /// @param ndjson the input to index
+    /// @return the index
+    ///
+    LineIndex indexLines(string_view ndjson);
+
+    ///
+    /// Scans a JSON document whose root is an array or object for the bounds of each of its elements or members
+    ///
+    /// This is a single SIMD bracket matching pass, using the same scanning as `indexLines`. Only the brackets are
+    /// checked; the elements themselves are not validated until they are decoded. Keys are decoded as they are found
+    ///
+    /// @param json the input to index
+    /// @return the index
+    /// @throw `IndexError` if the root is not an array or object, or its brackets do not match
+    ///
+    ElementIndex indexElements(string_view json);
+
+    ///
+    /// Saves the index to a file, typically a sidecar alongside the indexed input
+    ///
+    /// @param index the index to save
+    /// @param path the file to write, which is replaced if it exists
+    /// @throw `IndexError` if the file cannot be written
+    ///
+    void saveIndex(const LineIndex & index, const std::filesystem::path & path);
+    void saveIndex(const ElementIndex & index, const std::filesystem::path & path);
+
+    ///
+    /// @param path a file written by `saveIndex`
+    /// @return the loaded index
+    /// @throw `IndexError` if the file cannot be read or is not a compatible line index
+    ///
+    LineIndex loadLineIndex(const std::filesystem::path & path);
+
+    ///
+    /// @param path a file written by `saveIndex`
+    /// @return the loaded index
+    /// @throw `IndexError` if the file cannot be read or is not a compatible element index
+    ///
+    ElementIndex loadElementIndex(const std::filesystem::path & path);
+
+    ///
+    /// Decodes the single record at the given index
+    ///
+    /// @param ndjson the same input that was indexed
+    /// @param index the index of the input
+    /// @param i the index of the record to decode
+    /// @param composer the composer to receive the decoded JSON, as with `decode`
+    /// @param initialState the state of the root, as with `decode`
+    /// @throw `IndexError` if `i` is out of range or `ndjson` does not match the index
+    /// @throw `DecodeError` if the record is invalid. The position is from the start of `ndjson`
+    ///
+    template <typename Composer, typename State> void decodeRecord(string_view ndjson, const LineIndex & index, size_t i, Composer & composer, State & initialState);
+    template <typename Composer, typename State> void decodeRecord(string_view ndjson, const LineIndex & index, size_t i, Composer & composer, State && initialState);
+
+    ///
+    /// Decodes the single record at the given index to a DOM. See the SAX `decodeRecord` above
+    ///
+    /// @param ndjson the same input that was indexed
+    /// @param index the index of the input
+    /// @param i the index of the record to decode
+    /// @return the decoded record
+    /// @throw `IndexError` if `i` is out of range or `ndjson` does not match the index
+    /// @throw `DecodeError` if the record is invalid. The position is from the start of `ndjson`
+    ///
+    Value decodeRecord(string_view ndjson, const LineIndex & index, size_t i);
+
+    ///
+    /// Decodes the single element, or member value, at the given index as if it were the root
+    ///
+    /// @param json the same input that was indexed
+    /// @param index the index of the input
+    /// @param i the index of the element or member to decode
+    /// @param composer the composer to receive the decoded JSON, as with `decode`
+    /// @param initialState the state of the root, as with `decode`
+    /// @throw `IndexError` if `i` is out of range or `json` does not match the index
+    /// @throw `DecodeError` if the element is invalid. The position is from the start of `json`
+    ///
+    template <typename Composer, typename State> void decodeElement(string_view json, const ElementIndex & index, size_t i, Composer & composer, State & initialState);
+    template <typename Composer, typename State> void decodeElement(string_view json, const ElementIndex & index, size_t i, Composer & composer, State && initialState);
+
+    ///
+    /// Decodes the single element, or member value, at the given index to a DOM. See the SAX `decodeElement` above
+    ///
+    /// @param json the same input that was indexed
+    /// @param index the index of the input
+    /// @param i the index of the element or member to decode
+    /// @return the decoded element
+    /// @throw `IndexError` if `i` is out of range or `json` does not match the index
+    /// @throw `DecodeError` if the element is invalid. The position is from the start of `json`
+    ///
+    Value decodeElement(string_view json, const ElementIndex & index, size_t i);
+
+    ///
+    /// Decodes the value of the first member with the given key of a root object
+    ///
+    /// @param json the same input that was indexed
+    /// @param index the index of the input
+    /// @param key the key of the member to decode
+    /// @param composer the composer to receive the decoded JSON, as with `decode`
+    /// @param initialState the state of the root, as with `decode`
+    /// @throw `IndexError` if the root is not an object, there is no such member, or `json` does not match the index
+    /// @throw `DecodeError` if the value is invalid. The position is from the start of `json`
+    ///
+    template <typename Composer, typename State> void decodeMember(string_view json, const ElementIndex & index, string_view key, Composer & composer, State & initialState);
+    template <typename Composer, typename State> void decodeMember(string_view json, const ElementIndex & index, string_view key, Composer & composer, State && initialState);
+
+    ///
+    /// Decodes the value of the first member with the given key of a root object to a DOM. See the SAX `decodeMember`
+    /// above
+    ///
+    /// @param json the same input that was indexed
+    /// @param index the index of the input
+    /// @param key the key of the member to decode
+    /// @return the decoded value
+    /// @throw `IndexError` if the root is not an object, there is no such member, or `json` does not match the index
+    /// @throw `DecodeError` if the value is invalid. The position is from the start of `json`
+    ///
+    Value decodeMember(string_view json, const ElementIndex & index, string_view key);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    struct _IndexHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder; // `0x01020304` as written, to detect a mismatch
+        uint64_t sourceSize;
+        uint64_t count;
+        uint64_t farCount;
+    };
+
+    // Follows the header of an element index
+    struct _ElementIndexHeader
+    {
+        uint64_t container;
+        uint64_t end;
+        uint64_t endFarCount;
+        uint64_t keyCharCount;
+    };
+
+    inline constexpr char _lineIndexMagic[8]{'Q', 'C', 'J', 'L', 'I', 'N', 'E', 'S'};
+    inline constexpr char _elementIndexMagic[8]{'Q', 'C', 'J', 'E', 'L', 'E', 'M', 'S'};
+    inline constexpr uint32_t _indexVersion{1u};
+    inline constexpr uint32_t _indexByteOrder{0x01020304u};
+
+    // Offsets per 64 bit anchor
+    inline constexpr size_t _indexAnchorInterval{64u};
+
+    inline IndexError::IndexError(const string_view msg) noexcept :
+        Error{msg}
+    {}
+
+    // Sets bit `j` of `masks[i]` if byte `j` of the 64 byte block is the `i`th character
+    template <char... cs>
+    inline void _matchBlock(const char * const block, uint64_t (& masks)[sizeof...(cs)]) noexcept
+    {
+        size_t i{0u};
+
+        #if defined(QC_JSON_INDEX_AVX2)
+        const __m256i lo{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block))};
+        const __m256i hi{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32))};
+        ((masks[i++] =
+            uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, _mm256_set1_epi8(cs))))) |
+            uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, _mm256_set1_epi8(cs))))) << 32), ...);
+        #elif defined(QC_JSON_INDEX_SSE2)
+        const __m128i b0{_mm_loadu_si128(reinterpret_cast<const __m128i *>(block))};
+        const __m128i b1{_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16))};
+        const __m128i b2{_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 32))};
+        const __m128i b3{_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 48))};
+        ((masks[i++] =
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(b0, _mm_set1_epi8(cs))))) |
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(b1, _mm_set1_epi8(cs))))) << 16 |
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(b2, _mm_set1_epi8(cs))))) << 32 |
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(b3, _mm_set1_epi8(cs))))) << 48), ...);
+        #else
+        for (uint64_t & mask : masks)
+        {
+            mask = 0u;
+        }
+        for (size_t j{0u}; j < 64u; ++j)
+        {
+            i = 0u;
+            ((masks[i++] |= uint64_t(block[j] == cs) << j), ...);
+        }
+        #endif
+    }
+
+    // Calls `f(pos)` for each of the structural characters outside of strings and comments, in order
+    //
+    // Works on 64 byte blocks, matching every interesting character in the block at once and then stepping through the
+    // matches relevant to the current lexical state. An unescaped newline ends a string, as it is invalid there anyway
+    // and this keeps one bad record or element from swallowing those after it
+    template <char... structurals, typename F>
+    inline void _lexStructure(const string_view json, F && f)
+    {
+        enum class State { none, doubleString, singleString, lineComment, blockComment };
+
+        const char * const data{json.data()};
+        const size_t size{json.size()};
+        State state{State::none};
+        size_t pos{0u};
+
+        for (size_t blockStart{0u}; blockStart < size; blockStart += 64u)
+        {
+            // The last partial block is padded with nulls, which match nothing
+            const char * block{data + blockStart};
+            char padded[64];
+            if (size - blockStart < 64u)
+            {
+                std::memset(padded, 0, sizeof(padded));
+                std::memcpy(padded, block, size - blockStart);
+                block = padded;
+            }
+
+            uint64_t masks[6u + sizeof...(structurals)];
+            _matchBlock<'\n', '"', '\'', '/', '\\', '*', structurals...>(block, masks);
+            uint64_t structuralMask{0u};
+            for (size_t i{6u}; i < std::size(masks); ++i)
+            {
+                structuralMask |= masks[i];
+            }
+            const uint64_t noneMask{structuralMask | masks[1] | masks[2] | masks[3]};
+            const uint64_t doubleStringMask{masks[1] | masks[4] | masks[0]};
+            const uint64_t singleStringMask{masks[2] | masks[4] | masks[0]};
+
+            const size_t blockEnd{blockStart + 64u};
+            const uint64_t startMask{~uint64_t(0u) << (pos - blockStart)};
+
+            // Fast path for the common block of plain double quoted strings, where whether each byte is in a string is
+            // just the parity of the quotes before it
+            if ((state == State::none || state == State::doubleString) && !((masks[2] | masks[3] | masks[4]) & startMask))
+            {
+                const uint64_t quotes{masks[1] & startMask};
+                uint64_t inString{quotes};
+                for (int shift{1}; shift < 64; shift <<= 1)
+                {
+                    inString ^= inString << shift;
+                }
+                if (state == State::doubleString)
+                {
+                    inString = ~inString;
+                }
+                inString &= startMask;
+
+                // Raw newlines in strings are left to the slow path
+                if (!(masks[0] & inString))
+                {
+                    for (uint64_t found{structuralMask & startMask & ~inString & ~quotes}; found; found &= found - 1u)
+                    {
+                        f(blockStart + size_t(std::countr_zero(found)));
+                    }
+                    state = inString >> 63 ? State::doubleString : State::none;
+                    pos = blockEnd;
+                    continue;
+                }
+            }
+
+            while (pos < blockEnd)
+            {
+                uint64_t candidates;
+                switch (state)
+                {
+                    case State::none: candidates = noneMask; break;
+                    case State::doubleString: candidates = doubleStringMask; break;
+                    case State::singleString: candidates = singleStringMask; break;
+                    case State::lineComment: candidates = masks[0]; break;
+                    default: candidates = masks[5]; break;
+                }
+                candidates &= ~uint64_t(0u) << (pos - blockStart);
+                if (!candidates)
+                {
+                    pos = blockEnd;
+                    break;
+                }
+
+                const size_t p{blockStart + size_t(std::countr_zero(candidates))};
+                const char c{data[p]};
+                pos = p + 1u;
+
+                switch (state)
+                {
+                    case State::none:
+                    {
+                        if (c == '"')
+                        {
+                            state = State::doubleString;
+                        }
+                        else if (c == '\'')
+                        {
+                            state = State::singleString;
+                        }
+                        else if (c == '/')
+                        {
+                            if (pos < size && data[pos] == '/')
+                            {
+                                state = State::lineComment;
+                                ++pos;
+                            }
+                            else if (pos < size && data[pos] == '*')
+                            {
+                                state = State::blockComment;
+                                ++pos;
+                            }
+                        }
+                        else
+                        {
+                            f(p);
+                        }
+                        break;
+                    }
+                    case State::doubleString:
+                    case State::singleString:
+                    {
+                        if (c == '\\')
+                        {
+                            // May be a line continuation with `\r\n`
+                            pos += size - pos >= 2u && data[pos] == '\r' && data[pos + 1u] == '\n' ? 2u : 1u;
+                        }
+                        else if (c == '\n')
+                        {
+                            state = State::none;
+                            pos = p;
+                        }
+                        else
+                        {
+                            state = State::none;
+                        }
+                        break;
+                    }
+                    case State::lineComment:
+                    {
+                        // The newline itself may be structural
+                        state = State::none;
+                        pos = p;
+                        break;
+                    }
+                    case State::blockComment:
+                    {
+                        if (pos < size && data[pos] == '/')
+                        {
+                            state = State::none;
+                            ++pos;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    inline size_t _OffsetTable::size() const noexcept
+    {
+        return deltas.size();
+    }
+
+    inline uint64_t _OffsetTable::operator[](const size_t i) const noexcept
+    {
+        const uint32_t delta{deltas[i]};
+        if (delta != UINT32_MAX)
+        {
+            return anchors[i / _indexAnchorInterval] + delta;
+        }
+
+        const auto it{std::lower_bound(far.cbegin(), far.cend(), i, [](const std::pair<uint64_t, uint64_t> & f, const size_t j) { return f.first < j; })};
+        return it->second;
+    }
+
+    inline void _OffsetTable::add(const uint64_t offset)
+    {
+        const size_t i{deltas.size()};
+        if (i % _indexAnchorInterval == 0u)
+        {
+            anchors.push_back(offset);
+        }
+
+        const uint64_t delta{offset - anchors.back()};
+        if (delta < UINT32_MAX)
+        {
+            deltas.push_back(uint32_t(delta));
+        }
+        else
+        {
+            deltas.push_back(UINT32_MAX);
+            far.emplace_back(i, offset);
+        }
+    }
+
+    inline void _OffsetTable::write(std::ostream & file) const
+    {
+        file.write(reinterpret_cast<const char *>(anchors.data()), std::streamsize(anchors.size() * sizeof(uint64_t)));
+        file.write(reinterpret_cast<const char *>(deltas.data()), std::streamsize(deltas.size() * sizeof(uint32_t)));
+        for (const auto & [i, offset] : far)
+        {
+            const uint64_t f[2]{i, offset};
+            file.write(reinterpret_cast<const char *>(f), sizeof(f));
+        }
+    }
+
+    inline void _OffsetTable::read(std::istream & file, const size_t count, const size_t farCount)
+    {
+        anchors.resize((count + _indexAnchorInterval - 1u) / _indexAnchorInterval);
+        deltas.resize(count);
+        far.resize(farCount);
+        file.read(reinterpret_cast<char *>(anchors.data()), std::streamsize(anchors.size() * sizeof(uint64_t)));
+        file.read(reinterpret_cast<char *>(deltas.data()), std::streamsize(deltas.size() * sizeof(uint32_t)));
+        for (auto & [i, offset] : far)
+        {
+            uint64_t f[2];
+            file.read(reinterpret_cast<char *>(f), sizeof(f));
+            i = f[0];
+            offset = f[1];
+        }
+    }
+
+    inline uint64_t _OffsetTable::fileSize(const uint64_t count, const uint64_t farCount) noexcept
+    {
+        const uint64_t anchorCount{(count + _indexAnchorInterval - 1u) / _indexAnchorInterval};
+        return anchorCount * sizeof(uint64_t) + count * sizeof(uint32_t) + farCount * 2u * sizeof(uint64_t);
+    }
+
+    inline string_view _trimIndexSlice(string_view slice) noexcept
+    {
+        while (!slice.empty() && std::isspace(uchar(slice.front())))
+        {
+            slice.remove_prefix(1u);
+        }
+        while (!slice.empty() && std::isspace(uchar(slice.back())))
+        {
+            slice.remove_suffix(1u);
+        }
+        return slice;
+    }
+
+    // Whether the text is only whitespace and comments
+    inline bool _isBlankIndexSlice(string_view slice) noexcept
+    {
+        while (true)
+        {
+            slice = _trimIndexSlice(slice);
+            if (slice.starts_with("//"sv))
+            {
+                const size_t end{slice.find('\n')};
+                slice.remove_prefix(end == string_view::npos ? slice.size() : end);
+            }
+            else if (slice.starts_with("/*"sv))
+            {
+                const size_t end{slice.find("*/"sv, 2u)};
+                if (end == string_view::npos)
+                {
+                    return false;
+                }
+                slice.remove_prefix(end + 2u);
+            }
+            else
+            {
+                return slice.empty();
+            }
+        }
+    }
+
+    // Decodes a key from the text between the delimiter before it and its colon
+    inline std::string _decodeIndexKey([[maybe_unused]] const string_view json, const string_view text)
+    {
+        // Plain double quoted keys are by far the most common
+        const string_view trimmed{_trimIndexSlice(text)};
+        if (trimmed.size() >= 2u && trimmed.front() == '"' && trimmed.back() == '"')
+        {
+            const string_view inner{trimmed.substr(1u, trimmed.size() - 2u)};
+            if (inner.find_first_of("\\\"\n"sv) == string_view::npos)
+            {
+                return std::string{inner};
+            }
+        }
+
+        // Otherwise let the decoder handle escapes, identifiers, and comments
+        struct KeyComposer : DummyComposer<std::string *>
+        {
+            std::string * object(std::string * & outerState) { return outerState; }
+            void key(const string_view key, std::string * & state) { *state = key; }
+        };
+
+        std::string key{};
+        KeyComposer composer{};
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        decode(((std::string{"{"} += text) += "\n:0}"sv), composer, &key);
+        #else
+        try
+        {
+            decode(((std::string{"{"} += text) += "\n:0}"sv), composer, &key);
+        }
+        catch (DecodeError & e)
+        {
+            e.position = std::min(e.position - std::min(e.position, size_t(1u)), text.size()) + size_t(text.data() - json.data());
+            throw;
+        }
+        #endif
+        return key;
+    }
+
+    inline size_t LineIndex::size() const noexcept
+    {
+        return _offsets.size();
+    }
+
+    inline uint64_t LineIndex::sourceSize() const noexcept
+    {
+        return _sourceSize;
+    }
+
+    inline uint64_t LineIndex::offset(const size_t i) const
+    {
+        if (i >= _offsets.size())
+        {
+            _throw<IndexError>("Record index out of range"sv);
+        }
+
+        return _offsets[i];
+    }
+
+    inline string_view LineIndex::record(const string_view ndjson, const size_t i) const
+    {
+        if (ndjson.size() != _sourceSize)
+        {
+            _throw<IndexError>("Input does not match index"sv);
+        }
+
+        const uint64_t start{offset(i)};
+        const uint64_t end{i + 1u < size() ? _offsets[i + 1u] : ndjson.size()};
+        if (start > end || end > ndjson.size())
+        {
+            _throw<IndexError>("Index is corrupt"sv);
+        }
+
+        // Up to the next record is this record's newline and any blank lines, which are trimmed
+        return _trimIndexSlice(ndjson.substr(size_t(start), size_t(end - start)));
+    }
+
+    inline Container ElementIndex::container() const noexcept
+    {
+        return _container;
+    }
+
+    inline size_t ElementIndex::size() const noexcept
+    {
+        return _starts.size();
+    }
+
+    inline uint64_t ElementIndex::sourceSize() const noexcept
+    {
+        return _sourceSize;
+    }
+
+    inline string_view ElementIndex::element(const string_view json, const size_t i) const
+    {
+        if (json.size() != _sourceSize)
+        {
+            _throw<IndexError>("Input does not match index"sv);
+        }
+        if (i >= size())
+        {
+            _throw<IndexError>("Element index out of range"sv);
+        }
+
+        // Array elements end at the comma before the next element, but members of an object are followed by a key
+        const uint64_t start{_starts[i]};
+        const uint64_t end{_container == Container::object ? _ends[i] : i + 1u < size() ? _starts[i + 1u] - 1u : _end};
+        if (start > end || end > json.size())
+        {
+            _throw<IndexError>("Index is corrupt"sv);
+        }
+
+        return _trimIndexSlice(json.substr(size_t(start), size_t(end - start)));
+    }
+
+    inline string_view ElementIndex::key(const size_t i) const
+    {
+        if (_container != Container::object)
+        {
+            _throw<IndexError>("Root is not an object"sv);
+        }
+        if (i >= size())
+        {
+            _throw<IndexError>("Element index out of range"sv);
+        }
+
+        return _keyAt(i);
+    }
+
+    inline size_t ElementIndex::find(const string_view key) const
+    {
+        if (_container != Container::object)
+        {
+            _throw<IndexError>("Root is not an object"sv);
+        }
+
+        const auto it{std::lower_bound(_keyOrder.cbegin(), _keyOrder.cend(), key, [this](const uint64_t i, const string_view k) { return _keyAt(size_t(i)) < k; })};
+        return it != _keyOrder.cend() && _keyAt(size_t(*it)) == key ? size_t(*it) : size();
+    }
+
+    inline string_view ElementIndex::_keyAt(const size_t i) const noexcept
+    {
+        return string_view{_keyChars}.substr(size_t(_keyStarts[i]), size_t(_keyStarts[i + 1u] - _keyStarts[i]));
+    }
+
+    inline void ElementIndex::_sortKeys()
+    {
+        _keyOrder.resize(size());
+        for (size_t i{0u}; i < _keyOrder.size(); ++i)
+        {
+            _keyOrder[i] = i;
+        }
+        std::stable_sort(_keyOrder.begin(), _keyOrder.end(), [this](const uint64_t i, const uint64_t j) { return _keyAt(size_t(i)) < _keyAt(size_t(j)); });
+    }
+
+    inline LineIndex indexLines(const string_view ndjson)
+    {
+        LineIndex index{};
+        index._sourceSize = ndjson.size();
+
+        const char * const begin{ndjson.data()};
+        size_t lineStart{0u};
+
+        const auto endLine{[&](const size_t lineEnd) {
+            if (std::find_if_not(begin + lineStart, begin + lineEnd, [](const char c) { return std::isspace(uchar(c)); }) != begin + lineEnd)
+            {
+                index._offsets.add(lineStart);
+            }
+        }};
+
+        _lexStructure<'\n'>(ndjson, [&](const size_t pos) {
+            endLine(pos);
+            lineStart = pos + 1u;
+        });
+        endLine(ndjson.size());
+
+        return index;
+    }
+
+    inline ElementIndex indexElements(const string_view json)
+    {
+        ElementIndex index{};
+        index._sourceSize = json.size();
+        index._keyStarts.push_back(0u);
+
+        std::string brackets{}; // The open brackets, innermost last
+        size_t elementStart{0u}; // Just past the last delimiter or, for an object, colon
+        size_t keyCount{0u};
+        bool closed{false};
+
+        const auto endElement{[&](const size_t pos, const bool last) {
+            // A dangling comma, or an empty container, leaves nothing after the last delimiter
+            if (last && _isBlankIndexSlice(json.substr(elementStart, pos - elementStart)))
+            {
+                if (keyCount > index._starts.size())
+                {
+                    _throw<IndexError>("Object member has no value"sv);
+                }
+                index._end = index._starts.size() && index._container == Container::array ? elementStart - 1u : pos;
+                return;
+            }
+
+            if (index._container == Container::object && keyCount != index._starts.size() + 1u)
+            {
+                _throw<IndexError>("Object member has no key"sv);
+            }
+            index._starts.add(elementStart);
+            if (index._container == Container::object)
+            {
+                index._ends.add(pos);
+            }
+            index._end = pos;
+        }};
+
+        _lexStructure<'[', ']', '{', '}', ',', ':'>(json, [&](const size_t pos) {
+            if (closed)
+            {
+                _throw<IndexError>("Content after root"sv);
+            }
+
+            const char c{json[pos]};
+            switch (c)
+            {
+                case '[':
+                case '{':
+                {
+                    if (brackets.empty())
+                    {
+                        index._container = c == '[' ? Container::array : Container::object;
+                        elementStart = pos + 1u;
+                    }
+                    brackets.push_back(c);
+                    break;
+                }
+                case ']':
+                case '}':
+                {
+                    if (brackets.empty() || brackets.back() != (c == ']' ? '[' : '{'))
+                    {
+                        _throw<IndexError>("Mismatched brackets"sv);
+                    }
+                    brackets.pop_back();
+                    if (brackets.empty())
+                    {
+                        endElement(pos, true);
+                        closed = true;
+                    }
+                    break;
+                }
+                case ',':
+                {
+                    if (brackets.empty())
+                    {
+                        _throw<IndexError>("Root is not an array or object"sv);
+                    }
+                    if (brackets.size() == 1u)
+                    {
+                        endElement(pos, false);
+                        elementStart = pos + 1u;
+                    }
+                    break;
+                }
+                default: // ':'
+                {
+                    if (brackets.empty())
+                    {
+                        _throw<IndexError>("Root is not an array or object"sv);
+                    }
+                    if (brackets.size() == 1u && index._container == Container::object)
+                    {
+                        if (keyCount != index._starts.size())
+                        {
+                            _throw<IndexError>("Object member has more than one key"sv);
+                        }
+                        index._keyChars += _decodeIndexKey(json, json.substr(elementStart, pos - elementStart));
+                        index._keyStarts.push_back(index._keyChars.size());
+                        ++keyCount;
+                        elementStart = pos + 1u;
+                    }
+                    break;
+                }
+            }
+        });
+
+        if (index._container == Container::none)
+        {
+            _throw<IndexError>("Root is not an array or object"sv);
+        }
+        if (!closed)
+        {
+            _throw<IndexError>("Root is not closed"sv);
+        }
+
+        if (index._container == Container::object)
+        {
+            index._sortKeys();
+        }
+        else
+        {
+            index._keyStarts.clear();
+        }
+
+        return index;
+    }
+
+    inline void _writeIndexHeader(std::ostream & file, const char (& magic)[8], const uint64_t sourceSize, const _OffsetTable & offsets)
+    {
+        _IndexHeader header{};
+        std::memcpy(header.magic, magic, sizeof(header.magic));
+        header.version = _indexVersion;
+        header.byteOrder = _indexByteOrder;
+        header.sourceSize = sourceSize;
+        header.count = offsets.size();
+        header.farCount = offsets.far.size();
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+
+    // Opens the index and checks its header, leaving the file positioned just after it
+    inline std::ifstream _openIndex(const std::filesystem::path & path, const char (& magic)[8], _IndexHeader & header, uint64_t & fileSize)
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file)
+        {
+            _throw<IndexError>("Failed to open index"sv);
+        }
+
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || std::memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+        {
+            _throw<IndexError>("Not an index of this kind"sv);
+        }
+        if (header.version != _indexVersion)
+        {
+            _throw<IndexError>("Unsupported index version"sv);
+        }
+        if (header.byteOrder != _indexByteOrder)
+        {
+            _throw<IndexError>("Index byte order does not match"sv);
+        }
+
+        // Guard against absurd counts before allocating for them
+        std::error_code error{};
+        fileSize = std::filesystem::file_size(path, error);
+        if (error || header.count > fileSize || header.farCount > header.count)
+        {
+            _throw<IndexError>("Index is truncated or corrupt"sv);
+        }
+
+        return file;
+    }
+
+    inline void saveIndex(const LineIndex & index, const std::filesystem::path & path)
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        _writeIndexHeader(file, _lineIndexMagic, index._sourceSize, index._offsets);
+        index._offsets.write(file);
+        file.close();
+
+        if (!file)
+        {
+            _throw<IndexError>("Failed to write index"sv);
+        }
+    }
+
+    inline void saveIndex(const ElementIndex & index, const std::filesystem::path & path)
+    {
+        _ElementIndexHeader elementHeader{};
+        elementHeader.container = uint64_t(index._container);
+        elementHeader.end = index._end;
+        elementHeader.endFarCount = index._ends.far.size();
+        elementHeader.keyCharCount = index._keyChars.size();
+
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        _writeIndexHeader(file, _elementIndexMagic, index._sourceSize, index._starts);
+        file.write(reinterpret_cast<const char *>(&elementHeader), sizeof(elementHeader));
+        index._starts.write(file);
+        index._ends.write(file);
+        file.write(reinterpret_cast<const char *>(index._keyStarts.data()), std::streamsize(index._keyStarts.size() * sizeof(uint64_t)));
+        file.write(index._keyChars.data(), std::streamsize(index._keyChars.size()));
+        file.close();
+
+        if (!file)
+        {
+            _throw<IndexError>("Failed to write index"sv);
+        }
+    }
+
+    inline LineIndex loadLineIndex(const std::filesystem::path & path)
+    {
+        _IndexHeader header;
+        uint64_t fileSize;
+        std::ifstream file{_openIndex(path, _lineIndexMagic, header, fileSize)};
+        if (fileSize != sizeof(header) + _OffsetTable::fileSize(header.count, header.farCount))
+        {
+            _throw<IndexError>("Index is truncated or corrupt"sv);
+        }
+
+        LineIndex index{};
+        index._sourceSize = header.sourceSize;
+        index._offsets.read(file, size_t(header.count), size_t(header.farCount));
+
+        if (!file)
+        {
+            _throw<IndexError>("Index is truncated or corrupt"sv);
+        }
+
+        return index;
+    }
+
+    inline ElementIndex loadElementIndex(const std::filesystem::path & path)
+    {
+        _IndexHeader header;
+        uint64_t fileSize;
+        std::ifstream file{_openIndex(path, _elementIndexMagic, header, fileSize)};
+
+        _ElementIndexHeader elementHeader;
+        if (!file.read(reinterpret_cast<char *>(&elementHeader), sizeof(elementHeader)))
+        {
+            _throw<IndexError>("Index is truncated or corrupt"sv);
+        }
+
+        const bool isObject{elementHeader.container == uint64_t(Container::object)};
+        const uint64_t endCount{isObject ? header.count : 0u};
+        const uint64_t keyStartCount{isObject ? header.count + 1u : 0u};
+        if ((!isObject && elementHeader.container != uint64_t(Container::array)) || elementHeader.endFarCount > endCount || elementHeader.keyCharCount > fileSize ||
+            fileSize != sizeof(header) + sizeof(elementHeader) + _OffsetTable::fileSize(header.count, header.farCount) + _OffsetTable::fileSize(endCount, elementHeader.endFarCount) + keyStartCount * sizeof(uint64_t) + elementHeader.keyCharCount)
+        {
+            _throw<IndexError>("Index is truncated or corrupt"sv);
+        }
+
+        ElementIndex index{};
+        index._sourceSize = header.sourceSize;
+        index._container = Container(elementHeader.container);
+        index._end = elementHeader.end;
+        index._starts.read(file, size_t(header.count), size_t(header.farCount));
+        index._ends.read(file, size_t(endCount), size_t(elementHeader.endFarCount));
+        index._keyStarts.resize(size_t(keyStartCount));
+        file.read(reinterpret_cast<char *>(index._keyStarts.data()), std::streamsize(index._keyStarts.size() * sizeof(uint64_t)));
+        index._keyChars.resize(size_t(elementHeader.keyCharCount));
+        file.read(index._keyChars.data(), std::streamsize(index._keyChars.size()));
+
+        if (!file)
+        {
+            _throw<IndexError>("Index is truncated or corrupt"sv);
+        }
+
+        if (isObject)
+        {
+            // Keys must be in bounds before they can be sorted
+            if (index._keyStarts.front() != 0u || index._keyStarts.back() != index._keyChars.size() || !std::is_sorted(index._keyStarts.cbegin(), index._keyStarts.cend()))
+            {
+                _throw<IndexError>("Index is truncated or corrupt"sv);
+            }
+            index._sortKeys();
+        }
+
+        return index;
+    }
+
+    // Decodes the slice of the input, positioning any error from the start of the whole input
+    template <typename Composer, typename State>
+    inline void _decodeIndexed([[maybe_unused]] const string_view json, const string_view slice, Composer & composer, State & initialState)
+    {
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        decode(slice, composer, initialState);
+        #else
+        try
+        {
+            decode(slice, composer, initialState);
+        }
+        catch (DecodeError & e)
+        {
+            e.position += size_t(slice.data() - json.data());
+            throw;
+        }
+        #endif
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeRecord(const string_view ndjson, const LineIndex & index, const size_t i, Composer & composer, State & initialState)
+    {
+        _decodeIndexed(ndjson, index.record(ndjson, i), composer, initialState);
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeRecord(const string_view ndjson, const LineIndex & index, const size_t i, Composer & composer, State && initialState)
+    {
+        decodeRecord(ndjson, index, i, composer, initialState);
+    }
+
+    inline Value decodeRecord(const string_view ndjson, const LineIndex & index, const size_t i)
+    {
+        Value root{};
+        _Composer::State rootState{&root, Container::none};
+        _Composer composer{};
+        decodeRecord(ndjson, index, i, composer, rootState);
+        return root;
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeElement(const string_view json, const ElementIndex & index, const size_t i, Composer & composer, State & initialState)
+    {
+        _decodeIndexed(json, index.element(json, i), composer, initialState);
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeElement(const string_view json, const ElementIndex & index, const size_t i, Composer & composer, State && initialState)
+    {
+        decodeElement(json, index, i, composer, initialState);
+    }
+
+    inline Value decodeElement(const string_view json, const ElementIndex & index, const size_t i)
+    {
+        Value root{};
+        _Composer::State rootState{&root, Container::none};
+        _Composer composer{};
+        decodeElement(json, index, i, composer, rootState);
+        return root;
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeMember(const string_view json, const ElementIndex & index, const string_view key, Composer & composer, State & initialState)
+    {
+        const size_t i{index.find(key)};
+        if (i >= index.size())
+        {
+            _throw<IndexError>("No member with key"sv);
+        }
+        decodeElement(json, index, i, composer, initialState);
+    }
+
+    template <typename Composer, typename State>
+    inline void decodeMember(const string_view json, const ElementIndex & index, const string_view key, Composer & composer, State && initialState)
+    {
+        decodeMember(json, index, key, composer, initialState);
+    }
+
+    inline Value decodeMember(const string_view json, const ElementIndex & index, const string_view key)
+    {
+        Value root{};
+        _Composer::State rootState{&root, Container::none};
+        _Composer composer{};
+        decodeMember(json, index, key, composer, rootState);
+        return root;
+    }
+}
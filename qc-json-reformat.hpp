@@ -0,0 +1,285 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides reformatting of JSON directly from decoder to encoder, without building a DOM
+///
+/// Uses `qc-json-decode.hpp`, `qc-json-encode.hpp`, and `qc-json-compose.hpp`
+///
+/// See the README for more info and examples!
+///
+
+#include <cmath>
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <qc-json-decode.hpp>
+#include <qc-json-encode.hpp>
+#include <qc-json-compose.hpp>
+
+namespace qc::json
+{
+    ///
+    /// Options for `reformat`
+    ///
+    struct ReformatOptions
+    {
+        /// The density of the output. If unspecified, the original density of each container is preserved at the cost
+        /// of an additional decode pass and one byte of memory per container
+        Density density{Density::unspecified};
+        /// The number of spaces to insert per level of indentation
+        size_t indentSpaces{4u};
+        /// Whether to use `'` instead of `"` for strings
+        bool singleQuotes{false};
+        /// Whether to encode all eligible keys as identifiers instead of strings
+        bool identifiers{false};
+        /// Whether to keep comments
+        bool comments{true};
+        /// Whether to produce strict JSON rather than JSON5. Comments, single quotes, and identifiers are disabled, strings
+        /// use only JSON's escapes, and infinity and NaN are rejected
+        bool strict{false};
+    };
+
+    ///
+    /// A composer which forwards everything directly to an encoder
+    ///
+    /// Example:
+    ///     qc::json::Encoder encoder{qc::json::Density::nospace};
+    ///     qc::json::Reformatter reformatter{encoder};
+    ///     qc::json::decode(jsonStr, reformatter, nullptr);
+    ///     std::string minified{encoder.finish()};
+    ///
+    class Reformatter
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param encoder the encoder to forward to. Must outlive the reformatter
+        /// @param comments whether to forward comments
+        /// @param densities the density of each container in the order they begin. If empty, all containers are
+        ///     started with unspecified density and so inherit that of the encoder
+        ///
+        explicit Reformatter(Encoder & encoder, bool comments = true, std::vector<Density> densities = {}) noexcept;
+
+        std::nullptr_t object(std::nullptr_t & outerState);
+        std::nullptr_t array(std::nullptr_t & outerState);
+        void end(Density density, std::nullptr_t && innerState, std::nullptr_t & outerState);
+        void key(string_view key, std::nullptr_t & state);
+        void val(string_view val, std::nullptr_t & state);
+        void val(int64_t val, std::nullptr_t & state);
+        void val(uint64_t val, std::nullptr_t & state);
+        void val(double val, std::nullptr_t & state);
+        void val(bool val, std::nullptr_t & state);
+        void val(std::nullptr_t, std::nullptr_t & state);
+        void comment(string_view comment, std::nullptr_t & state);
+
+        private: //-------------------------------------------------------------
+
+        Encoder & _encoder;
+        bool _comments;
+        std::vector<Density> _densities;
+        size_t _containerCount{0u};
+
+        Density _nextDensity() noexcept;
+    };
+
+    ///
+    /// Reformats the JSON string without building a DOM
+    ///
+    /// @param json the JSON string to reformat
+    /// @param options the formatting options
+    /// @return the reformatted JSON string
+    /// @throw `DecodeError` if the JSON string is invalid, or, in strict mode, contains infinity or NaN
+    /// @throw `EncodeError` if a comment cannot be encoded
+    ///
+    string reformat(string_view json, const ReformatOptions & options = {});
+
+    ///
+    /// Reformats the JSON string without building a DOM, streaming the output to the sink
+    ///
+    /// Memory usage is constant with respect to the size of the JSON other than one byte per container when preserving
+    /// density
+    ///
+    /// @param json the JSON string to reformat
+    /// @param sink the sink to write the reformatted JSON to
+    /// @param options the formatting options
+    /// @throw `DecodeError` if the JSON string is invalid, or, in strict mode, contains infinity or NaN
+    /// @throw `EncodeError` if a comment cannot be encoded
+    ///
+    void reformat(string_view json, Sink & sink, const ReformatOptions & options = {});
+
+    ///
+    /// Shorthand for `reformat` with `nospace` density and no comments
+    ///
+    string minify(string_view json);
+
+    ///
+    /// Shorthand for `reformat` with `multiline` density
+    ///
+    string prettify(string_view json, size_t indentSpaces = 4u);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    inline Reformatter::Reformatter(Encoder & encoder, const bool comments, std::vector<Density> densities) noexcept :
+        _encoder{encoder},
+        _comments{comments},
+        _densities{std::move(densities)}
+    {}
+
+    inline std::nullptr_t Reformatter::object(std::nullptr_t & /*outerState*/)
+    {
+        _encoder << tokens::object(_nextDensity());
+        return nullptr;
+    }
+
+    inline std::nullptr_t Reformatter::array(std::nullptr_t & /*outerState*/)
+    {
+        _encoder << tokens::array(_nextDensity());
+        return nullptr;
+    }
+
+    inline void Reformatter::end(const Density /*density*/, std::nullptr_t && /*innerState*/, std::nullptr_t & /*outerState*/)
+    {
+        _encoder << tokens::end;
+    }
+
+    inline void Reformatter::key(const string_view key, std::nullptr_t & /*state*/)
+    {
+        _encoder << key;
+    }
+
+    inline void Reformatter::val(const string_view val, std::nullptr_t & /*state*/)
+    {
+        _encoder << val;
+    }
+
+    inline void Reformatter::val(const int64_t val, std::nullptr_t & /*state*/)
+    {
+        _encoder << val;
+    }
+
+    inline void Reformatter::val(const uint64_t val, std::nullptr_t & /*state*/)
+    {
+        _encoder << val;
+    }
+
+    inline void Reformatter::val(const double val, std::nullptr_t & /*state*/)
+    {
+        _encoder << val;
+    }
+
+    inline void Reformatter::val(const bool val, std::nullptr_t & /*state*/)
+    {
+        _encoder << val;
+    }
+
+    inline void Reformatter::val(const std::nullptr_t, std::nullptr_t & /*state*/)
+    {
+        _encoder << nullptr;
+    }
+
+    inline void Reformatter::comment(const string_view comment, std::nullptr_t & /*state*/)
+    {
+        if (_comments)
+        {
+            _encoder << tokens::comment(comment);
+        }
+    }
+
+    inline Density Reformatter::_nextDensity() noexcept
+    {
+        return _containerCount < _densities.size() ? _densities[_containerCount++] : Density::unspecified;
+    }
+
+    // Records the density of each container in the order they begin
+    class _DensityComposer : public DummyComposer<size_t>
+    {
+        public: //--------------------------------------------------------------
+
+        std::vector<Density> densities{};
+
+        size_t object(size_t & /*outerState*/)
+        {
+            densities.push_back(Density::unspecified);
+            return densities.size() - 1u;
+        }
+
+        size_t array(size_t & /*outerState*/)
+        {
+            densities.push_back(Density::unspecified);
+            return densities.size() - 1u;
+        }
+
+        void end(const Density density, size_t && innerState, size_t & /*outerState*/)
+        {
+            densities[innerState] = density;
+        }
+    };
+
+    inline void _reformat(const string_view json, Encoder & encoder, const ReformatOptions & options)
+    {
+        std::vector<Density> densities{};
+        if (options.density == Density::unspecified)
+        {
+            _DensityComposer densityComposer{};
+            decode(json, densityComposer, size_t{0u});
+            densities = std::move(densityComposer.densities);
+        }
+
+        Reformatter reformatter{encoder, options.comments && !options.strict, std::move(densities)};
+
+        if (options.strict)
+        {
+            Map map{reformatter, [](const std::same_as<double> auto val) {
+                if (!std::isfinite(val))
+                {
+                    _throw<ComposeError>("Infinity and NaN are not valid strict JSON"sv);
+                }
+                return val;
+            }};
+            decode(json, map, nullptr);
+        }
+        else
+        {
+            decode(json, reformatter, nullptr);
+        }
+    }
+
+    inline string reformat(const string_view json, const ReformatOptions & options)
+    {
+        Encoder encoder{options.density, options.indentSpaces, options.singleQuotes, options.identifiers, false, options.strict};
+        _reformat(json, encoder, options);
+        return encoder.finish();
+    }
+
+    inline void reformat(const string_view json, Sink & sink, const ReformatOptions & options)
+    {
+        Encoder encoder{options.density, options.indentSpaces, options.singleQuotes, options.identifiers, false, options.strict};
+        encoder.setSink(&sink);
+        _reformat(json, encoder, options);
+        encoder.finish();
+    }
+
+    inline string minify(const string_view json)
+    {
+        return reformat(json, ReformatOptions{.density = Density::nospace, .comments = false});
+    }
+
+    inline string prettify(const string_view json, const size_t indentSpaces)
+    {
+        return reformat(json, ReformatOptions{.density = Density::multiline, .indentSpaces = indentSpaces});
+    }
+}
@@ -0,0 +1,600 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides streaming validation against a subset of JSON Schema
+///
+/// Uses `qc-json.hpp` to represent schema documents and `qc-json-hash.hpp` to match enum values
+///
+/// See the README for more info and examples!
+///
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <qc-json.hpp>
+#include <qc-json-hash.hpp>
+
+namespace qc::json
+{
+    ///
+    /// This will be thrown if a schema document is invalid or uses unsupported features
+    ///
+    struct SchemaError : Error
+    {
+        explicit SchemaError(string_view msg) noexcept;
+    };
+
+    ///
+    /// This will be thrown from decoding when the JSON violates the schema. The position is just past the offending
+    /// element
+    ///
+    struct ValidationError : ComposeError
+    {
+        explicit ValidationError(string_view msg) noexcept;
+    };
+
+    // A numeric bound kept as the kind of number it was written as, so that integers compare exactly
+    struct _SchemaBound
+    {
+        Type type{Type::null}; // Null if there is no bound
+        int64_t integer{};
+        uint64_t unsigner{};
+        double floater{};
+    };
+
+    ///
+    /// A schema document compiled for fast validation
+    ///
+    /// The following subset of JSON Schema is supported:
+    /// - `type`, as a string or array of strings
+    /// - `enum`, with scalar values only. Numbers match regardless of representation
+    /// - `minimum`, `maximum`, `exclusiveMinimum`, and `exclusiveMaximum`, as numbers. Integers are compared exactly
+    /// - `minLength` and `maxLength`, counted in UTF-8 code points
+    /// - `minItems`, `maxItems`, and `items`, as a single schema
+    /// - `properties`, `required`, and `additionalProperties`, as a boolean or schema
+    ///
+    /// Unrecognized keywords such as `$schema`, `title`, and `description` are ignored. `true` and `false` are valid
+    /// schemas that accept everything and nothing respectively
+    ///
+    class Schema
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @param schema the schema document
+        /// @throw `SchemaError` if the schema document is invalid or unsupported
+        ///
+        explicit Schema(const Value & schema);
+
+        private: //-------------------------------------------------------------
+
+        friend class Validator;
+
+        enum _TypeFlags : uint8_t
+        {
+            _objectFlag  = 0b0000'0001u,
+            _arrayFlag   = 0b0000'0010u,
+            _stringFlag  = 0b0000'0100u,
+            _integerFlag = 0b0000'1000u,
+            _numberFlag  = 0b0001'0000u,
+            _booleanFlag = 0b0010'0000u,
+            _nullFlag    = 0b0100'0000u,
+            _anyFlags    = 0b0111'1111u
+        };
+
+        struct _Property
+        {
+            size_t node;
+            size_t requiredIndex;
+        };
+
+        struct _Node
+        {
+            uint8_t types{_anyFlags};
+            _SchemaBound minimum{};
+            _SchemaBound maximum{};
+            _SchemaBound exclusiveMinimum{};
+            _SchemaBound exclusiveMaximum{};
+            size_t minLength{0u};
+            size_t maxLength{~size_t{0u}};
+            size_t minItems{0u};
+            size_t maxItems{~size_t{0u}};
+            std::vector<Digest> enumDigests{}; // Sorted
+            std::unordered_map<string, _Property> properties{};
+            std::vector<string> required{};
+            size_t items{_anyNode};
+            size_t additionalProperties{_anyNode};
+        };
+
+        static constexpr size_t _anyNode{0u};
+        static constexpr size_t _noneNode{1u};
+        static constexpr size_t _noRequiredIndex{~size_t{0u}};
+
+        std::vector<_Node> _nodes{};
+        size_t _root{_anyNode};
+
+        size_t _compile(const Value & schema);
+    };
+
+    ///
+    /// A composer that validates JSON against a schema as it is decoded. No DOM is built
+    ///
+    /// Validation fails fast, throwing a `ValidationError` from `decode` on the first violation
+    ///
+    /// Example:
+    ///     qc::json::Validator validator{schema};
+    ///     qc::json::decode(jsonStr, validator, qc::json::Validator::State{});
+    ///
+    class Validator
+    {
+        public: //--------------------------------------------------------------
+
+        struct State
+        {
+            Container container{Container::none};
+            size_t node{~size_t{0u}}; // Schema of the container
+            size_t child{~size_t{0u}}; // Schema of the next element
+            size_t count{0u};
+            std::vector<bool> requiredFound{};
+        };
+
+        ///
+        /// @param schema the schema to validate against. Must outlive the validator
+        ///
+        explicit Validator(const Schema & schema) noexcept;
+
+        State object(State & outerState);
+        State array(State & outerState);
+        void end(Density density, State && innerState, State & outerState);
+        void key(string_view key, State & state);
+        void val(string_view val, State & state);
+        void val(int64_t val, State & state);
+        void val(uint64_t val, State & state);
+        void val(double val, State & state);
+        void val(bool val, State & state);
+        void val(std::nullptr_t, State & state);
+        void comment(string_view comment, State & state);
+
+        private: //-------------------------------------------------------------
+
+        const Schema & _schema;
+
+        const Schema::_Node & _childNode(const State & state) const;
+
+        void _checkType(const Schema::_Node & node, uint8_t typeFlags) const;
+
+        void _checkEnum(const Schema::_Node & node, const Digest & digest) const;
+
+        template <typename T> void _checkNumber(const Schema::_Node & node, T val) const;
+
+        template <typename T> void _scalar(T val, State & state);
+    };
+
+    ///
+    /// Validates the JSON string against the schema without building a DOM
+    ///
+    /// @param json the JSON string to validate
+    /// @param schema the schema to validate against
+    /// @throw `ValidationError` on the first violation of the schema
+    /// @throw `DecodeError` if the JSON string is otherwise invalid
+    ///
+    void validate(string_view json, const Schema & schema);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    inline SchemaError::SchemaError(const string_view msg) noexcept :
+        Error{msg}
+    {}
+
+    inline ValidationError::ValidationError(const string_view msg) noexcept :
+        ComposeError{msg}
+    {}
+
+    // Uses the same number normalization as `FingerprintComposer`, so that e.g. `1` matches `1.0`
+    template <typename T>
+    inline Digest _scalarFingerprint(const T val)
+    {
+        FingerprintComposer fingerprinter{};
+        FingerprintComposer::State root{};
+        fingerprinter.val(val, root);
+        return fingerprinter.digest();
+    }
+
+    inline Digest _scalarFingerprint(const Value & val)
+    {
+        switch (val.type())
+        {
+            case Type::string: return _scalarFingerprint(string_view{val.asString<unsafe>()});
+            case Type::integer: return _scalarFingerprint(val.asInteger<unsafe>());
+            case Type::unsigner: return _scalarFingerprint(val.asUnsigner<unsafe>());
+            case Type::floater: return _scalarFingerprint(val.asFloater<unsafe>());
+            case Type::boolean: return _scalarFingerprint(val.asBoolean<unsafe>());
+            default: return _scalarFingerprint(nullptr);
+        }
+    }
+
+    inline Schema::Schema(const Value & schema)
+    {
+        // The first two nodes are always the trivial `true` and `false` schemas
+        _nodes.emplace_back();
+        _nodes.emplace_back().types = 0u;
+        _root = _compile(schema);
+    }
+
+    inline size_t Schema::_compile(const Value & schema)
+    {
+        if (schema.isBoolean())
+        {
+            return schema.asBoolean<unsafe>() ? _anyNode : _noneNode;
+        }
+        if (!schema.isObject())
+        {
+            _throw<SchemaError>("Schema must be an object or boolean"sv);
+        }
+
+        const size_t nodeI{_nodes.size()};
+        _nodes.emplace_back();
+        _Node node{};
+
+        const auto typeFlag{[](const Value & type) -> uint8_t {
+            if (!type.isString()) _throw<SchemaError>("Type must be a string"sv);
+            const string_view str{type.asString<unsafe>()};
+            if (str == "object"sv) return _objectFlag;
+            if (str == "array"sv) return _arrayFlag;
+            if (str == "string"sv) return _stringFlag;
+            if (str == "integer"sv) return _integerFlag;
+            if (str == "number"sv) return _numberFlag | _integerFlag;
+            if (str == "boolean"sv) return _booleanFlag;
+            if (str == "null"sv) return _nullFlag;
+            _throw<SchemaError>(("Unknown type `"s += str) += '`');
+        }};
+
+        const auto count{[](const Value & val) -> size_t {
+            if (!val.is<size_t>()) _throw<SchemaError>("Expected non-negative integer"sv);
+            return val.get<size_t>();
+        }};
+
+        const auto bound{[](const Value & val) -> _SchemaBound {
+            if (!val.isNumber()) _throw<SchemaError>("Expected number"sv);
+            _SchemaBound bound{.type = val.type()};
+            if (val.isInteger()) bound.integer = val.asInteger<unsafe>();
+            else if (val.isUnsigner()) bound.unsigner = val.asUnsigner<unsafe>();
+            else bound.floater = val.asFloater<unsafe>();
+            return bound;
+        }};
+
+        for (const auto & [keyword, val] : schema.asObject<unsafe>())
+        {
+            if (keyword == "type"sv)
+            {
+                if (val.isArray())
+                {
+                    node.types = 0u;
+                    for (const Value & type : val.asArray<unsafe>()) node.types |= typeFlag(type);
+                }
+                else
+                {
+                    node.types = typeFlag(val);
+                }
+            }
+            else if (keyword == "enum"sv)
+            {
+                if (!val.isArray()) _throw<SchemaError>("Enum must be an array"sv);
+                for (const Value & option : val.asArray<unsafe>())
+                {
+                    if (option.isObject() || option.isArray()) _throw<SchemaError>("Enum values must be scalars"sv);
+                    node.enumDigests.push_back(_scalarFingerprint(option));
+                }
+                std::sort(node.enumDigests.begin(), node.enumDigests.end(), [](const Digest & a, const Digest & b) { return a.low < b.low || (a.low == b.low && a.high < b.high); });
+            }
+            else if (keyword == "minimum"sv) node.minimum = bound(val);
+            else if (keyword == "maximum"sv) node.maximum = bound(val);
+            else if (keyword == "exclusiveMinimum"sv) node.exclusiveMinimum = bound(val);
+            else if (keyword == "exclusiveMaximum"sv) node.exclusiveMaximum = bound(val);
+            else if (keyword == "minLength"sv) node.minLength = count(val);
+            else if (keyword == "maxLength"sv) node.maxLength = count(val);
+            else if (keyword == "minItems"sv) node.minItems = count(val);
+            else if (keyword == "maxItems"sv) node.maxItems = count(val);
+            else if (keyword == "items"sv) node.items = _compile(val);
+            else if (keyword == "additionalProperties"sv) node.additionalProperties = _compile(val);
+            else if (keyword == "properties"sv)
+            {
+                if (!val.isObject()) _throw<SchemaError>("Properties must be an object"sv);
+                for (const auto & [name, propertySchema] : val.asObject<unsafe>())
+                {
+                    const size_t propertyNode{_compile(propertySchema)};
+                    node.properties[name] = _Property{propertyNode, _noRequiredIndex};
+                }
+            }
+            else if (keyword == "required"sv)
+            {
+                if (!val.isArray()) _throw<SchemaError>("Required must be an array"sv);
+                for (const Value & name : val.asArray<unsafe>())
+                {
+                    if (!name.isString()) _throw<SchemaError>("Required property names must be strings"sv);
+                    node.required.push_back(name.asString<unsafe>());
+                }
+            }
+        }
+
+        // Properties that are required but not otherwise described fall back to `additionalProperties`
+        std::vector<string> required{std::move(node.required)};
+        node.required.clear();
+        for (string & name : required)
+        {
+            _Property & property{node.properties.try_emplace(name, _Property{node.additionalProperties, _noRequiredIndex}).first->second};
+            if (property.requiredIndex == _noRequiredIndex)
+            {
+                property.requiredIndex = node.required.size();
+                node.required.push_back(std::move(name));
+            }
+        }
+
+        _nodes[nodeI] = std::move(node);
+        return nodeI;
+    }
+
+    inline Validator::Validator(const Schema & schema) noexcept :
+        _schema{schema}
+    {}
+
+    inline Validator::State Validator::object(State & outerState)
+    {
+        const Schema::_Node & node{_childNode(outerState)};
+        _checkType(node, Schema::_objectFlag);
+        return State{Container::object, size_t(&node - _schema._nodes.data()), Schema::_anyNode, 0u, std::vector<bool>(node.required.size())};
+    }
+
+    inline Validator::State Validator::array(State & outerState)
+    {
+        const Schema::_Node & node{_childNode(outerState)};
+        _checkType(node, Schema::_arrayFlag);
+        return State{Container::array, size_t(&node - _schema._nodes.data()), node.items};
+    }
+
+    inline void Validator::end(const Density /*density*/, State && innerState, State & outerState)
+    {
+        const Schema::_Node & node{_schema._nodes[innerState.node]};
+
+        for (size_t i{0u}; i < innerState.requiredFound.size(); ++i)
+        {
+            if (!innerState.requiredFound[i])
+            {
+                _throw<ValidationError>(("Missing required property `"s += node.required[i]) += '`');
+            }
+        }
+
+        if (innerState.container == Container::array)
+        {
+            if (innerState.count < node.minItems) _throw<ValidationError>("Too few items"sv);
+            if (innerState.count > node.maxItems) _throw<ValidationError>("Too many items"sv);
+        }
+
+        ++outerState.count;
+    }
+
+    inline void Validator::key(const string_view key, State & state)
+    {
+        const Schema::_Node & node{_schema._nodes[state.node]};
+
+        const auto it{node.properties.find(string{key})};
+        if (it != node.properties.end())
+        {
+            state.child = it->second.node;
+            if (it->second.requiredIndex != Schema::_noRequiredIndex)
+            {
+                state.requiredFound[it->second.requiredIndex] = true;
+            }
+        }
+        else if (node.additionalProperties == Schema::_noneNode)
+        {
+            _throw<ValidationError>(("Unexpected property `"s += key) += '`');
+        }
+        else
+        {
+            state.child = node.additionalProperties;
+        }
+    }
+
+    inline void Validator::val(const string_view val, State & state)
+    {
+        const Schema::_Node & node{_childNode(state)};
+        _checkType(node, Schema::_stringFlag);
+
+        if (node.minLength || node.maxLength != ~size_t{0u})
+        {
+            // Count UTF-8 code points by skipping continuation bytes
+            const size_t length{size_t(std::count_if(val.begin(), val.end(), [](const char c) { return (uchar(c) & 0b1100'0000u) != 0b1000'0000u; }))};
+            if (length < node.minLength) _throw<ValidationError>("String is too short"sv);
+            if (length > node.maxLength) _throw<ValidationError>("String is too long"sv);
+        }
+
+        if (!node.enumDigests.empty())
+        {
+            _checkEnum(node, _scalarFingerprint(val));
+        }
+
+        ++state.count;
+    }
+
+    inline void Validator::val(const int64_t val, State & state)
+    {
+        _scalar(val, state);
+    }
+
+    inline void Validator::val(const uint64_t val, State & state)
+    {
+        _scalar(val, state);
+    }
+
+    inline void Validator::val(const double val, State & state)
+    {
+        _scalar(val, state);
+    }
+
+    inline void Validator::val(const bool val, State & state)
+    {
+        _scalar(val, state);
+    }
+
+    inline void Validator::val(const std::nullptr_t, State & state)
+    {
+        _scalar(nullptr, state);
+    }
+
+    inline void Validator::comment(const string_view /*comment*/, State & /*state*/)
+    {}
+
+    inline const Schema::_Node & Validator::_childNode(const State & state) const
+    {
+        return _schema._nodes[state.container == Container::none ? _schema._root : state.child];
+    }
+
+    inline void Validator::_checkType(const Schema::_Node & node, const uint8_t typeFlags) const
+    {
+        if (!(node.types & typeFlags))
+        {
+            static constexpr string_view typeNames[7u]{"object"sv, "array"sv, "string"sv, "integer"sv, "number"sv, "boolean"sv, "null"sv};
+
+            if (!node.types)
+            {
+                _throw<ValidationError>("No value is allowed here"sv);
+            }
+
+            string msg{"Expected "};
+            bool first{true};
+            for (size_t i{0u}; i < 7u; ++i)
+            {
+                // `number` implies `integer`
+                if ((node.types & (1u << i)) && !(i == 3u && (node.types & Schema::_numberFlag)))
+                {
+                    if (!first) msg += " or "sv;
+                    msg += typeNames[i];
+                    first = false;
+                }
+            }
+            _throw<ValidationError>(msg);
+        }
+    }
+
+    inline void Validator::_checkEnum(const Schema::_Node & node, const Digest & digest) const
+    {
+        if (!std::binary_search(node.enumDigests.begin(), node.enumDigests.end(), digest, [](const Digest & a, const Digest & b) { return a.low < b.low || (a.low == b.low && a.high < b.high); }))
+        {
+            _throw<ValidationError>("Value is not one of the enumerated options"sv);
+        }
+    }
+
+    // Exact comparison of an integer with a floater, without rounding the integer
+    template <typename T>
+    inline std::partial_ordering _compareNumbers(const T val, const double floater) noexcept
+    {
+        // Bounds of `T` as exact powers of two
+        constexpr double lower{std::is_signed_v<T> ? -9223372036854775808.0 : 0.0};
+        constexpr double upper{std::is_signed_v<T> ? 9223372036854775808.0 : 18446744073709551616.0};
+
+        if (std::isnan(floater)) return std::partial_ordering::unordered;
+        if (floater < lower) return std::partial_ordering::greater;
+        if (floater >= upper) return std::partial_ordering::less;
+
+        // The whole part is now exactly representable as `T`
+        const double whole{std::trunc(floater)};
+        const T wholeVal{T(whole)};
+        if (val != wholeVal) return val < wholeVal ? std::partial_ordering::less : std::partial_ordering::greater;
+        return whole < floater ? std::partial_ordering::less : whole > floater ? std::partial_ordering::greater : std::partial_ordering::equivalent;
+    }
+
+    template <typename T>
+    inline std::partial_ordering _compareNumbers(const T val, const _SchemaBound & bound) noexcept
+    {
+        if constexpr (std::is_same_v<T, double>)
+        {
+            switch (bound.type)
+            {
+                case Type::integer: return 0 <=> _compareNumbers(bound.integer, val);
+                case Type::unsigner: return 0 <=> _compareNumbers(bound.unsigner, val);
+                default: return val <=> bound.floater;
+            }
+        }
+        else
+        {
+            switch (bound.type)
+            {
+                case Type::integer:
+                    if constexpr (std::is_signed_v<T>) return val <=> bound.integer;
+                    else return bound.integer < 0 ? std::partial_ordering::greater : val <=> uint64_t(bound.integer);
+                case Type::unsigner:
+                    if constexpr (std::is_signed_v<T>) return val < 0 ? std::partial_ordering::less : uint64_t(val) <=> bound.unsigner;
+                    else return val <=> bound.unsigner;
+                default: return _compareNumbers(val, bound.floater);
+            }
+        }
+    }
+
+    template <typename T>
+    inline void Validator::_checkNumber(const Schema::_Node & node, const T val) const
+    {
+        if ((node.minimum.type != Type::null && _compareNumbers(val, node.minimum) < 0) || (node.exclusiveMinimum.type != Type::null && _compareNumbers(val, node.exclusiveMinimum) <= 0))
+        {
+            _throw<ValidationError>("Number is too small"sv);
+        }
+        if ((node.maximum.type != Type::null && _compareNumbers(val, node.maximum) > 0) || (node.exclusiveMaximum.type != Type::null && _compareNumbers(val, node.exclusiveMaximum) >= 0))
+        {
+            _throw<ValidationError>("Number is too large"sv);
+        }
+    }
+
+    template <typename T>
+    inline void Validator::_scalar(const T val, State & state)
+    {
+        const Schema::_Node & node{_childNode(state)};
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            _checkType(node, Schema::_booleanFlag);
+        }
+        else if constexpr (std::is_same_v<T, std::nullptr_t>)
+        {
+            _checkType(node, Schema::_nullFlag);
+        }
+        else if constexpr (std::is_same_v<T, double>)
+        {
+            _checkType(node, std::isfinite(val) && std::trunc(val) == val ? Schema::_integerFlag : Schema::_numberFlag);
+            _checkNumber(node, val);
+        }
+        else
+        {
+            _checkType(node, Schema::_integerFlag);
+            _checkNumber(node, val);
+        }
+
+        if (!node.enumDigests.empty())
+        {
+            _checkEnum(node, _scalarFingerprint(val));
+        }
+
+        ++state.count;
+    }
+
+    inline void validate(const string_view json, const Schema & schema)
+    {
+        Validator validator{schema};
+        decode(json, validator, Validator::State{});
+    }
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides a binary snapshot format for DOM values that is memory mapped and read in place
+///
+/// Uses `qc-json.hpp` for the values being saved and `qc-json-static.hpp` to view them once loaded
+///
+/// See the README for more info and examples!
+///
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <qc-json.hpp>
+#include <qc-json-static.hpp>
+
+namespace qc::json
+{
+    ///
+    /// This will be thrown if a snapshot cannot be saved or loaded, or is not a valid snapshot
+    ///
+    struct SnapshotError : Error
+    {
+        explicit SnapshotError(string_view msg) noexcept;
+    };
+
+    ///
+    /// A loaded snapshot, which keeps the file mapped into memory for as long as it lives
+    ///
+    class Snapshot
+    {
+        public: //--------------------------------------------------------------
+
+        Snapshot(const Snapshot &) = delete;
+
+        ///
+        /// Move constructor
+        ///
+        /// @param other is left empty, and must not be accessed
+        ///
+        Snapshot(Snapshot && other) noexcept;
+
+        Snapshot & operator=(const Snapshot &) = delete;
+
+        ///
+        /// Move assignment operator
+        ///
+        /// @param other is left empty, and must not be accessed
+        /// @return this
+        ///
+        Snapshot & operator=(Snapshot && other) noexcept;
+
+        ///
+        /// Unmaps the file. Any values or strings viewed from the snapshot are invalidated
+        ///
+        ~Snapshot() noexcept;
+
+        ///
+        /// @return a read-only view of the root value, valid for as long as the snapshot lives
+        ///
+        StaticValue root() const noexcept;
+
+        ///
+        /// @return the size of the snapshot file in bytes
+        ///
+        size_t size() const noexcept;
+
+        private: //-------------------------------------------------------------
+
+        const char * _data{nullptr};
+        size_t _size{0u};
+
+        Snapshot(const char * data, size_t size) noexcept;
+
+        friend Snapshot loadSnapshot(const std::filesystem::path & path);
+    };
+
+    ///
+    /// Saves the value to a snapshot file
+    ///
+    /// The snapshot is a flat array of nodes followed by a table of string characters, all referring to each other by
+    /// index rather than by pointer, so it can be used in place wherever it is mapped. Identical strings, such as the
+    /// keys repeated in every record of a dataset, are stored once. Comments and densities are not saved
+    ///
+    /// Snapshots are portable between platforms of the same endianness
+    ///
+    /// @param val the value to save
+    /// @param path the file to write, which is replaced if it exists
+    /// @throw `SnapshotError` if the file cannot be written or the value has more than 2^32 nodes or characters
+    ///
+    void saveSnapshot(const Value & val, const std::filesystem::path & path);
+
+    ///
+    /// Maps a snapshot file into memory, such that its values may be read in place with no decoding
+    ///
+    /// Only the header is validated. The file must be a trusted snapshot written by `saveSnapshot`
+    ///
+    /// @param path the snapshot file
+    /// @return the loaded snapshot
+    /// @throw `SnapshotError` if the file cannot be mapped or is not a compatible snapshot
+    ///
+    Snapshot loadSnapshot(const std::filesystem::path & path);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    // The nodes are written verbatim, so their layout must be the same everywhere
+    static_assert(sizeof(_StaticNode) == 24u && offsetof(_StaticNode, size) == 4u && offsetof(_StaticNode, bits) == 16u);
+
+    struct _SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder; // `0x01020304` as written, to detect a mismatch
+        uint64_t nodeCount;
+        uint64_t charCount;
+    };
+
+    inline constexpr char _snapshotMagic[8]{'Q', 'C', 'J', 'S', 'N', 'A', 'P', '\0'};
+    inline constexpr uint32_t _snapshotVersion{1u};
+    inline constexpr uint32_t _snapshotByteOrder{0x01020304u};
+
+    inline SnapshotError::SnapshotError(const string_view msg) noexcept :
+        Error{msg}
+    {}
+
+    inline Snapshot::Snapshot(const char * const data, const size_t size) noexcept :
+        _data{data},
+        _size{size}
+    {}
+
+    inline Snapshot::Snapshot(Snapshot && other) noexcept :
+        _data{std::exchange(other._data, nullptr)},
+        _size{std::exchange(other._size, 0u)}
+    {}
+
+    inline Snapshot & Snapshot::operator=(Snapshot && other) noexcept
+    {
+        // The previous mapping is released along with `old`
+        Snapshot old{std::move(other)};
+        std::swap(_data, old._data);
+        std::swap(_size, old._size);
+        return *this;
+    }
+
+    inline Snapshot::~Snapshot() noexcept
+    {
+        if (_data)
+        {
+            #ifdef _WIN32
+                UnmapViewOfFile(_data);
+            #else
+                munmap(const_cast<char *>(_data), _size);
+            #endif
+            _data = nullptr;
+        }
+    }
+
+    inline StaticValue Snapshot::root() const noexcept
+    {
+        const _SnapshotHeader * const header{reinterpret_cast<const _SnapshotHeader *>(_data)};
+        const _StaticNode * const nodes{reinterpret_cast<const _StaticNode *>(_data + sizeof(_SnapshotHeader))};
+        const char * const chars{reinterpret_cast<const char *>(nodes + header->nodeCount)};
+        return StaticValue{nodes, chars, 0u};
+    }
+
+    inline size_t Snapshot::size() const noexcept
+    {
+        return _size;
+    }
+
+    // Flattens values breadth first such that the children of each container are contiguous
+    class _SnapshotWriter
+    {
+        public: //--------------------------------------------------------------
+
+        std::vector<_StaticNode> nodes{};
+        string chars{};
+
+        explicit _SnapshotWriter(const Value & root)
+        {
+            _push(root);
+
+            for (size_t q{0u}; q < _queue.size(); ++q)
+            {
+                const _Pending pending{_queue[q]};
+                nodes[pending.node].index = _count(nodes.size(), "nodes"sv);
+
+                if (pending.val->isObject())
+                {
+                    for (const auto & [key, member] : pending.val->asObject())
+                    {
+                        nodes.push_back(_stringNode(key));
+                        _push(member);
+                    }
+                }
+                else
+                {
+                    for (const Value & element : pending.val->asArray())
+                    {
+                        _push(element);
+                    }
+                }
+            }
+
+            _count(nodes.size(), "nodes"sv);
+        }
+
+        private: //-------------------------------------------------------------
+
+        struct _Pending
+        {
+            size_t node;
+            const Value * val;
+        };
+
+        std::vector<_Pending> _queue{};
+        std::unordered_map<string_view, uint32_t> _strings{}; // Views of the source strings, which outlive this
+
+        static uint32_t _count(const size_t n, const string_view what)
+        {
+            if (n > UINT32_MAX)
+            {
+                _throw<SnapshotError>(("Too many "s += what) += " for snapshot"sv);
+            }
+            return uint32_t(n);
+        }
+
+        void _push(const Value & val)
+        {
+            if (val.isObject() || val.isArray())
+            {
+                _queue.push_back(_Pending{nodes.size(), &val});
+            }
+            nodes.push_back(_node(val));
+        }
+
+        _StaticNode _stringNode(const string_view str)
+        {
+            const auto [it, inserted]{_strings.try_emplace(str, uint32_t(0u))};
+            if (inserted)
+            {
+                it->second = _count(chars.size(), "characters"sv);
+                chars += str;
+                _count(chars.size(), "characters"sv);
+            }
+            return _StaticNode{.type = Type::string, .size = uint32_t(str.size()), .index = it->second};
+        }
+
+        _StaticNode _node(const Value & val)
+        {
+            switch (val.type())
+            {
+                case Type::object: return _StaticNode{.type = Type::object, .sorted = true, .size = _count(val.asObject().size(), "members"sv)};
+                case Type::array: return _StaticNode{.type = Type::array, .size = _count(val.asArray().size(), "elements"sv)};
+                case Type::string: return _stringNode(val.asString());
+                case Type::integer: return _StaticNode{.type = Type::integer, .bits = uint64_t(val.asInteger())};
+                case Type::unsigner: return _StaticNode{.type = Type::unsigner, .bits = val.asUnsigner()};
+                case Type::floater: return _StaticNode{.type = Type::floater, .bits = std::bit_cast<uint64_t>(val.asFloater())};
+                case Type::boolean: return _StaticNode{.type = Type::boolean, .bits = val.asBoolean()};
+                case Type::null: return _StaticNode{.type = Type::null};
+            }
+            return _StaticNode{};
+        }
+    };
+
+    inline void saveSnapshot(const Value & val, const std::filesystem::path & path)
+    {
+        const _SnapshotWriter writer{val};
+
+        _SnapshotHeader header{};
+        std::memcpy(header.magic, _snapshotMagic, sizeof(header.magic));
+        header.version = _snapshotVersion;
+        header.byteOrder = _snapshotByteOrder;
+        header.nodeCount = writer.nodes.size();
+        header.charCount = writer.chars.size();
+
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(writer.nodes.data()), std::streamsize(writer.nodes.size() * sizeof(_StaticNode)));
+        file.write(writer.chars.data(), std::streamsize(writer.chars.size()));
+        file.close();
+
+        if (!file)
+        {
+            _throw<SnapshotError>("Failed to write snapshot"sv);
+        }
+    }
+
+    inline Snapshot loadSnapshot(const std::filesystem::path & path)
+    {
+        const char * data{nullptr};
+        size_t size{0u};
+
+        #ifdef _WIN32
+        {
+            const HANDLE file{CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                _throw<SnapshotError>("Failed to open snapshot"sv);
+            }
+
+            LARGE_INTEGER fileSize{};
+            const HANDLE mapping{GetFileSizeEx(file, &fileSize) && fileSize.QuadPart ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr};
+            CloseHandle(file);
+            if (!mapping)
+            {
+                _throw<SnapshotError>("Failed to map snapshot"sv);
+            }
+
+            data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+            if (!data)
+            {
+                _throw<SnapshotError>("Failed to map snapshot"sv);
+            }
+            size = size_t(fileSize.QuadPart);
+        }
+        #else
+        {
+            const int fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (fd < 0)
+            {
+                _throw<SnapshotError>("Failed to open snapshot"sv);
+            }
+
+            struct stat st{};
+            void * const mapped{fstat(fd, &st) == 0 && st.st_size > 0 ? mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED};
+            close(fd);
+            if (mapped == MAP_FAILED)
+            {
+                _throw<SnapshotError>("Failed to map snapshot"sv);
+            }
+
+            data = static_cast<const char *>(mapped);
+            size = size_t(st.st_size);
+        }
+        #endif
+
+        // Owns the mapping from here on, so that it is released if validation fails
+        Snapshot snapshot{data, size};
+
+        _SnapshotHeader header;
+        if (size < sizeof(header))
+        {
+            _throw<SnapshotError>("Not a snapshot"sv);
+        }
+        std::memcpy(&header, data, sizeof(header));
+
+        if (std::memcmp(header.magic, _snapshotMagic, sizeof(header.magic)) != 0)
+        {
+            _throw<SnapshotError>("Not a snapshot"sv);
+        }
+        if (header.version != _snapshotVersion)
+        {
+            _throw<SnapshotError>("Unsupported snapshot version"sv);
+        }
+        if (header.byteOrder != _snapshotByteOrder)
+        {
+            _throw<SnapshotError>("Snapshot byte order does not match"sv);
+        }
+        if (header.nodeCount == 0u || header.nodeCount > UINT32_MAX || header.charCount > UINT32_MAX || size != sizeof(header) + header.nodeCount * sizeof(_StaticNode) + header.charCount)
+        {
+            _throw<SnapshotError>("Snapshot is truncated or corrupt"sv);
+        }
+
+        return snapshot;
+    }
+}
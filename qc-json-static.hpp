@@ -0,0 +1,1318 @@
+#pragma once
+
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This header provides compile-time decoding of JSON string literals into read-only values
+///
+/// Uses `qc-json.hpp` for the value types and errors
+///
+/// See the README for more info and examples!
+///
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <qc-json.hpp>
+
+namespace qc::json
+{
+    ///
+    /// Wraps a string literal so that it may be passed as a template argument
+    ///
+    template <size_t n>
+    struct StaticString
+    {
+        char chars[n];
+
+        consteval StaticString(const char (&str)[n]) noexcept
+        {
+            std::copy_n(str, n, chars);
+        }
+
+        constexpr string_view view() const noexcept { return string_view{chars, n - 1u}; }
+    };
+
+    // Flattened value node. Objects and arrays refer to a contiguous run of child nodes, with object members stored as
+    // alternating key and value nodes. Strings refer to a run of characters
+    struct _StaticNode
+    {
+        Type type{Type::null};
+        bool sorted{false}; // Whether an object's keys are in ascending order, allowing binary search
+        uint32_t size{0u}; // Number of elements, members, or characters
+        uint32_t index{0u}; // Index of the first child node or character
+        uint64_t bits{0u}; // Bit representation of a number or boolean
+    };
+
+    ///
+    /// A read-only handle to a value within a `StaticDocument` or `Snapshot`
+    ///
+    /// Mirrors the accessors of `Value`, but strings are views and containers are accessed through the handle itself.
+    /// Unlike `Value`, object members keep their order from the JSON, and are looked up by key in linear time, unless
+    /// they came from a `Value` and are thus sorted, in which case binary search is used
+    ///
+    class StaticValue
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @return the type of the value
+        ///
+        constexpr Type type() const noexcept;
+
+        ///
+        /// @return whether the value is of the respective type
+        ///
+        constexpr bool isObject() const noexcept;
+        constexpr bool isArray() const noexcept;
+        constexpr bool isString() const noexcept;
+        constexpr bool isNumber() const noexcept;
+        constexpr bool isInteger() const noexcept;
+        constexpr bool isUnsigner() const noexcept;
+        constexpr bool isFloater() const noexcept;
+        constexpr bool isBoolean() const noexcept;
+        constexpr bool isNull() const noexcept;
+
+        ///
+        /// @tparam safety whether to check if this value is actually of the respective type
+        /// @return this value as the respective type
+        /// @throw `TypeError` if this value is not of the respective type and safety is enabled
+        ///
+        template <Safety safety = safe> constexpr string_view asString() const noexcept(safety == unsafe);
+        template <Safety safety = safe> constexpr int64_t asInteger() const noexcept(safety == unsafe);
+        template <Safety safety = safe> constexpr uint64_t asUnsigner() const noexcept(safety == unsafe);
+        template <Safety safety = safe> constexpr double asFloater() const noexcept(safety == unsafe);
+        template <Safety safety = safe> constexpr bool asBoolean() const noexcept(safety == unsafe);
+
+        ///
+        /// @return the number of elements of an array or members of an object
+        /// @throw `TypeError` if this value is not an object or array
+        ///
+        constexpr size_t size() const;
+
+        ///
+        /// @param i the index of the element or member
+        /// @return the element of an array or the value of the member of an object at the given index
+        /// @throw `TypeError` if this value is not an object or array
+        /// @throw `std::out_of_range` if the index is out of range
+        ///
+        constexpr StaticValue at(size_t i) const;
+
+        ///
+        /// @param i the index of the member
+        /// @return the key of the member of an object at the given index
+        /// @throw `TypeError` if this value is not an object
+        /// @throw `std::out_of_range` if the index is out of range
+        ///
+        constexpr string_view key(size_t i) const;
+
+        ///
+        /// @param key the key of the member
+        /// @return the value of the first member of an object with the given key
+        /// @throw `TypeError` if this value is not an object
+        /// @throw `std::out_of_range` if there is no such member
+        ///
+        constexpr StaticValue at(string_view key) const;
+
+        ///
+        /// @param key the key of the member
+        /// @return whether an object has a member with the given key
+        /// @throw `TypeError` if this value is not an object
+        ///
+        constexpr bool contains(string_view key) const;
+
+        private: //-------------------------------------------------------------
+
+        const _StaticNode * _nodes;
+        const char * _chars;
+        uint32_t _index;
+
+        constexpr StaticValue(const _StaticNode * nodes, const char * chars, uint32_t index) noexcept;
+
+        constexpr const _StaticNode & _node() const noexcept;
+
+        constexpr const _StaticNode & _container() const;
+
+        constexpr const _StaticNode & _object() const;
+
+        constexpr StaticValue _child(uint32_t i) const noexcept;
+
+        constexpr uint32_t _find(string_view key) const;
+
+        template <size_t, size_t> friend class StaticDocument;
+        friend class Snapshot;
+    };
+
+    ///
+    /// The result of `staticDecode`, which holds all of the decoded values and strings in fixed size arrays
+    ///
+    /// @tparam nodeCount the total number of values and object keys
+    /// @tparam charCount the total number of characters of all strings and object keys
+    ///
+    template <size_t nodeCount, size_t charCount>
+    class StaticDocument
+    {
+        public: //--------------------------------------------------------------
+
+        ///
+        /// @return the root value
+        ///
+        constexpr StaticValue root() const noexcept;
+
+        // Implementation details, public only so that `staticDecode` may fill them in
+        std::array<_StaticNode, nodeCount> _nodes{};
+        std::array<char, charCount> _chars{};
+    };
+
+    ///
+    /// Decodes the JSON string literal at compile time
+    ///
+    /// Supports the same syntax as `decode`. Comments are skipped. Invalid JSON is a compile error, the location of
+    /// which names the problem
+    ///
+    /// Floating point numbers are correctly rounded, and so match `decode` exactly
+    ///
+    /// Example: `constexpr auto config{qc::json::staticDecode<R"({ size: 16, name: "Bob" })">()};`
+    ///
+    /// @tparam json the JSON string literal
+    /// @return the decoded document, which when declared `constexpr` or `constinit` lives in read-only storage
+    ///
+    template <StaticString json> consteval auto staticDecode();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::json
+{
+    // Node as decoded, in depth first order, before being laid out
+    struct _StaticParsedNode
+    {
+        Type type{Type::null};
+        uint32_t size{0u};
+        uint32_t span{1u}; // Number of nodes in this subtree, including itself
+        uint32_t chars{0u};
+        uint64_t bits{0u};
+    };
+
+    // Unsigned integer of any size, for the exact conversion of floaters that need it
+    class _StaticBigInt
+    {
+        public: //--------------------------------------------------------------
+
+        constexpr void multiplyAdd(const uint32_t factor, const uint32_t addend)
+        {
+            uint64_t carry{addend};
+            for (uint32_t & word : _words)
+            {
+                carry += uint64_t(word) * factor;
+                word = uint32_t(carry);
+                carry >>= 32;
+            }
+            if (carry)
+            {
+                _words.push_back(uint32_t(carry));
+            }
+        }
+
+        constexpr void multiply(const uint64_t factor)
+        {
+            _StaticBigInt high{};
+            if (factor >> 32)
+            {
+                high = *this;
+                high.multiplyAdd(uint32_t(factor >> 32), 0u);
+                high.shiftLeft(32);
+            }
+            if (uint32_t(factor))
+            {
+                multiplyAdd(uint32_t(factor), 0u);
+            }
+            else
+            {
+                _words.clear();
+            }
+            *this += high;
+        }
+
+        constexpr void multiplyPow10(int power)
+        {
+            for (; power >= 9; power -= 9) multiplyAdd(1000000000u, 0u);
+            for (; power > 0; --power) multiplyAdd(10u, 0u);
+        }
+
+        constexpr void shiftLeft(const int bits)
+        {
+            if (_words.empty())
+            {
+                return;
+            }
+            const size_t wordShift{size_t(bits / 32)};
+            const int bitShift{bits % 32};
+            if (bitShift)
+            {
+                uint32_t carry{0u};
+                for (uint32_t & word : _words)
+                {
+                    const uint32_t next{word >> (32 - bitShift)};
+                    word = (word << bitShift) | carry;
+                    carry = next;
+                }
+                if (carry)
+                {
+                    _words.push_back(carry);
+                }
+            }
+            _words.insert(_words.begin(), wordShift, 0u);
+        }
+
+        constexpr int bitLength() const noexcept
+        {
+            return _words.empty() ? 0 : int(_words.size() * 32u) - std::countl_zero(_words.back());
+        }
+
+        // Roughly this divided by another, from the top words of each
+        constexpr double ratio(const _StaticBigInt & other) const noexcept
+        {
+            const auto top{[](const std::vector<uint32_t> & words) {
+                double val{0.0};
+                for (size_t i{words.size()}, n{0u}; i-- && n < 3u; ++n)
+                {
+                    val = val * 4294967296.0 + double(words[i]);
+                }
+                return val;
+            }};
+
+            double val{top(_words) / top(other._words)};
+            for (int scale{32 * (std::max(int(_words.size()), 3) - std::max(int(other._words.size()), 3))}; scale; )
+            {
+                if (scale > 0)
+                {
+                    val *= 2.0;
+                    --scale;
+                }
+                else
+                {
+                    val /= 2.0;
+                    ++scale;
+                }
+            }
+            return val;
+        }
+
+        constexpr bool isZero() const noexcept
+        {
+            return _words.empty();
+        }
+
+        constexpr bool operator>=(const _StaticBigInt & other) const noexcept
+        {
+            if (_words.size() != other._words.size())
+            {
+                return _words.size() > other._words.size();
+            }
+            for (size_t i{_words.size()}; i--;)
+            {
+                if (_words[i] != other._words[i])
+                {
+                    return _words[i] > other._words[i];
+                }
+            }
+            return true;
+        }
+
+        constexpr _StaticBigInt & operator+=(const _StaticBigInt & other)
+        {
+            if (_words.size() < other._words.size())
+            {
+                _words.resize(other._words.size(), 0u);
+            }
+            uint64_t carry{0u};
+            for (size_t i{0u}; i < _words.size(); ++i)
+            {
+                carry += uint64_t(_words[i]) + (i < other._words.size() ? other._words[i] : 0u);
+                _words[i] = uint32_t(carry);
+                carry >>= 32;
+            }
+            if (carry)
+            {
+                _words.push_back(uint32_t(carry));
+            }
+            return *this;
+        }
+
+        // Must not be more than this
+        constexpr _StaticBigInt & operator-=(const _StaticBigInt & other) noexcept
+        {
+            int64_t borrow{0};
+            for (size_t i{0u}; i < _words.size(); ++i)
+            {
+                const int64_t diff{int64_t(_words[i]) - (i < other._words.size() ? int64_t(other._words[i]) : 0) - borrow};
+                borrow = diff < 0;
+                _words[i] = uint32_t(diff + (borrow << 32));
+            }
+            while (!_words.empty() && !_words.back()) _words.pop_back();
+            return *this;
+        }
+
+        private: //-------------------------------------------------------------
+
+        std::vector<uint32_t> _words{}; // Least significant first, with no zero words at the top
+    };
+
+    // The most significant digits kept. Halfway points between doubles have at most 767, so that many plus a marker for
+    // any nonzero digits dropped rounds the same as all the digits would
+    inline constexpr int _staticMaxDigits{800};
+
+    // Converts `significand * 10^exponent`, which must not be zero, to the nearest double, ties to even. Returns false if
+    // it overflows or underflows to zero
+    constexpr bool _staticFloater(const _StaticBigInt & significand, const int digits, const int exponent, double & val)
+    {
+        // At least 10^309 or less than 10^-325, which also keeps the numbers below reasonably small
+        if (digits + exponent > 310 || digits + exponent < -324)
+        {
+            return false;
+        }
+
+        // Find the top 54 bits of the quotient, being the 53 bits of the mantissa plus one more to round with
+        _StaticBigInt num{significand};
+        _StaticBigInt den{};
+        den.multiplyAdd(1u, 1u);
+        if (exponent >= 0) num.multiplyPow10(exponent);
+        else den.multiplyPow10(-exponent);
+
+        int shift{54 - (num.bitLength() - den.bitLength())};
+        if (shift > 0) num.shiftLeft(shift);
+        else den.shiftLeft(-shift);
+
+        // Divide by taking off multiples of the denominator. Each is estimated from the top words and shaved so as to never
+        // be too many, which leaves a much smaller remainder for the next
+        uint64_t q{0u};
+        while (num >= den)
+        {
+            const uint64_t multiple{std::max(uint64_t(num.ratio(den) * (1.0 - 0x1p-40)), uint64_t{1u})};
+            _StaticBigInt part{den};
+            part.multiply(multiple);
+            num -= part;
+            q += multiple;
+        }
+        bool sticky{!num.isZero()};
+        if (q >> 54)
+        {
+            sticky = sticky || (q & 1u);
+            q >>= 1;
+            --shift;
+        }
+
+        // `q * 2^-shift`, with the top bit of `q` worth `2^exp`
+        int exp{53 - shift};
+        const bool subnormal{exp < -1022};
+        if (subnormal)
+        {
+            const int extra{-1022 - exp};
+            if (extra >= 64)
+            {
+                return false;
+            }
+            sticky = sticky || (q & ((uint64_t{1u} << extra) - 1u));
+            q >>= extra;
+        }
+
+        uint64_t mantissa{q >> 1};
+        if ((q & 1u) && (sticky || (mantissa & 1u)))
+        {
+            ++mantissa;
+        }
+
+        if (subnormal)
+        {
+            // Rounding up to the smallest normal carries into the exponent field as is
+            if (!mantissa)
+            {
+                return false;
+            }
+            val = std::bit_cast<double>(mantissa);
+            return true;
+        }
+
+        if (mantissa >> 53)
+        {
+            mantissa >>= 1;
+            ++exp;
+        }
+        if (exp > 1023)
+        {
+            return false;
+        }
+        val = std::bit_cast<double>((uint64_t(exp + 1023) << 52) | (mantissa & ((uint64_t{1u} << 52) - 1u)));
+        return true;
+    }
+
+    // A subset of the decoder that is usable in constant evaluation
+    class _StaticDecoder
+    {
+        public: //--------------------------------------------------------------
+
+        std::vector<_StaticParsedNode> nodes{};
+        std::vector<char> chars{};
+
+        constexpr explicit _StaticDecoder(const string_view json) :
+            _start{json.data()},
+            _pos{_start},
+            _end{_start + json.size()}
+        {
+            _skipSpaceAndComments();
+            _ingestValue();
+            _skipSpaceAndComments();
+
+            // Allow trailing comma
+            if (_pos < _end && *_pos == ',')
+            {
+                ++_pos;
+                _skipSpaceAndComments();
+            }
+
+            if (_pos != _end)
+            {
+                _throw<DecodeError>("Extraneous content"sv, size_t(_pos - _start));
+            }
+        }
+
+        private: //-------------------------------------------------------------
+
+        const char * _start;
+        const char * _pos;
+        const char * _end;
+
+        static constexpr bool _isSpace(const char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        static constexpr bool _isDigit(const char c) noexcept
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static constexpr bool _isIdentifierChar(const char c) noexcept
+        {
+            return _isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        }
+
+        static constexpr bool _isPrint(const char c) noexcept
+        {
+            return c >= ' ' && c <= '~';
+        }
+
+        static constexpr int _digitValue(const char c) noexcept
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+            return 36;
+        }
+
+        constexpr void _skipSpaceAndComments()
+        {
+            while (_pos < _end)
+            {
+                if (_isSpace(*_pos))
+                {
+                    ++_pos;
+                }
+                else if (_pos + 1 < _end && _pos[0] == '/' && _pos[1] == '/')
+                {
+                    while (_pos < _end && *_pos != '\n') ++_pos;
+                }
+                else if (_pos + 1 < _end && _pos[0] == '/' && _pos[1] == '*')
+                {
+                    const char * const commentStart{_pos};
+                    _pos += 2;
+                    while (_pos + 1 < _end && !(_pos[0] == '*' && _pos[1] == '/')) ++_pos;
+                    if (_pos + 1 >= _end)
+                    {
+                        _throw<DecodeError>("Block comment is unterminated"sv, size_t(commentStart - _start));
+                    }
+                    _pos += 2;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        constexpr bool _tryConsumeChars(const string_view str) noexcept
+        {
+            if (size_t(_end - _pos) >= str.size() && string_view{_pos, str.size()} == str)
+            {
+                // Ensure the keyword is not just the start of a larger identifier
+                if (_pos + str.size() >= _end || !_isIdentifierChar(_pos[str.size()]))
+                {
+                    _pos += str.size();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        constexpr size_t _push(const Type type, const uint64_t bits = 0u)
+        {
+            nodes.push_back(_StaticParsedNode{.type = type, .size = 0u, .span = 1u, .chars = 0u, .bits = bits});
+            return nodes.size() - 1u;
+        }
+
+        constexpr void _ingestValue()
+        {
+            if (_pos >= _end)
+            {
+                _throw<DecodeError>("Expected value"sv, size_t(_pos - _start));
+            }
+
+            char c{*_pos};
+
+            switch (c)
+            {
+                case '{': _ingestObject(); return;
+                case '[': _ingestArray(); return;
+                case '"': [[fallthrough]];
+                case '\'': _ingestString(c); return;
+            }
+
+            const int sign{(c == '+') - (c == '-')};
+            if (sign)
+            {
+                ++_pos;
+                if (_pos >= _end)
+                {
+                    _throw<DecodeError>("Expected number"sv, size_t(_pos - _start));
+                }
+                c = *_pos;
+            }
+            else
+            {
+                if (_tryConsumeChars("true"sv)) { _push(Type::boolean, 1u); return; }
+                if (_tryConsumeChars("false"sv)) { _push(Type::boolean, 0u); return; }
+                if (_tryConsumeChars("null"sv)) { _push(Type::null); return; }
+            }
+
+            if (_isDigit(c) || (c == '.' && _pos + 1 < _end && _isDigit(_pos[1])))
+            {
+                _ingestNumber(sign);
+            }
+            else if (_tryConsumeChars("nan"sv) || _tryConsumeChars("NaN"sv))
+            {
+                _push(Type::floater, std::bit_cast<uint64_t>(std::numeric_limits<double>::quiet_NaN()));
+            }
+            else if (_tryConsumeChars("inf"sv) || _tryConsumeChars("Infinity"sv))
+            {
+                _push(Type::floater, std::bit_cast<uint64_t>(sign < 0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity()));
+            }
+            else
+            {
+                _throw<DecodeError>("Unknown value"sv, size_t(_pos - _start));
+            }
+        }
+
+        constexpr void _ingestObject()
+        {
+            const size_t objIndex{_push(Type::object)};
+
+            ++_pos; // We already know we have `{`
+            _skipSpaceAndComments();
+
+            if (_pos < _end && *_pos == '}')
+            {
+                ++_pos;
+                return;
+            }
+
+            while (true)
+            {
+                // Parse key
+                if (_pos >= _end)
+                {
+                    _throw<DecodeError>("Expected key"sv, size_t(_pos - _start));
+                }
+                if (*_pos == '"' || *_pos == '\'')
+                {
+                    _ingestString(*_pos);
+                }
+                else
+                {
+                    _ingestIdentifier();
+                }
+                _skipSpaceAndComments();
+
+                if (_pos >= _end || *_pos != ':')
+                {
+                    _throw<DecodeError>("Expected `:`"sv, size_t(_pos - _start));
+                }
+                ++_pos;
+                _skipSpaceAndComments();
+
+                _ingestValue();
+                _skipSpaceAndComments();
+                ++nodes[objIndex].size;
+
+                if (_pos < _end && *_pos == '}')
+                {
+                    ++_pos;
+                    break;
+                }
+                if (_pos >= _end || *_pos != ',')
+                {
+                    _throw<DecodeError>("Expected `,`"sv, size_t(_pos - _start));
+                }
+                ++_pos;
+                _skipSpaceAndComments();
+
+                // Allow trailing comma
+                if (_pos < _end && *_pos == '}')
+                {
+                    ++_pos;
+                    break;
+                }
+            }
+
+            nodes[objIndex].span = uint32_t(nodes.size() - objIndex);
+        }
+
+        constexpr void _ingestArray()
+        {
+            const size_t arrIndex{_push(Type::array)};
+
+            ++_pos; // We already know we have `[`
+            _skipSpaceAndComments();
+
+            if (_pos < _end && *_pos == ']')
+            {
+                ++_pos;
+                return;
+            }
+
+            while (true)
+            {
+                _ingestValue();
+                _skipSpaceAndComments();
+                ++nodes[arrIndex].size;
+
+                if (_pos < _end && *_pos == ']')
+                {
+                    ++_pos;
+                    break;
+                }
+                if (_pos >= _end || *_pos != ',')
+                {
+                    _throw<DecodeError>("Expected `,`"sv, size_t(_pos - _start));
+                }
+                ++_pos;
+                _skipSpaceAndComments();
+
+                // Allow trailing comma
+                if (_pos < _end && *_pos == ']')
+                {
+                    ++_pos;
+                    break;
+                }
+            }
+
+            nodes[arrIndex].span = uint32_t(nodes.size() - arrIndex);
+        }
+
+        constexpr void _ingestString(const char quote)
+        {
+            const size_t strIndex{_push(Type::string)};
+            nodes[strIndex].chars = uint32_t(chars.size());
+
+            ++_pos; // We already know we have `"` or `'`
+
+            while (true)
+            {
+                if (_pos >= _end)
+                {
+                    _throw<DecodeError>("Expected end quote"sv, size_t(_pos - _start));
+                }
+
+                const char c{*_pos};
+                if (c == quote)
+                {
+                    ++_pos;
+                    break;
+                }
+                else if (c == '\\')
+                {
+                    ++_pos;
+
+                    // Check for escaped newline
+                    if (_pos < _end && *_pos == '\n')
+                    {
+                        ++_pos;
+                    }
+                    else if (_pos + 1 < _end && _pos[0] == '\r' && _pos[1] == '\n')
+                    {
+                        _pos += 2;
+                    }
+                    else
+                    {
+                        chars.push_back(_consumeEscaped());
+                    }
+                }
+                else if (_isPrint(c))
+                {
+                    chars.push_back(c);
+                    ++_pos;
+                }
+                else
+                {
+                    _throw<DecodeError>("Invalid string content"sv, size_t(_pos - _start));
+                }
+            }
+
+            nodes[strIndex].size = uint32_t(chars.size() - nodes[strIndex].chars);
+        }
+
+        constexpr char _consumeEscaped()
+        {
+            if (_pos >= _end)
+            {
+                _throw<DecodeError>("Expected escape sequence"sv, size_t(_pos - _start));
+            }
+
+            const char c{*_pos};
+            ++_pos;
+
+            switch (c)
+            {
+                case '0': return '\0';
+                case 'b': return '\b';
+                case 't': return '\t';
+                case 'n': return '\n';
+                case 'v': return '\v';
+                case 'f': return '\f';
+                case 'r': return '\r';
+                case 'x': return _consumeCodePoint(2);
+                case 'u': return _consumeCodePoint(4);
+                case 'U': return _consumeCodePoint(8);
+                default:
+                    if (_isPrint(c))
+                    {
+                        return c;
+                    }
+                    else
+                    {
+                        _throw<DecodeError>("Invalid escape sequence"sv, size_t(_pos - _start - 1));
+                    }
+            }
+        }
+
+        constexpr char _consumeCodePoint(const int digits)
+        {
+            if (_end - _pos < digits)
+            {
+                _throw<DecodeError>("Expected code point digits"sv, size_t(_pos - _start));
+            }
+
+            uint32_t val{0u};
+            for (int i{0}; i < digits; ++i)
+            {
+                const int digit{_digitValue(_pos[i])};
+                if (digit >= 16)
+                {
+                    _throw<DecodeError>("Invalid code point"sv, size_t(_pos - _start));
+                }
+                val = val * 16u + uint32_t(digit);
+            }
+
+            _pos += digits;
+
+            return char(val);
+        }
+
+        constexpr void _ingestIdentifier()
+        {
+            const size_t strIndex{_push(Type::string)};
+            nodes[strIndex].chars = uint32_t(chars.size());
+
+            if (!_isIdentifierChar(*_pos))
+            {
+                _throw<DecodeError>("Expected identifier"sv, size_t(_pos - _start));
+            }
+
+            while (_pos < _end && _isIdentifierChar(*_pos))
+            {
+                chars.push_back(*_pos);
+                ++_pos;
+            }
+
+            nodes[strIndex].size = uint32_t(chars.size() - nodes[strIndex].chars);
+        }
+
+        constexpr void _ingestNumber(const int sign)
+        {
+            // Check if hex/octal/binary
+            if (*_pos == '0' && _pos + 1 < _end)
+            {
+                int base{0};
+                switch (_pos[1])
+                {
+                    case 'x': case 'X': base = 16; break;
+                    case 'o': case 'O': base =  8; break;
+                    case 'b': case 'B': base =  2; break;
+                }
+
+                if (base)
+                {
+                    if (sign)
+                    {
+                        _throw<DecodeError>("Hex, octal, and binary numbers must not be signed"sv, size_t(_pos - _start));
+                    }
+                    _pos += 2;
+                    _ingestHexOctalBinary(base);
+                    return;
+                }
+            }
+
+            // Scan the integer digits, and determine if integer or floater in the same manner as the decoder
+            const char * const numStart{_pos};
+            const char * pos{_pos};
+            while (pos < _end && _isDigit(*pos)) ++pos;
+            const char * const intEnd{pos};
+            bool isInteger{true};
+            if (pos < _end && *pos == '.')
+            {
+                ++pos;
+                while (pos < _end && *pos == '0') ++pos;
+                isInteger = !(pos < _end && (_isDigit(*pos) || *pos == 'e' || *pos == 'E'));
+            }
+            else if (pos < _end && (*pos == 'e' || *pos == 'E'))
+            {
+                isInteger = false;
+            }
+
+            if (isInteger)
+            {
+                // Accumulate the magnitude, falling back to a floater on overflow
+                uint64_t val{0u};
+                bool overflow{false};
+                for (const char * p{numStart}; p < intEnd; ++p)
+                {
+                    const uint64_t digit{uint64_t(*p - '0')};
+                    if (val > (std::numeric_limits<uint64_t>::max() - digit) / 10u)
+                    {
+                        overflow = true;
+                        break;
+                    }
+                    val = val * 10u + digit;
+                }
+
+                if (!overflow)
+                {
+                    if (sign < 0)
+                    {
+                        if (val <= uint64_t(std::numeric_limits<int64_t>::max()) + 1u)
+                        {
+                            _pos = pos;
+                            _push(Type::integer, uint64_t(0u - val));
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        _pos = pos;
+                        _push(val & 0x8000000000000000u ? Type::unsigner : Type::integer, val);
+                        return;
+                    }
+                }
+            }
+
+            _ingestFloater(sign < 0);
+        }
+
+        constexpr void _ingestHexOctalBinary(const int base)
+        {
+            const char * const digitsStart{_pos};
+            uint64_t val{0u};
+            while (_pos < _end && _digitValue(*_pos) < base)
+            {
+                const uint64_t digit{uint64_t(_digitValue(*_pos))};
+                if (val > (std::numeric_limits<uint64_t>::max() - digit) / uint64_t(base))
+                {
+                    _pos = digitsStart;
+                    break;
+                }
+                val = val * uint64_t(base) + digit;
+                ++_pos;
+            }
+
+            if (_pos == digitsStart)
+            {
+                _throw<DecodeError>(base == 2 ? "Invalid binary"sv : base == 8 ? "Invalid octal"sv : "Invalid hex"sv, size_t(_pos - _start));
+            }
+
+            _push(Type::unsigner, val);
+        }
+
+        // Correctly rounded. Up to 15 significant digits and exponents within 22 take a fast path
+        constexpr void _ingestFloater(const bool negative)
+        {
+            const char * const numStart{_pos};
+            _StaticBigInt significand{};
+            uint64_t mantissa{0u}; // The same while it fits
+            int digits{0};
+            int exponent{0};
+            bool dropped{false};
+
+            const auto addDigit{[&](const char c) -> bool {
+                const uint32_t digit{uint32_t(c - '0')};
+                if (digits >= _staticMaxDigits)
+                {
+                    dropped = dropped || digit;
+                    return false;
+                }
+                significand.multiplyAdd(10u, digit);
+                if (digits < 19) mantissa = mantissa * 10u + digit;
+                if (digits || digit) ++digits;
+                return true;
+            }};
+
+            // Integer part
+            while (_pos < _end && _isDigit(*_pos))
+            {
+                if (!addDigit(*_pos)) ++exponent;
+                ++_pos;
+            }
+
+            // Fractional part
+            if (_pos < _end && *_pos == '.')
+            {
+                ++_pos;
+                while (_pos < _end && _isDigit(*_pos))
+                {
+                    if (addDigit(*_pos)) --exponent;
+                    ++_pos;
+                }
+            }
+
+            // Exponent
+            if (_pos < _end && (*_pos == 'e' || *_pos == 'E'))
+            {
+                ++_pos;
+                int expSign{1};
+                if (_pos < _end && (*_pos == '+' || *_pos == '-'))
+                {
+                    expSign = *_pos == '-' ? -1 : 1;
+                    ++_pos;
+                }
+                if (_pos >= _end || !_isDigit(*_pos))
+                {
+                    _throw<DecodeError>("Invalid floater"sv, size_t(_pos - _start));
+                }
+                int exp{0};
+                while (_pos < _end && _isDigit(*_pos))
+                {
+                    if (exp < 100000) exp = exp * 10 + (*_pos - '0');
+                    ++_pos;
+                }
+                exponent += expSign * exp;
+            }
+
+            double val{0.0};
+            if (digits)
+            {
+                // Both the mantissa and the power of ten are exact as doubles, so one operation rounds correctly
+                constexpr double exactPowers[]{1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+                if (!dropped && digits <= 15 && exponent >= -22 && exponent <= 22)
+                {
+                    val = exponent >= 0 ? double(mantissa) * exactPowers[exponent] : double(mantissa) / exactPowers[-exponent];
+                }
+                else
+                {
+                    if (dropped)
+                    {
+                        significand.multiplyAdd(10u, 1u);
+                        --exponent;
+                        ++digits;
+                    }
+
+                    // Out of range magnitudes are invalid, as with `decode`
+                    if (!_staticFloater(significand, digits, exponent, val))
+                    {
+                        _throw<DecodeError>("Invalid floater"sv, size_t(numStart - _start));
+                    }
+                }
+            }
+
+            _push(Type::floater, std::bit_cast<uint64_t>(negative ? -val : val));
+        }
+    };
+
+    // Lays the depth first nodes out such that the children of each container are contiguous
+    constexpr std::vector<_StaticNode> _staticLayout(const std::vector<_StaticParsedNode> & parsed)
+    {
+        std::vector<_StaticNode> nodes(parsed.size());
+        std::vector<uint32_t> sources{0u}; // Parsed index of each laid out node, which doubles as the breadth first queue
+
+        nodes[0] = _StaticNode{.type = parsed[0].type, .size = parsed[0].size, .index = parsed[0].chars, .bits = parsed[0].bits};
+
+        for (size_t i{0u}; i < sources.size(); ++i)
+        {
+            const _StaticParsedNode & src{parsed[sources[i]]};
+            if (src.type != Type::object && src.type != Type::array)
+            {
+                continue;
+            }
+
+            nodes[i].index = uint32_t(sources.size());
+            const uint32_t childCount{src.type == Type::object ? src.size * 2u : src.size};
+            for (uint32_t c{0u}, child{sources[i] + 1u}; c < childCount; ++c, child += parsed[child].span)
+            {
+                const _StaticParsedNode & childSrc{parsed[child]};
+                nodes[sources.size()] = _StaticNode{.type = childSrc.type, .size = childSrc.size, .index = childSrc.chars, .bits = childSrc.bits};
+                sources.push_back(child);
+            }
+        }
+
+        return nodes;
+    }
+
+    constexpr StaticValue::StaticValue(const _StaticNode * const nodes, const char * const chars, const uint32_t index) noexcept :
+        _nodes{nodes},
+        _chars{chars},
+        _index{index}
+    {}
+
+    constexpr const _StaticNode & StaticValue::_node() const noexcept
+    {
+        return _nodes[_index];
+    }
+
+    constexpr const _StaticNode & StaticValue::_container() const
+    {
+        const _StaticNode & node{_node()};
+        if (node.type != Type::object && node.type != Type::array)
+        {
+            _throw<TypeError>();
+        }
+        return node;
+    }
+
+    constexpr const _StaticNode & StaticValue::_object() const
+    {
+        const _StaticNode & node{_node()};
+        if (node.type != Type::object)
+        {
+            _throw<TypeError>();
+        }
+        return node;
+    }
+
+    constexpr StaticValue StaticValue::_child(const uint32_t i) const noexcept
+    {
+        return StaticValue{_nodes, _chars, _node().index + i};
+    }
+
+    constexpr Type StaticValue::type() const noexcept
+    {
+        return _node().type;
+    }
+
+    constexpr bool StaticValue::isObject() const noexcept
+    {
+        return type() == Type::object;
+    }
+
+    constexpr bool StaticValue::isArray() const noexcept
+    {
+        return type() == Type::array;
+    }
+
+    constexpr bool StaticValue::isString() const noexcept
+    {
+        return type() == Type::string;
+    }
+
+    constexpr bool StaticValue::isNumber() const noexcept
+    {
+        const Type type{this->type()};
+        return type == Type::integer || type == Type::unsigner || type == Type::floater;
+    }
+
+    constexpr bool StaticValue::isInteger() const noexcept
+    {
+        return type() == Type::integer;
+    }
+
+    constexpr bool StaticValue::isUnsigner() const noexcept
+    {
+        return type() == Type::unsigner;
+    }
+
+    constexpr bool StaticValue::isFloater() const noexcept
+    {
+        return type() == Type::floater;
+    }
+
+    constexpr bool StaticValue::isBoolean() const noexcept
+    {
+        return type() == Type::boolean;
+    }
+
+    constexpr bool StaticValue::isNull() const noexcept
+    {
+        return type() == Type::null;
+    }
+
+    template <Safety safety>
+    constexpr string_view StaticValue::asString() const noexcept(safety == unsafe)
+    {
+        if constexpr (safety == safe)
+        {
+            if (!isString()) _throw<TypeError>();
+        }
+
+        return string_view{_chars + _node().index, _node().size};
+    }
+
+    template <Safety safety>
+    constexpr int64_t StaticValue::asInteger() const noexcept(safety == unsafe)
+    {
+        if constexpr (safety == safe)
+        {
+            if (!isInteger()) _throw<TypeError>();
+        }
+
+        return int64_t(_node().bits);
+    }
+
+    template <Safety safety>
+    constexpr uint64_t StaticValue::asUnsigner() const noexcept(safety == unsafe)
+    {
+        if constexpr (safety == safe)
+        {
+            if (!isUnsigner()) _throw<TypeError>();
+        }
+
+        return _node().bits;
+    }
+
+    template <Safety safety>
+    constexpr double StaticValue::asFloater() const noexcept(safety == unsafe)
+    {
+        if constexpr (safety == safe)
+        {
+            if (!isFloater()) _throw<TypeError>();
+        }
+
+        return std::bit_cast<double>(_node().bits);
+    }
+
+    template <Safety safety>
+    constexpr bool StaticValue::asBoolean() const noexcept(safety == unsafe)
+    {
+        if constexpr (safety == safe)
+        {
+            if (!isBoolean()) _throw<TypeError>();
+        }
+
+        return bool(_node().bits);
+    }
+
+    constexpr size_t StaticValue::size() const
+    {
+        return _container().size;
+    }
+
+    constexpr StaticValue StaticValue::at(const size_t i) const
+    {
+        const _StaticNode & node{_container()};
+        if (i >= node.size)
+        {
+            _throw<std::out_of_range>("Index out of range");
+        }
+        return _child(uint32_t(node.type == Type::object ? i * 2u + 1u : i));
+    }
+
+    constexpr string_view StaticValue::key(const size_t i) const
+    {
+        const _StaticNode & node{_object()};
+        if (i >= node.size)
+        {
+            _throw<std::out_of_range>("Index out of range");
+        }
+        return _child(uint32_t(i * 2u)).asString<unsafe>();
+    }
+
+    constexpr StaticValue StaticValue::at(const string_view key) const
+    {
+        const uint32_t i{_find(key)};
+        if (i >= _node().size)
+        {
+            _throw<std::out_of_range>("No such member");
+        }
+        return _child(i * 2u + 1u);
+    }
+
+    constexpr bool StaticValue::contains(const string_view key) const
+    {
+        return _find(key) < _node().size;
+    }
+
+    // Returns the index of the first member with the key, or the member count if there is none
+    constexpr uint32_t StaticValue::_find(const string_view key) const
+    {
+        const _StaticNode & node{_object()};
+
+        if (node.sorted)
+        {
+            uint32_t low{0u}, high{node.size};
+            while (low < high)
+            {
+                const uint32_t mid{low + (high - low) / 2u};
+                if (_child(mid * 2u).asString<unsafe>() < key) low = mid + 1u;
+                else high = mid;
+            }
+            return low < node.size && _child(low * 2u).asString<unsafe>() == key ? low : node.size;
+        }
+
+        for (uint32_t i{0u}; i < node.size; ++i)
+        {
+            if (_child(i * 2u).asString<unsafe>() == key)
+            {
+                return i;
+            }
+        }
+        return node.size;
+    }
+
+    template <size_t nodeCount, size_t charCount>
+    constexpr StaticValue StaticDocument<nodeCount, charCount>::root() const noexcept
+    {
+        return StaticValue{_nodes.data(), _chars.data(), 0u};
+    }
+
+    template <StaticString json>
+    consteval auto staticDecode()
+    {
+        constexpr size_t nodeCount{_StaticDecoder{json.view()}.nodes.size()};
+        constexpr size_t charCount{_StaticDecoder{json.view()}.chars.size()};
+
+        const _StaticDecoder decoder{json.view()};
+        const std::vector<_StaticNode> nodes{_staticLayout(decoder.nodes)};
+
+        StaticDocument<nodeCount, charCount> doc{};
+        std::copy(nodes.begin(), nodes.end(), doc._nodes.begin());
+        std::copy(decoder.chars.begin(), decoder.chars.end(), doc._chars.begin());
+        return doc;
+    }
+}
@@ -0,0 +1,39 @@
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// The sole source of the `qc-json-compiled` library, which instantiates the DOM decode and encode paths once so that
+/// translation units including `qc-json.hpp` with `QC_JSON_COMPILED` defined need not
+///
+
+#ifndef QC_JSON_COMPILED
+    #error "`QC_JSON_COMPILED` must be defined publicly by the `qc-json-compiled` library"
+#endif
+
+#include <qc-json.hpp>
+
+namespace qc::json
+{
+    template class _Decoder<_Composer, _Composer::State>;
+    template void _Decoder<_Composer, _Composer::State>::_ingestInteger<false>(size_t, _Composer::State &);
+    template void _Decoder<_Composer, _Composer::State>::_ingestInteger<true>(size_t, _Composer::State &);
+    template string_view _Decoder<_Composer, _Composer::State>::_consumeString<false>(char, _Composer::State &);
+    template DecodeResult _decode(string_view, _Composer &, _Composer::State &, _InputSource *);
+    template void decode<_Composer, _Composer::State>(string_view, _Composer &, _Composer::State &);
+    template DecodeResult tryDecode<_Composer, _Composer::State>(string_view, _Composer &, _Composer::State &);
+    template void Encoder::_val(string_view);
+    template void Encoder::_val(int64_t);
+    template void Encoder::_val(uint64_t);
+    template void Encoder::_val(double);
+    template void Encoder::_val(bool);
+    template void Encoder::_val(std::nullptr_t);
+    template void Encoder::_val(_BinaryToken);
+    template void Encoder::_val(_OctalToken);
+    template void Encoder::_val(_HexToken);
+    template void Encoder::_val(_Base64Token);
+}
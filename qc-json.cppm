@@ -0,0 +1,80 @@
+///
+/// QC JSON 2.0.2
+///
+/// Quick and clean JSON5 header library for C++20
+///
+/// Austin Quick : 2019 - 2022
+///
+/// https://github.com/daskie/qc-json
+///
+/// This module interface unit provides `import qc.json;` as an alternative to including `qc-json.hpp`
+///
+/// The headers are parsed once when the module is built, rather than once per translation unit. Macros such as
+/// `QC_JSON_TRACE` must be defined when building the module, as they do not pass through an import
+///
+/// See the README for more info and examples!
+///
+
+module;
+
+#include <qc-json.hpp>
+
+export module qc.json;
+
+export namespace qc::json
+{
+    // Common
+    using qc::json::Error;
+    using qc::json::Container;
+    using qc::json::Density;
+
+    // Tracing
+    #ifdef QC_JSON_TRACE
+    using qc::json::TraceOperation;
+    using qc::json::TraceInfo;
+    using qc::json::TraceHook;
+    using qc::json::setTraceHook;
+    #endif
+
+    // Encoding
+    using qc::json::EncodeError;
+    using qc::json::Sink;
+    using qc::json::Encoder;
+    inline namespace tokens
+    {
+        using qc::json::tokens::object;
+        using qc::json::tokens::array;
+        using qc::json::tokens::end;
+        using qc::json::tokens::binary;
+        using qc::json::tokens::octal;
+        using qc::json::tokens::hex;
+        using qc::json::tokens::base64;
+        using qc::json::tokens::comment;
+    }
+
+    // Decoding
+    using qc::json::DecodeError;
+    using qc::json::ComposeError;
+    using qc::json::DecodeResult;
+    using qc::json::DummyComposer;
+    using qc::json::decode;
+    using qc::json::tryDecode;
+
+    // DOM
+    using qc::json::TypeError;
+    using qc::json::Safety;
+    using qc::json::safe;
+    using qc::json::unsafe;
+    using qc::json::Type;
+    using qc::json::Object;
+    using qc::json::Array;
+    using qc::json::ValueFrom;
+    using qc::json::ValueFromAble;
+    using qc::json::ValueTo;
+    using qc::json::ValueToAble;
+    using qc::json::Value;
+    using qc::json::makeObject;
+    using qc::json::makeArray;
+    using qc::json::encode;
+    using qc::json::operator<<;
+}
@@ -22,6 +22,7 @@
 #include <concepts>
 #include <map>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -40,7 +41,8 @@ namespace qc::json
     static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= 8);
 
     ///
-    /// This will be thrown when attempting to access a value as the wrong type
+    /// This will be thrown when attempting to access a value as the wrong type. If exceptions are disabled, the program
+    /// aborts instead, so use the `is` methods or `tryGet` to check first
     ///
     struct TypeError : Error {};
 
@@ -356,6 +358,16 @@ namespace qc::json
         ///
         template <typename T, Safety safety = safe> T get() const;
 
+        ///
+        /// Checked alternative to `get` that never throws, such as for use when exceptions are disabled
+        ///
+        /// Objects and arrays are not supported, instead check `isObject` or `isArray` and then use the unsafe
+        /// `asObject` or `asArray`
+        ///
+        /// @return the value as type `T`, or empty if `is<T>()` is false
+        ///
+        template <typename T> std::optional<T> tryGet() const;
+
         ///
         /// @return whether the value has a comment
         ///
@@ -458,20 +470,32 @@ namespace qc::json
     ///
     /// @param json the JSON string to decode
     /// @return the decoded value of the JSON
-    /// @throw `DecodeError` if the JSON string is invalid or could otherwise not be parsed
+    /// @throw `DecodeError` if the JSON string is invalid or could otherwise not be parsed. If exceptions are disabled,
+    ///     aborts instead
     ///
     Value decode(string_view json);
 
+    ///
+    /// Same as `decode`, but reports errors via the result rather than by throwing
+    ///
+    /// @param json the JSON string to decode
+    /// @param root set to the decoded value of the JSON, or null on failure
+    /// @return the result, which converts to `true` on success
+    ///
+    DecodeResult tryDecode(string_view json, Value & root);
+
     ///
     /// @param val the JSON value to encode
     /// @param density the base density of the encoded JSON string
     /// @param indentSpaces the number of spaces to insert per level of indentation
     /// @param singleQuotes whether to use `'` instead of `"` for strings
     /// @param identifiers whether to encode all eligible keys as identifiers instead of strings
+    /// @param canonical whether to produce canonical JSON, in which case all other options are ignored
     /// @return an encoded JSON string of the given JSON value
-    /// @throw `EncodeError` if there was an issue encoding the JSON
+    /// @throw `EncodeError` if there was an issue encoding the JSON. If exceptions are disabled, aborts instead. To check
+    ///     for errors, stream the value into an `Encoder` directly
     ///
-    string encode(const Value & val, Density density = Density::multiline, size_t indentSpaces = 4u, bool singleQuotes = false, bool identifiers = false);
+    string encode(const Value & val, Density density = Density::multiline, size_t indentSpaces = 4u, bool singleQuotes = false, bool identifiers = false, bool canonical = false);
 
     ///
     /// Specialization of the encoder's `operator<<` for `Value`
@@ -606,7 +630,7 @@ namespace qc::json
     {}
 
     inline Value::Value(Array && val, const Density density) noexcept :
-        _ptrAndDensity{reinterpret_cast<uintptr_t>(new Array{std::move(val)}) | uintptr_t(density)},
+        _ptrAndDensity{reinterpret_cast<uintptr_t>(new Array(std::move(val))) | uintptr_t(density)},
         _typeAndComment{uintptr_t(Type::array)}
     {}
 
@@ -715,7 +739,7 @@ namespace qc::json
         {
             _deleteValue();
             _setType(Type::array);
-            _ptrAndDensity = reinterpret_cast<uintptr_t>(new Array{std::move(val)});
+            _ptrAndDensity = reinterpret_cast<uintptr_t>(new Array(std::move(val)));
         }
         return *this;
     }
@@ -1034,6 +1058,11 @@ namespace qc::json
         {
             return isNumber();
         }
+        // Null
+        else if constexpr (std::is_same_v<U, nullptr_t>)
+        {
+            return isNull();
+        }
         // Other
         else
         {
@@ -1050,7 +1079,7 @@ namespace qc::json
     template <Safety safety>
     inline const Object & Value::asObject() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isObject()) throw TypeError{};
+        if constexpr (safety == safe) if (!isObject()) _throw<TypeError>();
         return *reinterpret_cast<const Object *>(_ptrAndDensity & ~uintptr_t{0b111u});
     }
 
@@ -1063,7 +1092,7 @@ namespace qc::json
     template <Safety safety>
     inline const Array & Value::asArray() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isArray()) throw TypeError{};
+        if constexpr (safety == safe) if (!isArray()) _throw<TypeError>();
         return *reinterpret_cast<const Array *>(_ptrAndDensity & ~uintptr_t{0b111u});
     }
 
@@ -1076,7 +1105,7 @@ namespace qc::json
     template <Safety safety>
     inline const string & Value::asString() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isString()) throw TypeError{};
+        if constexpr (safety == safe) if (!isString()) _throw<TypeError>();
         return *_string;
     }
 
@@ -1089,7 +1118,7 @@ namespace qc::json
     template <Safety safety>
     inline const int64_t & Value::asInteger() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isInteger()) throw TypeError{};
+        if constexpr (safety == safe) if (!isInteger()) _throw<TypeError>();
         return _integer;
     }
 
@@ -1102,7 +1131,7 @@ namespace qc::json
     template <Safety safety>
     inline const uint64_t & Value::asUnsigner() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isUnsigner()) throw TypeError{};
+        if constexpr (safety == safe) if (!isUnsigner()) _throw<TypeError>();
         return _unsigner;
     }
 
@@ -1115,7 +1144,7 @@ namespace qc::json
     template <Safety safety>
     inline const double & Value::asFloater() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isFloater()) throw TypeError{};
+        if constexpr (safety == safe) if (!isFloater()) _throw<TypeError>();
         return _floater;
     }
 
@@ -1128,7 +1157,7 @@ namespace qc::json
     template <Safety safety>
     inline const bool & Value::asBoolean() const noexcept(safety == unsafe)
     {
-        if constexpr (safety == safe) if (!isBoolean()) throw TypeError{};
+        if constexpr (safety == safe) if (!isBoolean()) _throw<TypeError>();
         return _boolean;
     }
 
@@ -1158,7 +1187,7 @@ namespace qc::json
         // Character
         else if constexpr (std::is_same_v<U, char>)
         {
-            if constexpr (safety == safe) if (!is<char>()) throw TypeError{};
+            if constexpr (safety == safe) if (!is<char>()) _throw<TypeError>();
             return asString<unsafe>().front();
         }
         // Boolean
@@ -1169,7 +1198,7 @@ namespace qc::json
         // Number
         else if constexpr (std::is_arithmetic_v<U>)
         {
-            if constexpr (safety == safe) if (!is<U>()) throw TypeError{};
+            if constexpr (safety == safe) if (!is<U>()) _throw<TypeError>();
             switch (type())
             {
                 case Type::integer: return U(_integer);
@@ -1180,7 +1209,7 @@ namespace qc::json
         }
         else if constexpr (std::is_same_v<U, nullptr_t>)
         {
-            if constexpr (safety == safe) if (!isNull()) throw TypeError{};
+            if constexpr (safety == safe) if (!isNull()) _throw<TypeError>();
             return nullptr;
         }
         // Other
@@ -1191,6 +1220,21 @@ namespace qc::json
         }
     }
 
+    template <typename T>
+    inline std::optional<T> Value::tryGet() const
+    {
+        static_assert(!ValueToAble<std::decay_t<T>>, "Custom types cannot be checked, use `qc::json::Value::get` instead");
+
+        if (is<T>())
+        {
+            return get<T, unsafe>();
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
     inline bool Value::hasComment() const noexcept
     {
         return comment();
@@ -1428,18 +1472,68 @@ namespace qc::json
 
     inline Value decode(const string_view json)
     {
+        #ifdef QC_JSON_TRACE
+        const std::chrono::steady_clock::time_point traceStart{std::chrono::steady_clock::now()};
+        #endif
+
         Value root{};
         _Composer::State rootState{&root, Container::none};
         _Composer composer{};
         decode(json, composer, rootState);
+
+        #ifdef QC_JSON_TRACE
+        const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() - traceStart};
+        _trace(TraceInfo{TraceOperation::domDecode, json.size(), _lastTrace.nodes, _lastTrace.depth, elapsed, false});
+        #endif
+
         return root;
     }
 
-    inline string encode(const Value & val, const Density density, size_t indentSpaces, bool singleQuotes, bool identifiers)
+    inline DecodeResult tryDecode(const string_view json, Value & root)
     {
-        Encoder encoder{density, indentSpaces, singleQuotes, identifiers};
+        #ifdef QC_JSON_TRACE
+        const std::chrono::steady_clock::time_point traceStart{std::chrono::steady_clock::now()};
+        #endif
+
+        root = nullptr;
+        _Composer::State rootState{&root, Container::none};
+        _Composer composer{};
+        DecodeResult result{tryDecode(json, composer, rootState)};
+        if (!result)
+        {
+            root = nullptr;
+        }
+
+        #ifdef QC_JSON_TRACE
+        const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() - traceStart};
+        _trace(TraceInfo{TraceOperation::domDecode, json.size(), _lastTrace.nodes, _lastTrace.depth, elapsed, !result});
+        #endif
+
+        return result;
+    }
+
+    inline string encode(const Value & val, const Density density, size_t indentSpaces, bool singleQuotes, bool identifiers, bool canonical)
+    {
+        #ifdef QC_JSON_TRACE
+        const std::chrono::steady_clock::time_point traceStart{std::chrono::steady_clock::now()};
+        #endif
+
+        Encoder encoder{density, indentSpaces, singleQuotes, identifiers, canonical};
         encoder << val;
-        return encoder.finish();
+        string str{encoder.finish()};
+        #ifdef QC_JSON_NO_EXCEPTIONS
+        if (encoder.failed())
+        {
+            std::abort();
+        }
+        #endif
+
+        #ifdef QC_JSON_TRACE
+        const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() - traceStart};
+        _trace(TraceInfo{TraceOperation::domEncode, str.size(), _lastTrace.nodes, _lastTrace.depth, elapsed, false});
+        #endif
+
+        return str;
     }
 
     inline Encoder & operator<<(Encoder & encoder, const Value & val)
@@ -1458,15 +1552,31 @@ namespace qc::json
             }
             case Type::object:
             {
-                encoder << object(val.density());
-                for (const auto & [key, v] : val.asObject<unsafe>())
-                {
+                const Object & obj{val.asObject<unsafe>()};
+                const auto encodeMember{[&encoder](const string & key, const Value & v) {
                     if (v.hasComment())
                     {
                         encoder << comment(*v.comment());
                     }
                     encoder << key << v;
+                }};
+
+                encoder << object(val.density());
+
+                // Canonical key order differs from the map's byte order only for some keys above U+E000
+                if (encoder.canonical() && !std::is_sorted(obj.begin(), obj.end(), [](const auto & a, const auto & b) { return _canonicalKeyLess(a.first, b.first); }))
+                {
+                    std::vector<const Object::value_type *> members{};
+                    members.reserve(obj.size());
+                    for (const auto & member : obj) members.push_back(&member);
+                    std::sort(members.begin(), members.end(), [](const auto * a, const auto * b) { return _canonicalKeyLess(a->first, b->first); });
+                    for (const auto * member : members) encodeMember(member->first, member->second);
+                }
+                else
+                {
+                    for (const auto & [key, v] : obj) encodeMember(key, v);
                 }
+
                 encoder << end;
                 break;
             }
@@ -1509,4 +1619,25 @@ namespace qc::json
 
         return encoder;
     }
+
+    #ifdef QC_JSON_COMPILED
+    // Instantiated once in `qc-json.cpp` by the `qc-json-compiled` library rather than in every translation unit
+    extern template class _Decoder<_Composer, _Composer::State>;
+    extern template void _Decoder<_Composer, _Composer::State>::_ingestInteger<false>(size_t, _Composer::State &);
+    extern template void _Decoder<_Composer, _Composer::State>::_ingestInteger<true>(size_t, _Composer::State &);
+    extern template string_view _Decoder<_Composer, _Composer::State>::_consumeString<false>(char, _Composer::State &);
+    extern template DecodeResult _decode(string_view, _Composer &, _Composer::State &, _InputSource *);
+    extern template void decode<_Composer, _Composer::State>(string_view, _Composer &, _Composer::State &);
+    extern template DecodeResult tryDecode<_Composer, _Composer::State>(string_view, _Composer &, _Composer::State &);
+    extern template void Encoder::_val(string_view);
+    extern template void Encoder::_val(int64_t);
+    extern template void Encoder::_val(uint64_t);
+    extern template void Encoder::_val(double);
+    extern template void Encoder::_val(bool);
+    extern template void Encoder::_val(std::nullptr_t);
+    extern template void Encoder::_val(_BinaryToken);
+    extern template void Encoder::_val(_OctalToken);
+    extern template void Encoder::_val(_HexToken);
+    extern template void Encoder::_val(_Base64Token);
+    #endif
 }
@@ -0,0 +1,96 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <qc-json-cache.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::DecodeCache;
+using qc::json::DecodeError;
+using qc::json::Value;
+
+TEST(cache, hitsAndMisses)
+{
+    DecodeCache cache{1024u};
+    const std::shared_ptr<const Value> v1{cache.decode(R"({ "a": [1, 2, 3] })")};
+    EXPECT_EQ(0u, cache.hits());
+    EXPECT_EQ(1u, cache.misses());
+    EXPECT_EQ(1, v1->asObject().at("a").asArray().front());
+
+    const std::shared_ptr<const Value> v2{cache.decode(R"({ "a": [1, 2, 3] })")};
+    EXPECT_EQ(v1, v2);
+    EXPECT_EQ(1u, cache.hits());
+    EXPECT_EQ(1u, cache.misses());
+
+    // Formatting differences are different strings
+    const std::shared_ptr<const Value> v3{cache.decode(R"({"a":[1,2,3]})")};
+    EXPECT_NE(v1, v3);
+    EXPECT_EQ(*v1, *v3);
+    EXPECT_EQ(1u, cache.hits());
+    EXPECT_EQ(2u, cache.misses());
+    EXPECT_EQ(2u, cache.count());
+}
+
+TEST(cache, eviction)
+{
+    DecodeCache cache{10u};
+    cache.decode("[1, 2]"); // 6 bytes
+    cache.decode("[3]"); // 3 bytes
+    EXPECT_EQ(9u, cache.size());
+    EXPECT_EQ(2u, cache.count());
+
+    // Touch the first so the second is least recently used
+    cache.decode("[1, 2]");
+    EXPECT_EQ(1u, cache.hits());
+
+    cache.decode("[4]");
+    EXPECT_EQ(9u, cache.size());
+    EXPECT_EQ(2u, cache.count());
+    cache.decode("[1, 2]");
+    EXPECT_EQ(2u, cache.hits());
+    cache.decode("[3]");
+    EXPECT_EQ(2u, cache.hits());
+
+    // Too large to cache at all
+    const std::shared_ptr<const Value> v{cache.decode("[1, 2, 3, 4]")};
+    EXPECT_EQ(4u, v->asArray().size());
+    EXPECT_LE(cache.size(), 10u);
+    cache.decode("[1, 2, 3, 4]");
+    EXPECT_EQ(2u, cache.hits());
+
+    // Evicted values remain valid
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.count());
+    EXPECT_EQ(4u, v->asArray().size());
+}
+
+TEST(cache, errors)
+{
+    DecodeCache cache{1024u};
+    EXPECT_THROW(cache.decode("[1, 2"), DecodeError);
+    EXPECT_THROW(cache.decode("[1, 2"), DecodeError);
+    EXPECT_EQ(0u, cache.count());
+    EXPECT_EQ(0u, cache.hits());
+}
+
+TEST(cache, threads)
+{
+    DecodeCache cache{1024u};
+    std::vector<std::thread> threads{};
+    for (int t{0}; t < 4; ++t)
+    {
+        threads.emplace_back([&cache]() {
+            for (int i{0}; i < 1000; ++i)
+            {
+                EXPECT_EQ(i % 10, cache.decode("[" + std::to_string(i % 10) + "]")->asArray().front());
+            }
+        });
+    }
+    for (std::thread & thread : threads) thread.join();
+    EXPECT_EQ(4000u, cache.hits() + cache.misses());
+    EXPECT_EQ(10u, cache.count());
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include <qc-json.hpp>
+
+#ifndef QC_JSON_COMPILED
+    #error "This test must be linked with the `qc-json-compiled` library"
+#endif
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Density;
+using qc::json::Encoder;
+using qc::json::Value;
+using namespace qc::json::tokens;
+
+TEST(compiled, dom)
+{
+    const std::string json{R"({"a":[1,-2,18446744073709551615,2.5,"x",true,null],"b":{}})"};
+    const Value val{qc::json::decode(json)};
+    EXPECT_EQ(json, qc::json::encode(val, Density::nospace));
+
+    Value root{};
+    const qc::json::DecodeResult result{qc::json::tryDecode(R"({"a": 1,, })"sv, root)};
+    EXPECT_FALSE(result);
+    EXPECT_EQ(8u, result.position);
+}
+
+TEST(compiled, encoder)
+{
+    Encoder encoder{Density::nospace};
+    encoder << array << "a"sv << -1 << 1u << 0.5 << false << nullptr << binary(2u) << octal(8u) << hex(16u) << end;
+    EXPECT_EQ(R"(["a",-1,1,0.5,false,null,0b10,0o10,0x10])"s, encoder.finish());
+}
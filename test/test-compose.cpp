@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <qc-json-compose.hpp>
+#include <qc-json-schema.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Density;
+using qc::json::Tee;
+using qc::json::Filter;
+using qc::json::Map;
+using qc::json::decode;
+
+// Records every event as a compact string
+struct Recorder
+{
+    std::string str{};
+
+    std::nullptr_t object(std::nullptr_t & /*outerState*/) { str += '{'; return nullptr; }
+    std::nullptr_t array(std::nullptr_t & /*outerState*/) { str += '['; return nullptr; }
+    void end(const Density /*density*/, std::nullptr_t && /*innerState*/, std::nullptr_t & /*outerState*/) { str += '.'; }
+    void key(const std::string_view key, std::nullptr_t & /*state*/) { str += key; str += ':'; }
+    void val(const std::string_view val, std::nullptr_t & /*state*/) { str += '"'; str += val; str += "\" "; }
+    void val(const int64_t val, std::nullptr_t & /*state*/) { str += std::to_string(val) + "i "; }
+    void val(const uint64_t val, std::nullptr_t & /*state*/) { str += std::to_string(val) + "u "; }
+    void val(const double val, std::nullptr_t & /*state*/) { str += std::to_string(int(val)) + "f "; }
+    void val(const bool val, std::nullptr_t & /*state*/) { str += val ? "true " : "false "; }
+    void val(const std::nullptr_t, std::nullptr_t & /*state*/) { str += "null "; }
+    void comment(const std::string_view comment, std::nullptr_t & /*state*/) { str += "/*"; str += comment; str += "*/"; }
+};
+
+// Counts container depth in its state to check that state is threaded correctly
+struct DepthCounter : qc::json::DummyComposer<int>
+{
+    int maxDepth{0};
+    int ends{0};
+
+    int object(int & outerState) { maxDepth = std::max(maxDepth, outerState + 1); return outerState + 1; }
+    int array(int & outerState) { maxDepth = std::max(maxDepth, outerState + 1); return outerState + 1; }
+    void end(const Density /*density*/, int && innerState, int & outerState) { ends += innerState == outerState + 1; }
+};
+
+static constexpr std::string_view json{R"({ "a": [1, 2.5, true], /*c*/ "b": { "c": "x", "d": null }, "e": 18446744073709551615 })"};
+
+static constexpr std::string_view recorded{R"({a:[1i 2f true ./*c*/b:{c:"x" d:null .e:18446744073709551615u .)"};
+
+TEST(compose, composerState)
+{
+    EXPECT_TRUE((std::is_same_v<qc::json::ComposerState<Recorder>, std::nullptr_t>));
+    EXPECT_TRUE((std::is_same_v<qc::json::ComposerState<DepthCounter>, int>));
+    EXPECT_TRUE((std::is_same_v<qc::json::ComposerState<qc::json::Validator>, qc::json::Validator::State>));
+}
+
+TEST(compose, tee)
+{
+    Recorder recorder1{};
+    Recorder recorder2{};
+    Tee tee{recorder1, recorder2};
+    decode(json, tee, decltype(tee)::State{nullptr, nullptr});
+    EXPECT_EQ(recorded, recorder1.str);
+    EXPECT_EQ(recorded, recorder2.str);
+}
+
+TEST(compose, teeState)
+{
+    DepthCounter counter{};
+    Recorder recorder{};
+    Tee tee{counter, recorder};
+    decode(R"([[[]], {"a": [{}]}])"sv, tee, decltype(tee)::State{0, nullptr});
+    EXPECT_EQ(4, counter.maxDepth);
+    EXPECT_EQ(6, counter.ends);
+    EXPECT_EQ("[[[..{a:[{...."s, recorder.str);
+}
+
+TEST(compose, teeNested)
+{
+    Recorder recorder1{};
+    Recorder recorder2{};
+    Recorder recorder3{};
+    Tee inner{recorder2, recorder3};
+    Tee tee{recorder1, inner};
+    decode(json, tee, decltype(tee)::State{nullptr, {nullptr, nullptr}});
+    EXPECT_EQ(recorded, recorder1.str);
+    EXPECT_EQ(recorded, recorder2.str);
+    EXPECT_EQ(recorded, recorder3.str);
+}
+
+TEST(compose, teeValidator)
+{
+    const qc::json::Schema schema{decode(R"({ type: "array", items: { type: "integer" } })"sv)};
+    qc::json::Validator validator{schema};
+    Recorder recorder{};
+    Tee tee{validator, recorder};
+    EXPECT_NO_THROW(decode("[1, 2]"sv, tee, decltype(tee)::State{}));
+    EXPECT_EQ("[1i 2i ."s, recorder.str);
+    EXPECT_THROW(decode("[1, true]"sv, tee, decltype(tee)::State{}), qc::json::ValidationError);
+}
+
+TEST(compose, filter)
+{
+    { // Keep everything
+        Recorder recorder{};
+        Filter filter{recorder, [](const std::vector<std::string> &) { return true; }};
+        decode(json, filter, decltype(filter)::State{nullptr});
+        EXPECT_EQ(recorded, recorder.str);
+    }
+    { // Drop root
+        Recorder recorder{};
+        Filter filter{recorder, [](const std::vector<std::string> & path) { return !path.empty(); }};
+        decode(json, filter, decltype(filter)::State{nullptr});
+        EXPECT_EQ(""s, recorder.str);
+    }
+    { // Drop object member subtree
+        Recorder recorder{};
+        Filter filter{recorder, [](const std::vector<std::string> & path) { return path != std::vector<std::string>{"b"}; }};
+        decode(json, filter, decltype(filter)::State{nullptr});
+        EXPECT_EQ(R"({a:[1i 2f true ./*c*/e:18446744073709551615u .)"s, recorder.str);
+    }
+    { // Drop array elements by index
+        Recorder recorder{};
+        Filter filter{recorder, [](const std::vector<std::string> & path) { return path.size() != 2u || path[1] != "1"; }};
+        decode(json, filter, decltype(filter)::State{nullptr});
+        EXPECT_EQ(R"({a:[1i true ./*c*/b:{c:"x" d:null .e:18446744073709551615u .)"s, recorder.str);
+    }
+    { // Drop nested scalar
+        Recorder recorder{};
+        Filter filter{recorder, [](const std::vector<std::string> & path) { return path.size() != 2u || path[0] != "b" || path[1] != "d"; }};
+        decode(json, filter, decltype(filter)::State{nullptr});
+        EXPECT_EQ(R"({a:[1i 2f true ./*c*/b:{c:"x" .e:18446744073709551615u .)"s, recorder.str);
+    }
+}
+
+TEST(compose, filterPaths)
+{
+    Recorder recorder{};
+    std::vector<std::string> paths{};
+    Filter filter{recorder, [&](const std::vector<std::string> & path) {
+        std::string str{};
+        for (const std::string & element : path) str += '/' + element;
+        paths.push_back(str);
+        return path.empty() || path[0] != "x";
+    }};
+    decode(R"({"x": [1, 2], "y": [3, [4]], "": 5})"sv, filter, decltype(filter)::State{nullptr});
+    EXPECT_EQ((std::vector<std::string>{""s, "/x"s, "/y"s, "/y/0"s, "/y/1"s, "/y/1/0"s, "/"s}), paths);
+    EXPECT_EQ("{y:[3i [4i ..:5i ."s, recorder.str);
+}
+
+// Changes the type of strings, booleans, and nulls
+struct TypeChanger
+{
+    std::string operator()(const std::same_as<std::string_view> auto v) const { return std::string{v} + std::string{v}; }
+    unsigned int operator()(const std::same_as<bool> auto v) const { return v ? 7u : 0u; }
+    float operator()(const std::same_as<std::nullptr_t> auto) const { return 3.0f; }
+};
+
+TEST(compose, map)
+{
+    { // Identity
+        Recorder recorder{};
+        Map map{recorder, [](const std::same_as<std::nullptr_t> auto v) { return v; }};
+        decode(json, map, nullptr);
+        EXPECT_EQ(recorded, recorder.str);
+    }
+    { // Integers doubled, other types unchanged
+        Recorder recorder{};
+        Map map{recorder, [](const std::same_as<int64_t> auto v) { return v * 2; }};
+        decode(json, map, nullptr);
+        EXPECT_EQ(R"({a:[2i 2f true ./*c*/b:{c:"x" d:null .e:18446744073709551615u .)"s, recorder.str);
+    }
+    { // Type changes
+        Recorder recorder{};
+        Map map{recorder, TypeChanger{}};
+        decode(json, map, nullptr);
+        EXPECT_EQ(R"({a:[1i 2f 7u ./*c*/b:{c:"xx" d:3f .e:18446744073709551615u .)"s, recorder.str);
+    }
+    { // Stacked with filter
+        Recorder recorder{};
+        Map map{recorder, [](const std::same_as<int64_t> auto v) { return -v; }};
+        Filter filter{map, [](const std::vector<std::string> & path) { return path.size() < 2u; }};
+        decode(json, filter, decltype(filter)::State{nullptr});
+        EXPECT_EQ("{a:[./*c*/b:{.e:18446744073709551615u ."s, recorder.str);
+    }
+}
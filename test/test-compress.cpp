@@ -0,0 +1,299 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <qc-json.hpp>
+#include <qc-json-compress.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Compression;
+using qc::json::CompressionError;
+using qc::json::DecodeError;
+
+struct StringSink : qc::json::Sink
+{
+    std::string str{};
+    size_t writes{0u};
+    size_t finishes{0u};
+
+    void write(const std::string_view chunk) override { str += chunk; ++writes; }
+    void finish() override { ++finishes; }
+};
+
+// Records every composer call so that decodes can be compared exactly
+struct LogComposer : qc::json::DummyComposer<>
+{
+    std::vector<std::string> log{};
+
+    std::nullptr_t object(std::nullptr_t & /*outerState*/) { log.push_back("{"s); return nullptr; }
+    std::nullptr_t array(std::nullptr_t & /*outerState*/) { log.push_back("["s); return nullptr; }
+    void end(const qc::json::Density /*density*/, std::nullptr_t && /*innerState*/, std::nullptr_t & /*outerState*/) { log.push_back("end"s); }
+    void key(const std::string_view key, std::nullptr_t & /*state*/) { log.push_back("key "s += key); }
+    void val(const std::string_view val, std::nullptr_t & /*state*/) { log.push_back("str "s += val); }
+    void val(const int64_t val, std::nullptr_t & /*state*/) { log.push_back("int "s += std::to_string(val)); }
+    void val(const uint64_t val, std::nullptr_t & /*state*/) { log.push_back("uint "s += std::to_string(val)); }
+    void val(const double val, std::nullptr_t & /*state*/) { log.push_back("float "s += std::to_string(val)); }
+    void val(const bool val, std::nullptr_t & /*state*/) { log.push_back(val ? "true"s : "false"s); }
+    void val(std::nullptr_t, std::nullptr_t & /*state*/) { log.push_back("null"s); }
+    void comment(const std::string_view comment, std::nullptr_t & /*state*/) { log.push_back("comment "s += comment); }
+};
+
+class CompressTest : public testing::TestWithParam<Compression>
+{
+    protected: //---------------------------------------------------------------
+
+    std::filesystem::path path{std::filesystem::temp_directory_path() / "qc-json-compress-test.bin"};
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    // Something large and repetitive enough to span many buffers both compressed and not
+    static qc::json::Value makeValue()
+    {
+        qc::json::Value records{qc::json::makeArray()};
+        for (int i{0}; i < 20000; ++i)
+        {
+            records.asArray().push_back(qc::json::makeObject("id", i, "name", "record "s += std::to_string(i * 7919 % 10007), "flag", i % 3 == 0));
+        }
+        return records;
+    }
+
+    static std::unique_ptr<qc::json::Sink> makeSink(const Compression compression, qc::json::Sink & sink, const size_t bufferSize = 65536u)
+    {
+        #ifdef QC_JSON_ZLIB
+        if (compression == Compression::gzip) return std::make_unique<qc::json::GzipSink>(sink, 6, bufferSize);
+        #endif
+        #ifdef QC_JSON_ZSTD
+        if (compression == Compression::zstd) return std::make_unique<qc::json::ZstdSink>(sink, 3, bufferSize);
+        #endif
+        return nullptr;
+    }
+
+    static std::string compress(const Compression compression, const std::string_view data)
+    {
+        StringSink sink{};
+        const std::unique_ptr<qc::json::Sink> compressor{makeSink(compression, sink)};
+        compressor->write(data);
+        compressor->finish();
+        return std::move(sink.str);
+    }
+
+    void writeFile(const std::string_view data) const
+    {
+        std::ofstream file{path, std::ios::binary};
+        file.write(data.data(), std::streamsize(data.size()));
+    }
+};
+
+TEST(compress, detectCompression)
+{
+    EXPECT_EQ(Compression::gzip, qc::json::detectCompression("\x1F\x8B\x08\x00"sv));
+    EXPECT_EQ(Compression::zstd, qc::json::detectCompression("\x28\xB5\x2F\xFD\x00"sv));
+    EXPECT_EQ(Compression::none, qc::json::detectCompression("\x28\xB5\x2F"sv));
+    EXPECT_EQ(Compression::none, qc::json::detectCompression(R"({"a": 1})"sv));
+    EXPECT_EQ(Compression::none, qc::json::detectCompression(""sv));
+    EXPECT_EQ("[1, 2]"s, qc::json::decompress("[1, 2]"sv));
+    EXPECT_THROW(qc::json::Decompressor{Compression::none}, CompressionError);
+}
+
+TEST_P(CompressTest, encodeDecode)
+{
+    const qc::json::Value value{makeValue()};
+    const std::string json{qc::json::encode(value)};
+
+    StringSink sink{};
+    const std::unique_ptr<qc::json::Sink> compressor{makeSink(GetParam(), sink, 4096u)};
+    qc::json::Encoder encoder{};
+    encoder.setSink(compressor.get(), 1000u);
+    encoder << value;
+    EXPECT_TRUE(encoder.finish().empty());
+
+    // Output was streamed in pieces, and much smaller
+    EXPECT_EQ(1u, sink.finishes);
+    EXPECT_GT(sink.writes, 1u);
+    EXPECT_LT(sink.str.size(), json.size() / 4u);
+    EXPECT_EQ(GetParam(), qc::json::detectCompression(sink.str));
+
+    EXPECT_EQ(json, qc::json::decompress(sink.str));
+    EXPECT_EQ(value, qc::json::decode(qc::json::decompress(sink.str)));
+}
+
+TEST_P(CompressTest, chunked)
+{
+    const std::string json{qc::json::encode(makeValue())};
+    const std::string compressed{compress(GetParam(), json)};
+
+    // Any split of the compressed data yields the same output
+    for (const size_t chunkSize : {1u, 7u, 4096u, 100000u})
+    {
+        qc::json::Decompressor decompressor{GetParam()};
+        std::string out{};
+        for (size_t pos{0u}; pos < compressed.size(); pos += chunkSize)
+        {
+            decompressor.update(std::string_view{compressed}.substr(pos, chunkSize), out);
+        }
+        decompressor.finish();
+        EXPECT_EQ(json, out);
+    }
+}
+
+TEST_P(CompressTest, concatenated)
+{
+    // Each finish starts a new gzip member or zstd frame
+    StringSink sink{};
+    const std::unique_ptr<qc::json::Sink> compressor{makeSink(GetParam(), sink)};
+    qc::json::Encoder encoder{};
+    encoder.setSink(compressor.get());
+    encoder << qc::json::array(qc::json::Density::uniline) << 1 << 2 << qc::json::end;
+    static_cast<void>(encoder.finish());
+    encoder << "abc";
+    static_cast<void>(encoder.finish());
+    EXPECT_EQ(2u, sink.finishes);
+
+    EXPECT_EQ(R"([ 1, 2 ]"abc")"s, qc::json::decompress(sink.str));
+
+    // Plain concatenation of separately compressed streams
+    EXPECT_EQ("abcdef"s, qc::json::decompress(compress(GetParam(), "abc"sv) += compress(GetParam(), "def"sv)));
+    EXPECT_EQ(""s, qc::json::decompress(compress(GetParam(), ""sv)));
+}
+
+TEST_P(CompressTest, invalid)
+{
+    const std::string compressed{compress(GetParam(), "[1, 2, 3, 4, 5, 6, 7, 8, 9]"sv)};
+
+    { // Truncated
+        qc::json::Decompressor decompressor{GetParam()};
+        std::string out{};
+        decompressor.update(std::string_view{compressed}.substr(0u, compressed.size() - 5u), out);
+        EXPECT_THROW(decompressor.finish(), CompressionError);
+    }
+    { // Nothing at all
+        qc::json::Decompressor decompressor{GetParam()};
+        EXPECT_THROW(decompressor.finish(), CompressionError);
+    }
+    { // Corrupt
+        std::string corrupt{compressed};
+        corrupt[corrupt.size() / 2u] ^= 0x5A;
+        corrupt[corrupt.size() / 2u + 1u] ^= 0xA5;
+        corrupt.resize(corrupt.size() - 1u);
+        EXPECT_THROW(qc::json::decompress(corrupt), CompressionError);
+    }
+    { // Trailing garbage
+        EXPECT_THROW(qc::json::decompress(compressed + "garbage"), CompressionError);
+    }
+}
+
+TEST_P(CompressTest, readCompressed)
+{
+    const std::string json{qc::json::encode(makeValue())};
+
+    writeFile(compress(GetParam(), json));
+    EXPECT_EQ(json, qc::json::readCompressed(path));
+
+    // Uncompressed files are read as is
+    writeFile(json);
+    EXPECT_EQ(json, qc::json::readCompressed(path));
+
+    writeFile(""sv);
+    EXPECT_EQ(""s, qc::json::readCompressed(path));
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(qc::json::readCompressed(path), CompressionError);
+}
+
+TEST_P(CompressTest, large)
+{
+    // Barely compressible, so that the output grows by many steps per compressed chunk. A multiple of the step size so
+    // that the output is exactly filled at the end of the stream
+    std::string data(size_t{24u} << 20, '\0');
+    uint64_t state{1u};
+    for (char & c : data)
+    {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        c = char('a' + (state >> 33) % 26u);
+    }
+
+    const std::string compressed{compress(GetParam(), data)};
+    EXPECT_EQ(data, qc::json::decompress(compressed));
+
+    writeFile(compressed);
+    EXPECT_EQ(data, qc::json::readCompressed(path));
+}
+
+TEST_P(CompressTest, decodeCompressed)
+{
+    // Several decompression steps' worth, with comments, strings, and a string longer than the window all crossing step
+    // boundaries
+    std::string json{"[\n"};
+    for (int i{0}; i < 60000; ++i)
+    {
+        json += R"({"id": )" + std::to_string(i) + R"(, "name": "record \"{)" + std::to_string(i) + R"(}\"", 'tags': ["a", /* ], */ "d:e,f"]}, )";
+        if (i % 1000 == 0)
+        {
+            json += "\n// A comment [with] \"brackets\",\n// continued over {two} lines\n";
+        }
+        if (i == 30000)
+        {
+            json += '"' + std::string(size_t{5u} << 20, 'x') + "\", ";
+        }
+    }
+    json += "\n] // Done";
+
+    LogComposer expected{};
+    qc::json::decode(json, expected, nullptr);
+
+    writeFile(compress(GetParam(), json));
+    LogComposer actual{};
+    qc::json::decodeCompressed(path, actual, nullptr, 0u);
+    EXPECT_EQ(expected.log, actual.log);
+
+    EXPECT_EQ(qc::json::decode(json), qc::json::decodeCompressed(path));
+
+    // Uncompressed files are read as is
+    writeFile(json);
+    actual.log.clear();
+    qc::json::decodeCompressed(path, actual, nullptr, 0u);
+    EXPECT_EQ(expected.log, actual.log);
+
+    writeFile(compress(GetParam(), R"({"a": [1, 2.5, "three", {"four": null}], "b": true})"sv));
+    EXPECT_EQ(qc::json::decode(R"({"a": [1, 2.5, "three", {"four": null}], "b": true})"sv), qc::json::decodeCompressed(path));
+
+    // Errors from either decompressing or decoding come through
+    const std::string compressed{compress(GetParam(), json)};
+    writeFile(std::string_view{compressed}.substr(0u, compressed.size() / 2u));
+    EXPECT_THROW(qc::json::decodeCompressed(path, 0u), CompressionError);
+
+    writeFile(compress(GetParam(), "[1, 2,, 3]"sv));
+    EXPECT_THROW(qc::json::decodeCompressed(path), DecodeError);
+
+    writeFile(compress(GetParam(), json + "\n]"));
+    EXPECT_THROW(qc::json::decodeCompressed(path, 0u), DecodeError);
+
+    writeFile(""sv);
+    EXPECT_THROW(qc::json::decodeCompressed(path), DecodeError);
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(qc::json::decodeCompressed(path), CompressionError);
+}
+
+static std::vector<Compression> _compressions()
+{
+    std::vector<Compression> compressions{};
+    #ifdef QC_JSON_ZLIB
+    compressions.push_back(Compression::gzip);
+    #endif
+    #ifdef QC_JSON_ZSTD
+    compressions.push_back(Compression::zstd);
+    #endif
+    return compressions;
+}
+
+INSTANTIATE_TEST_SUITE_P(compress, CompressTest, testing::ValuesIn(_compressions()), [](const auto & info) { return info.param == Compression::gzip ? "gzip"s : "zstd"s; });
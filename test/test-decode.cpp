@@ -3,6 +3,7 @@
 #include <deque>
 #include <format>
 #include <variant>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -701,6 +702,18 @@ TEST(decode, floater)
         decode(R"(18446744073709551616)", composer, nullptr);
         EXPECT_TRUE(composer.isDone());
     }
+    { // Very long integer
+        ExpectantComposer composer{};
+        composer.expectFloater(1e30);
+        decode(R"(1000000000000000000000000000000)", composer, nullptr);
+        EXPECT_TRUE(composer.isDone());
+        composer.expectFloater(-1e30);
+        decode(R"(-1000000000000000000000000000000.000)", composer, nullptr);
+        EXPECT_TRUE(composer.isDone());
+        composer.expectSignedInteger(7);
+        decode(R"(0000000000000000000000000000007)", composer, nullptr);
+        EXPECT_TRUE(composer.isDone());
+    }
     { // Leading decimal
         ExpectantComposer composer{};
         composer.expectFloater(0.456);
@@ -1098,6 +1111,20 @@ R"({ // AAAAA
         decode("/*///*** /* //** ** /*/ 0"sv, composer, nullptr);
         EXPECT_TRUE(composer.isDone());
     }
+    { // Very many continued lines
+        std::string json{};
+        std::string expected{};
+        for (int i{0}; i < 100000; ++i)
+        {
+            json += "// A\n";
+            expected += i ? "\nA" : "A";
+        }
+        json += '0';
+        ExpectantComposer composer{};
+        composer.expectComment(expected).expectSignedInteger(0);
+        decode(json, composer, nullptr);
+        EXPECT_TRUE(composer.isDone());
+    }
     { // Nothing but comments
         EXPECT_THROW(decode("// AAAAA\n/* BBBBB */ // CCCCC\n"sv, dummyComposer, nullptr), DecodeError);
     }
@@ -1336,6 +1363,177 @@ TEST(decode, misc)
     }
 }
 
+TEST(decode, composeError)
+{
+    struct RejectingComposer : qc::json::DummyComposer<>
+    {
+        using DummyComposer::val;
+        void val(const bool /*val*/, std::nullptr_t & /*state*/) { throw qc::json::ComposeError{"No booleans"sv}; }
+    };
+
+    RejectingComposer composer{};
+    EXPECT_NO_THROW(decode(R"([1, "a", null])"sv, composer, nullptr));
+    try
+    {
+        decode(R"([1, true, null])"sv, composer, nullptr);
+        FAIL();
+    }
+    catch (const qc::json::ComposeError & e)
+    {
+        EXPECT_EQ("No booleans"s, e.what());
+        EXPECT_EQ(8u, e.position);
+    }
+}
+
+TEST(decode, stringChunks)
+{
+    struct ChunkComposer : qc::json::DummyComposer<>
+    {
+        std::vector<std::string> strings{};
+        std::vector<size_t> chunkSizes{};
+        std::vector<std::string> keys{};
+        bool open{false};
+
+        void key(const std::string_view key, std::nullptr_t & /*state*/) { keys.emplace_back(key); }
+        void stringBegin(std::nullptr_t & /*state*/) { EXPECT_FALSE(open); open = true; strings.emplace_back(); }
+        void stringChunk(const std::string_view chunk, std::nullptr_t & /*state*/) { EXPECT_TRUE(open); strings.back() += chunk; chunkSizes.push_back(chunk.size()); }
+        void stringEnd(std::nullptr_t & /*state*/) { EXPECT_TRUE(open); open = false; }
+    };
+
+    const size_t chunkSize{qc::json::stringChunkSize};
+
+    { // Small strings are a single chunk, and empty strings have none
+        ChunkComposer composer{};
+        decode(R"({"k": "abc", "e": ""})"sv, composer, nullptr);
+        EXPECT_EQ((std::vector{"abc"s, ""s}), composer.strings);
+        EXPECT_EQ((std::vector{size_t{3u}}), composer.chunkSizes);
+        EXPECT_EQ((std::vector{"k"s, "e"s}), composer.keys);
+    }
+    { // Large string with escapes
+        std::string expected{};
+        std::string json{"[\""};
+        for (size_t i{0u}; expected.size() < chunkSize * 2u + 100u; ++i)
+        {
+            if (i % 1000u == 0u)
+            {
+                expected += '\n';
+                json += "\\n"sv;
+            }
+            else
+            {
+                expected += char('a' + i % 26u);
+                json += char('a' + i % 26u);
+            }
+        }
+        json += "\"]"sv;
+
+        ChunkComposer composer{};
+        decode(json, composer, nullptr);
+        ASSERT_EQ(1u, composer.strings.size());
+        EXPECT_EQ(expected, composer.strings.front());
+        EXPECT_EQ((std::vector{chunkSize, chunkSize, size_t{100u}}), composer.chunkSizes);
+        EXPECT_FALSE(composer.open);
+    }
+    { // Unterminated string is never ended
+        ChunkComposer composer{};
+        EXPECT_THROW(decode("\"" + std::string(chunkSize + 1u, 'a'), composer, nullptr), DecodeError);
+        EXPECT_EQ((std::vector{chunkSize}), composer.chunkSizes);
+        EXPECT_TRUE(composer.open);
+    }
+}
+
+TEST(decode, base64)
+{
+    // Strings are base64 only under the `b64` key
+    struct Base64Composer : qc::json::DummyComposer<>
+    {
+        std::string currentKey{};
+        std::vector<std::string> bytes{};
+        std::vector<std::string> strings{};
+
+        using DummyComposer::val;
+        void key(const std::string_view key, std::nullptr_t & /*state*/) { currentKey = key; }
+        bool isBase64(std::nullptr_t & /*state*/) { return currentKey == "b64"sv; }
+        void val(const std::span<const std::byte> val, std::nullptr_t & /*state*/) { bytes.emplace_back(reinterpret_cast<const char *>(val.data()), val.size()); }
+        void val(const std::string_view val, std::nullptr_t & /*state*/) { strings.emplace_back(val); }
+    };
+
+    { // RFC 4648 test vectors, padded and not
+        Base64Composer composer{};
+        decode(R"({"b64": "", "b64": "Zg==", "b64": "Zm8=", "b64": "Zm9v", "b64": "Zm9vYg==", "b64": "Zm9vYmE=", "b64": "Zm9vYmFy", "s": "Zm9v", "b64": "Zg", "b64": 'Zm8'})"sv, composer, nullptr);
+        EXPECT_EQ((std::vector{""s, "f"s, "fo"s, "foo"s, "foob"s, "fooba"s, "foobar"s, "f"s, "fo"s}), composer.bytes);
+        EXPECT_EQ((std::vector{"Zm9v"s}), composer.strings);
+    }
+    { // Escapes
+        Base64Composer composer{};
+        decode(R"({"b64": "\/+8="})"sv, composer, nullptr);
+        EXPECT_EQ((std::vector{"\xFF\xEF"s}), composer.bytes);
+    }
+    { // Long enough for the vectorized path, covering every byte value
+        static constexpr std::string_view chars{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+        for (size_t length{0u}; length < 100u; ++length)
+        {
+            std::string data{};
+            for (size_t i{0u}; i < length; ++i) data += char(i * 97u + length);
+
+            std::string json{R"({"b64": ")"};
+            for (size_t i{0u}; i < length; i += 3u)
+            {
+                const uint32_t v{uint32_t(uint8_t(data[i])) << 16 | (i + 1u < length ? uint32_t(uint8_t(data[i + 1u])) << 8 : 0u) | (i + 2u < length ? uint32_t(uint8_t(data[i + 2u])) : 0u)};
+                json += chars[v >> 18];
+                json += chars[(v >> 12) & 0x3Fu];
+                json += i + 1u < length ? chars[(v >> 6) & 0x3Fu] : '=';
+                json += i + 2u < length ? chars[v & 0x3Fu] : '=';
+            }
+            json += R"("})";
+
+            Base64Composer composer{};
+            decode(json, composer, nullptr);
+            ASSERT_EQ(1u, composer.bytes.size());
+            EXPECT_EQ(data, composer.bytes.front());
+        }
+    }
+    { // Invalid
+        Base64Composer composer{};
+        for (const std::string_view b64 : {"Z"sv, "Zm9vY"sv, "Zm9v!"sv, "Zg=a"sv, "Zg==Zm9v"sv, "==="sv, "Zm9vYmFyZm9vYmFyZm9vYmFy\x01m9v"sv, "Zm9vYmFyZm9vYmFyZm9vYmFyZm9vYm=y"sv})
+        {
+            try
+            {
+                decode(R"({"b64": ")"s.append(b64).append(R"("})"), composer, nullptr);
+                ADD_FAILURE() << b64;
+            }
+            catch (const DecodeError & e)
+            {
+                EXPECT_EQ("Invalid base64"s, e.what());
+                EXPECT_EQ(8u, e.position);
+            }
+        }
+        EXPECT_THROW(decode(R"({"b64": "Zm9v)"sv, composer, nullptr), DecodeError);
+    }
+}
+
+TEST(decode, tryDecode)
+{
+    struct RejectingComposer : qc::json::DummyComposer<>
+    {
+        using DummyComposer::val;
+        void val(const bool /*val*/, std::nullptr_t & /*state*/) { throw qc::json::ComposeError{"No booleans"sv}; }
+    };
+
+    RejectingComposer composer{};
+    EXPECT_TRUE(qc::json::tryDecode(R"([1, "a", null])"sv, composer, nullptr));
+
+    qc::json::DecodeResult result{qc::json::tryDecode(R"([1, "a" null])"sv, composer, nullptr)};
+    EXPECT_FALSE(result);
+    EXPECT_EQ("Expected `,`"s, result.message);
+    EXPECT_EQ(8u, result.position);
+
+    result = qc::json::tryDecode(R"([1, true, null])"sv, composer, nullptr);
+    EXPECT_FALSE(result);
+    EXPECT_EQ("No booleans"s, result.message);
+    EXPECT_EQ(8u, result.position);
+}
+
 TEST(decode, general)
 {
     ExpectantComposer composer{};
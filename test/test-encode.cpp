@@ -403,6 +403,65 @@ TEST(encode, binary)
     }
 }
 
+TEST(encode, base64)
+{
+    const auto bytes{[](const std::string_view str) { return std::as_bytes(std::span{str}); }};
+
+    { // RFC 4648 test vectors
+        Encoder encoder{Density::uniline};
+        encoder << array;
+        for (const std::string_view str : {""sv, "f"sv, "fo"sv, "foo"sv, "foob"sv, "fooba"sv, "foobar"sv}) encoder << base64(bytes(str));
+        encoder << end;
+        EXPECT_EQ(R"([ "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" ])"s, encoder.finish());
+    }
+    { // Single quotes
+        Encoder encoder{Density::uniline, 4u, true};
+        encoder << base64(bytes("\xFF\xEF"sv));
+        EXPECT_EQ("'/+8='"s, encoder.finish());
+    }
+    { // Long enough for the vectorized path, covering every byte value, against a simple reference
+        static constexpr std::string_view chars{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+        for (size_t length{0u}; length < 100u; ++length)
+        {
+            std::string data{};
+            for (size_t i{0u}; i < length; ++i) data += char(i * 97u + length);
+
+            std::string expected{"\""};
+            for (size_t i{0u}; i < length; i += 3u)
+            {
+                const uint32_t v{uint32_t(uint8_t(data[i])) << 16 | (i + 1u < length ? uint32_t(uint8_t(data[i + 1u])) << 8 : 0u) | (i + 2u < length ? uint32_t(uint8_t(data[i + 2u])) : 0u)};
+                expected += chars[v >> 18];
+                expected += chars[(v >> 12) & 0x3Fu];
+                expected += i + 1u < length ? chars[(v >> 6) & 0x3Fu] : '=';
+                expected += i + 2u < length ? chars[v & 0x3Fu] : '=';
+            }
+            expected += '"';
+
+            Encoder encoder{};
+            encoder << base64(bytes(data));
+            EXPECT_EQ(expected, encoder.finish());
+        }
+    }
+    { // Flushed to the sink as it goes
+        struct SizeSink : qc::json::Sink
+        {
+            std::string str{};
+            size_t maxWrite{0u};
+
+            void write(std::string_view chunk) override { str += chunk; maxWrite = std::max(maxWrite, chunk.size()); }
+        };
+
+        const std::string data(30000u, '\0');
+        SizeSink sink{};
+        Encoder encoder{};
+        encoder.setSink(&sink, 1024u);
+        encoder << base64(bytes(data));
+        encoder.finish();
+        EXPECT_EQ("\"" + std::string(40000u, 'A') + "\"", sink.str);
+        EXPECT_LE(sink.maxWrite, 2048u + 4u);
+    }
+}
+
 TEST(encode, floater)
 {
     { // Zero
@@ -533,6 +592,170 @@ TEST(encode, finish)
     }
 }
 
+TEST(encode, canonical)
+{
+    { // No whitespace, comments, identifiers, or single quotes
+        Encoder encoder{Density::multiline, 4u, true, true, true};
+        encoder << comment("c") << object << "a" << array << 1 << comment("c") << 2 << end << "b" << "v" << end;
+        EXPECT_EQ(R"({"a":[1,2],"b":"v"})"s, encoder.finish());
+    }
+    { // Keys must be strictly ascending
+        Encoder encoder{Density::unspecified, 4u, false, false, true};
+        encoder << object << "" << 0 << "A" << 1 << "a" << 2 << "aa" << object << "b" << 3 << end << "b" << 4 << end;
+        EXPECT_EQ(R"({"":0,"A":1,"a":2,"aa":{"b":3},"b":4})"s, encoder.finish());
+        encoder << object << "b" << 0;
+        EXPECT_THROW(encoder << "a", EncodeError);
+    }
+    { // Keys are ordered by UTF-16 code unit, so U+1F600 comes before U+FF61
+        Encoder encoder{Density::unspecified, 4u, false, false, true};
+        encoder << object << "\xED\x9F\xBF" << 0 << "\xF0\x9F\x98\x80" << 1 << "\xEF\xBD\xA1" << 2 << end;
+        EXPECT_EQ("{\"\xED\x9F\xBF\":0,\"\xF0\x9F\x98\x80\":1,\"\xEF\xBD\xA1\":2}"s, encoder.finish());
+        encoder << object << "\xEF\xBD\xA1" << 0;
+        EXPECT_THROW(encoder << "\xF0\x9F\x98\x80", EncodeError);
+    }
+    { // Duplicate keys
+        Encoder encoder{Density::unspecified, 4u, false, false, true};
+        encoder << object << "a" << 0;
+        EXPECT_THROW(encoder << "a", EncodeError);
+    }
+    { // Minimal escapes
+        Encoder encoder{Density::unspecified, 4u, false, false, true};
+        encoder << "\"\\\b\t\n\f\r\0\x1F\x7F'/\xC3\xA9"sv;
+        EXPECT_EQ("\"\\\"\\\\\\b\\t\\n\\f\\r\\u0000\\u001f\x7F'/\xC3\xA9\""s, encoder.finish());
+    }
+    { // Numbers
+        Encoder encoder{Density::unspecified, 4u, false, false, true};
+        const auto enc{[&](auto v) { encoder << v; return encoder.finish(); }};
+        EXPECT_EQ("0"s, enc(0.0));
+        EXPECT_EQ("0"s, enc(-0.0));
+        EXPECT_EQ("1"s, enc(1.0));
+        EXPECT_EQ("-1.5"s, enc(-1.5));
+        EXPECT_EQ("100000000000000000000"s, enc(1e20));
+        EXPECT_EQ("1e+21"s, enc(1e21));
+        EXPECT_EQ("1.5e+300"s, enc(1.5e300));
+        EXPECT_EQ("0.000001"s, enc(1e-6));
+        EXPECT_EQ("1e-7"s, enc(1e-7));
+        EXPECT_EQ("1.2345e-7"s, enc(1.2345e-7));
+        EXPECT_EQ("123.456"s, enc(123.456));
+        EXPECT_EQ("0.1"s, enc(0.1));
+        EXPECT_EQ("5e-324"s, enc(5e-324));
+        EXPECT_EQ("9007199254740992"s, enc(int64_t{1} << 53));
+        EXPECT_EQ("-9007199254740992"s, enc(-(int64_t{1} << 53)));
+        EXPECT_EQ("9007199254740992"s, enc((int64_t{1} << 53) + 1));
+        EXPECT_EQ("1152921504606847000"s, enc(uint64_t{1} << 60));
+        EXPECT_EQ("-9223372036854776000"s, enc(std::numeric_limits<int64_t>::min()));
+        EXPECT_EQ("18446744073709552000"s, enc(std::numeric_limits<uint64_t>::max()));
+        EXPECT_EQ("26"s, enc(hex(26u)));
+        EXPECT_EQ("26"s, enc(octal(26u)));
+        EXPECT_EQ("26"s, enc(binary(26u)));
+        EXPECT_THROW(encoder << std::numeric_limits<double>::infinity(), EncodeError);
+        EXPECT_THROW(encoder << std::numeric_limits<double>::quiet_NaN(), EncodeError);
+    }
+}
+
+TEST(encode, strict)
+{
+    Encoder encoder{Density::uniline, 4u, true, true, false, true};
+    encoder << object << "k" << array << hex(26u) << comment("c") << "\0\v\x01"sv << end << end;
+    EXPECT_EQ(R"({ "k": [ 26, "\u0000\u000b\u0001" ] })"s, encoder.finish());
+    EXPECT_THROW(encoder << std::numeric_limits<double>::infinity(), EncodeError);
+    EXPECT_THROW(encoder << std::numeric_limits<double>::quiet_NaN(), EncodeError);
+}
+
+TEST(encode, sink)
+{
+    struct ChunkSink : qc::json::Sink
+    {
+        std::string str{};
+        int writes{0};
+        bool finished{false};
+
+        void write(std::string_view chunk) override { str += chunk; ++writes; }
+        void finish() override { finished = true; }
+    };
+
+    ChunkSink sink{};
+    Encoder encoder{Density::nospace};
+    encoder.setSink(&sink, 8u);
+    encoder << array;
+    for (int i{0}; i < 100; ++i) encoder << "abc";
+    encoder << end;
+    EXPECT_GT(sink.writes, 10);
+    EXPECT_FALSE(sink.finished);
+    EXPECT_TRUE(encoder.finish().empty());
+    EXPECT_TRUE(sink.finished);
+    std::string expected{"["};
+    for (int i{0}; i < 100; ++i) expected += i ? R"(,"abc")" : R"("abc")";
+    expected += ']';
+    EXPECT_EQ(expected, sink.str);
+
+    // Back to accumulating the full string
+    encoder.setSink(nullptr);
+    encoder << 5;
+    EXPECT_EQ("5"s, encoder.finish());
+}
+
+TEST(encode, stringChunks)
+{
+    { // Same as streaming the whole string
+        Encoder encoder{Density::uniline};
+        encoder << object << "k";
+        encoder.beginString().appendString("a\"b").appendString("").appendString("\n\x01").endString();
+        encoder << "k2";
+        encoder.beginString().endString();
+        encoder << end;
+        EXPECT_EQ(R"({ "k": "a\"b\n\x01", "k2": "" })"s, encoder.finish());
+    }
+    { // Single quotes and canonical
+        Encoder encoder{Density::uniline, 4u, true};
+        encoder.beginString().appendString("'\"").endString();
+        EXPECT_EQ(R"('\'"')"s, encoder.finish());
+        Encoder canonical{Density::unspecified, 4u, false, false, true};
+        canonical << array;
+        canonical.beginString().appendString("\x01").endString();
+        canonical << end;
+        EXPECT_EQ(R"(["\u0001"])"s, canonical.finish());
+    }
+    { // Huge appends are flushed to the sink as they go
+        struct MaxSink : qc::json::Sink
+        {
+            size_t size{0u};
+            size_t maxWrite{0u};
+
+            void write(std::string_view chunk) override { size += chunk.size(); maxWrite = std::max(maxWrite, chunk.size()); }
+        };
+
+        MaxSink sink{};
+        Encoder encoder{Density::nospace};
+        encoder.setSink(&sink, 1024u);
+        encoder << array;
+        encoder.beginString().appendString(std::string(100000u, '\t')).endString();
+        encoder << end;
+        encoder.finish();
+        EXPECT_EQ(200004u, sink.size);
+        EXPECT_LE(sink.maxWrite, 2048u + 2u);
+    }
+    { // Misuse
+        Encoder encoder{};
+        EXPECT_THROW(encoder.appendString("a"), EncodeError);
+        EXPECT_THROW(encoder.endString(), EncodeError);
+        encoder << object;
+        EXPECT_THROW(encoder.beginString(), EncodeError);
+        encoder << "k";
+        encoder.beginString();
+        EXPECT_THROW(encoder << 1, EncodeError);
+        EXPECT_THROW(encoder << "a", EncodeError);
+        EXPECT_THROW(encoder << end, EncodeError);
+        EXPECT_THROW(encoder << comment("a"), EncodeError);
+        EXPECT_THROW(encoder.beginString(), EncodeError);
+        EXPECT_THROW(encoder.finish(), EncodeError);
+        encoder.endString() << end;
+        EXPECT_EQ("{\n    \"k\": \"\"\n}"s, encoder.finish());
+        encoder << 1;
+        EXPECT_THROW(encoder.beginString(), EncodeError);
+    }
+}
+
 TEST(encode, density)
 {
     { // Top level multiline
@@ -0,0 +1,205 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <qc-json-file.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::DecodeError;
+using qc::json::FileError;
+
+// Records every composer call so that decodes can be compared exactly
+struct LogComposer : qc::json::DummyComposer<>
+{
+    std::vector<std::string> log{};
+
+    std::nullptr_t object(std::nullptr_t & /*outerState*/) { log.push_back("{"s); return nullptr; }
+    std::nullptr_t array(std::nullptr_t & /*outerState*/) { log.push_back("["s); return nullptr; }
+    void end(const qc::json::Density /*density*/, std::nullptr_t && /*innerState*/, std::nullptr_t & /*outerState*/) { log.push_back("end"s); }
+    void key(const std::string_view key, std::nullptr_t & /*state*/) { log.push_back("key "s += key); }
+    void val(const std::string_view val, std::nullptr_t & /*state*/) { log.push_back("str "s += val); }
+    void val(const int64_t val, std::nullptr_t & /*state*/) { log.push_back("int "s += std::to_string(val)); }
+    void val(const uint64_t val, std::nullptr_t & /*state*/) { log.push_back("uint "s += std::to_string(val)); }
+    void val(const double val, std::nullptr_t & /*state*/) { log.push_back("float "s += std::to_string(val)); }
+    void val(const bool val, std::nullptr_t & /*state*/) { log.push_back(val ? "true"s : "false"s); }
+    void val(std::nullptr_t, std::nullptr_t & /*state*/) { log.push_back("null"s); }
+    void comment(const std::string_view comment, std::nullptr_t & /*state*/) { log.push_back("comment "s += comment); }
+};
+
+class FileTest : public testing::Test
+{
+    protected: //---------------------------------------------------------------
+
+    std::filesystem::path path{std::filesystem::temp_directory_path() / "qc-json-file-test.json"};
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    void writeFile(const std::string_view json) const
+    {
+        std::ofstream file{path, std::ios::binary};
+        file.write(json.data(), std::streamsize(json.size()));
+    }
+
+    // Checks that decoding the file gives exactly the same calls as decoding the string, for many chunk sizes
+    void expectSameAsDecode(const std::string_view json)
+    {
+        writeFile(json);
+
+        LogComposer expected{};
+        qc::json::decode(json, expected, nullptr);
+
+        for (const size_t chunkSize : {1u, 2u, 3u, 7u, 16u, 17u, 100u, 4096u, 1u << 20})
+        {
+            LogComposer actual{};
+            qc::json::decodeFile(path, actual, nullptr, chunkSize);
+            EXPECT_EQ(expected.log, actual.log) << chunkSize;
+        }
+    }
+};
+
+TEST_F(FileTest, json5)
+{
+    // Strings, comments, and numbers split across chunks in every way, with structural characters where they would
+    // mislead a lexer that did not track strings and comments
+    expectSameAsDecode(R"(
+        // A line comment with "quotes", [brackets], and a trailing slash \
+        {
+            "key": "string with \"escaped\" quotes, {braces}, [brackets], :colons:, and // slashes",
+            'single': 'it\'s "fine", ok',
+            unquoted: 0x1EE7, /* block comment with a * and a / and ] */ "after": -Infinity,
+            "continued": "line one \
+line two",
+            "nums": [0, -0, 1.5e-3, 123456789012345678, 18446744073709551615, -9223372036854775808, .5, 5., +inf, nan],
+            "lits": [true, false, null, ],
+            "nested": {"a": {"b": {"c": [[[]], {}]}}},
+            /**/ "end": "\\",
+            'end2': '\\', // trailing
+        }
+        // Done
+    )"sv);
+
+    std::string big{"["};
+    for (int i{0}; i < 20000; ++i)
+    {
+        big += R"({"id": )" + std::to_string(i) + R"(, "name": "record \")" + std::to_string(i) + R"(\"", "tags": ["a", 'b', /* c */ "d:e,f"]}, )";
+    }
+    big += "]";
+    expectSameAsDecode(big);
+
+    expectSameAsDecode(R"("just a string with no structure at all")"sv);
+    expectSameAsDecode("123456"sv);
+    expectSameAsDecode(" "s + std::string(100000u, ' ') + "true"s);
+}
+
+TEST_F(FileTest, dom)
+{
+    const std::string json{R"({"a": [1, 2.5, "three", {"four": null}], "b": true})"};
+    writeFile(json);
+    EXPECT_EQ(qc::json::decode(json), qc::json::decodeFile(path));
+    EXPECT_EQ(qc::json::decode(json), qc::json::decodeFile(path, 5u));
+}
+
+TEST_F(FileTest, errors)
+{
+    // Decode errors are the same as for a string
+    for (const std::string_view json : {""sv, "["sv, R"({"a": 1,, })"sv, R"(["unterminated)"sv, "[1, 2] 3"sv, "/* open"sv})
+    {
+        writeFile(json);
+
+        size_t expectedPosition{};
+        try
+        {
+            qc::json::decode(json);
+            ADD_FAILURE() << json;
+        }
+        catch (const DecodeError & e)
+        {
+            expectedPosition = e.position;
+        }
+
+        for (const size_t chunkSize : {1u, 4096u})
+        {
+            try
+            {
+                LogComposer composer{};
+                qc::json::decodeFile(path, composer, nullptr, chunkSize);
+                ADD_FAILURE() << json;
+            }
+            catch (const DecodeError & e)
+            {
+                EXPECT_EQ(expectedPosition, e.position) << json;
+            }
+        }
+    }
+
+    // The reader is stopped when the composer throws partway through
+    {
+        std::string big{"["};
+        for (int i{0}; i < 100000; ++i) big += "1, ";
+        big += "2]";
+        writeFile(big);
+
+        struct ThrowingComposer : qc::json::DummyComposer<>
+        {
+            using DummyComposer::val;
+            void val(const int64_t val, std::nullptr_t & /*state*/) { if (val == 2) throw qc::json::ComposeError{"Two"sv}; }
+            void val(const uint64_t val, std::nullptr_t & /*state*/) { if (val == 2u) throw qc::json::ComposeError{"Two"sv}; }
+        };
+        ThrowingComposer composer{};
+        EXPECT_THROW(qc::json::decodeFile(path, composer, nullptr, 64u), qc::json::ComposeError);
+    }
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(qc::json::decodeFile(path), FileError);
+}
+
+TEST_F(FileTest, sink)
+{
+    qc::json::Value records{qc::json::makeArray()};
+    for (int i{0}; i < 50000; ++i) records.asArray().push_back(qc::json::decode(R"({"a": [1, 2.5, "three", {"four": null}], "b": true})"sv));
+    const std::string json{qc::json::encode(records)};
+
+    const auto readFile{[this]() {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }};
+
+    for (const bool async : {true, false})
+    {
+        // Small buffers so that many writes are in flight at once
+        {
+            qc::json::FileSink sink{path, 4096u, 4u, async};
+            if (!async)
+            {
+                EXPECT_FALSE(sink.async());
+            }
+            qc::json::Encoder encoder{};
+            encoder.setSink(&sink, 1000u);
+            encoder << records;
+            EXPECT_TRUE(encoder.finish().empty());
+
+            // Reusing the encoder appends
+            encoder << "more";
+            static_cast<void>(encoder.finish());
+        }
+        EXPECT_EQ(json + R"("more")", readFile()) << async;
+
+        // Anything left is written on destruction
+        {
+            qc::json::FileSink sink{path, 1u << 20, 2u, async};
+            sink.write("unfinished"sv);
+        }
+        EXPECT_EQ("unfinished"s, readFile()) << async;
+    }
+
+    EXPECT_THROW(qc::json::FileSink(path / "nonexistent"), FileError);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <qc-json.hpp>
+#include <qc-json-hash.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Digest;
+using qc::json::Hasher;
+using qc::json::HashSink;
+using qc::json::Encoder;
+using qc::json::Density;
+using qc::json::canonicalDigest;
+using namespace qc::json::tokens;
+
+static Digest hash(std::string_view str)
+{
+    Hasher hasher{};
+    hasher.update(str);
+    return hasher.digest();
+}
+
+TEST(hash, hasher)
+{
+    { // Reference MurmurHash3 x64 128 values
+        EXPECT_EQ((Digest{0u, 0u}), hash(""sv));
+        EXPECT_EQ((Digest{0xCBD8A7B341BD9B02u, 0x5B1E906A48AE1D19u}), hash("hello"sv));
+        EXPECT_EQ((Digest{0xE34BBC7BBC071B6Cu, 0x7A433CA9C49A9347u}), hash("The quick brown fox jumps over the lazy dog"sv));
+    }
+    { // Independent of how the input is split
+        const std::string str{"The quick brown fox jumps over the lazy dog, again and again and again"};
+        const Digest expected{hash(str)};
+        for (size_t step{1u}; step <= 20u; ++step)
+        {
+            Hasher hasher{};
+            for (size_t i{0u}; i < str.size(); i += step)
+            {
+                hasher.update(std::string_view{str}.substr(i, step));
+            }
+            EXPECT_EQ(expected, hasher.digest());
+        }
+    }
+    { // Seed
+        Hasher hasher{1u};
+        hasher.update("hello"sv);
+        EXPECT_NE(hash("hello"sv), hasher.digest());
+    }
+}
+
+TEST(hash, sink)
+{
+    HashSink sink{};
+    Encoder encoder{Density::nospace, 0u, false, false, true};
+    encoder.setSink(&sink, 16u);
+    encoder << object << "a" << array;
+    for (int i{0}; i < 1000; ++i) encoder << i;
+    encoder << end << end;
+    EXPECT_TRUE(encoder.finish().empty());
+
+    encoder.setSink(nullptr);
+    encoder << object << "a" << array;
+    for (int i{0}; i < 1000; ++i) encoder << i;
+    encoder << end << end;
+    EXPECT_EQ(hash(encoder.finish()), sink.digest());
+}
+
+TEST(hash, canonicalDigest)
+{
+    { // Formatting, comments, and number representation are irrelevant
+        const qc::json::Value v1{qc::json::decode(R"({ "b": [1, 2.0, 'x'], a: 1e2 })")};
+        const qc::json::Value v2{qc::json::decode("{\n    // Comment\n    \"a\": 100,\n    \"b\": [ 1, 2, \"x\" ],\n}")};
+        EXPECT_EQ(canonicalDigest(v1), canonicalDigest(v2));
+        EXPECT_EQ(hash(R"({"a":100,"b":[1,2,"x"]})"sv), canonicalDigest(v1));
+    }
+    { // Different content
+        EXPECT_NE(canonicalDigest(qc::json::decode("[1, 2]")), canonicalDigest(qc::json::decode("[2, 1]")));
+        EXPECT_NE(canonicalDigest(qc::json::decode("1")), canonicalDigest(qc::json::decode("\"1\"")));
+    }
+}
+
+TEST(hash, fingerprint)
+{
+    using qc::json::fingerprint;
+
+    { // Whitespace, comments, key order, quotes, and trailing commas are irrelevant
+        const Digest d{fingerprint(R"({"a":1,"b":[true,null,"x"],"c":{"d":-2.5}})")};
+        EXPECT_EQ(d, fingerprint("{\n    // Comment\n    c: { d: -2.5 },\n    'b': [ true, null, 'x', ],\n    /* Comment */ a: 1,\n}"));
+        EXPECT_EQ(d, fingerprint(R"({"c":{"d":-25e-1},"a":1.0,"b":[true,null,"x"]})"));
+    }
+    { // Number representation is irrelevant
+        const Digest d{fingerprint("[1, -1, 0, 10000000000000000000]")};
+        EXPECT_EQ(d, fingerprint("[1.0, -1.0, 0.0, 10000000000000000000.0]"));
+        EXPECT_EQ(d, fingerprint("[1e0, -0.1e1, -0, 1e19]"));
+        EXPECT_EQ(d, fingerprint("[0x1, -1, 0b0, 0x8AC7230489E80000]"));
+        EXPECT_EQ(fingerprint("-10000000000000000000"), fingerprint("-1e19"));
+        EXPECT_EQ(fingerprint("nan"), fingerprint("-nan"));
+    }
+    { // Structural differences
+        EXPECT_NE(fingerprint("[1, 2]"), fingerprint("[2, 1]"));
+        EXPECT_NE(fingerprint("[1, 2]"), fingerprint("[[1, 2]]"));
+        EXPECT_NE(fingerprint("[[1], 2]"), fingerprint("[1, [2]]"));
+        EXPECT_NE(fingerprint("[]"), fingerprint("{}"));
+        EXPECT_NE(fingerprint(R"({"a": 1, "b": 2})"), fingerprint(R"({"a": 2, "b": 1})"));
+        EXPECT_NE(fingerprint(R"({"a": {}})"), fingerprint(R"({"a": []})"));
+        EXPECT_NE(fingerprint(R"({"a": 1})"), fingerprint(R"({"a": 1, "b": 1})"));
+        EXPECT_NE(fingerprint("1"), fingerprint("\"1\""));
+        EXPECT_NE(fingerprint("1"), fingerprint("-1"));
+        EXPECT_NE(fingerprint("1"), fingerprint("1.5"));
+        EXPECT_NE(fingerprint("true"), fingerprint("false"));
+        EXPECT_NE(fingerprint("false"), fingerprint("null"));
+        EXPECT_NE(fingerprint("0"), fingerprint("null"));
+        EXPECT_NE(fingerprint("\"\""), fingerprint("null"));
+    }
+    { // Composer may be reused
+        qc::json::FingerprintComposer composer{};
+        qc::json::decode("[1, 2]", composer, qc::json::FingerprintComposer::State{});
+        qc::json::decode("{}", composer, qc::json::FingerprintComposer::State{});
+        EXPECT_EQ(fingerprint("{}"), composer.digest());
+    }
+}
@@ -0,0 +1,297 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <qc-json-index.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::DecodeError;
+using qc::json::IndexError;
+
+class IndexTest : public testing::Test
+{
+    protected: //---------------------------------------------------------------
+
+    std::filesystem::path path{std::filesystem::temp_directory_path() / "qc-json-index-test.idx"};
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    static std::vector<std::string_view> records(const std::string_view ndjson, const qc::json::LineIndex & index)
+    {
+        std::vector<std::string_view> records{};
+        for (size_t i{0u}; i < index.size(); ++i)
+        {
+            records.push_back(index.record(ndjson, i));
+        }
+        return records;
+    }
+};
+
+TEST_F(IndexTest, lines)
+{
+    // Plain records, with every record long enough in places to cross SIMD blocks
+    {
+        std::string ndjson{};
+        std::vector<std::string> expected{};
+        for (int i{0}; i < 1000; ++i)
+        {
+            expected.push_back(R"({"id": )" + std::to_string(i) + R"(, "name": ")" + std::string(size_t(i % 40), 'x') + R"("})");
+            ndjson += expected.back() += '\n';
+            expected.back().pop_back();
+        }
+
+        const qc::json::LineIndex index{qc::json::indexLines(ndjson)};
+        ASSERT_EQ(expected.size(), index.size());
+        EXPECT_EQ(ndjson.size(), index.sourceSize());
+        for (size_t i{0u}; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(expected[i], index.record(ndjson, i));
+        }
+        EXPECT_EQ(qc::json::decode(expected[777]), qc::json::decodeRecord(ndjson, index, 777u));
+    }
+
+    // Newlines in strings and comments do not end records, and blank lines are not records
+    {
+        const std::string_view ndjson{
+            "\n"
+            "  \t\n"
+            R"({"a": "one \
+two", 'b': 'it\'s "\\'})" "\n"
+            "[1, /* block\ncomment */ 2]\r\n"
+            "\n"
+            "3 // trailing comment with \"quote\n"
+            R"("escaped \" and \\" // then \n a comment)" "\n"
+            "'unterminated\n"
+            "true\n"
+            "/* open"sv};
+        const qc::json::LineIndex index{qc::json::indexLines(ndjson)};
+        EXPECT_EQ((std::vector<std::string_view>{
+            R"({"a": "one \
+two", 'b': 'it\'s "\\'})"sv,
+            "[1, /* block\ncomment */ 2]"sv,
+            "3 // trailing comment with \"quote"sv,
+            R"("escaped \" and \\" // then \n a comment)"sv,
+            "'unterminated"sv,
+            "true"sv,
+            "/* open"sv}), records(ndjson, index));
+
+        EXPECT_EQ(qc::json::decode("[1, 2]"sv), qc::json::decodeRecord(ndjson, index, 1u));
+        EXPECT_EQ(qc::json::decode("3"sv), qc::json::decodeRecord(ndjson, index, 2u));
+        EXPECT_EQ(qc::json::decode("true"sv), qc::json::decodeRecord(ndjson, index, 5u));
+    }
+
+    // Line continuation with `\r\n`
+    {
+        const std::string_view ndjson{"\"one \\\r\ntwo\"\r\n\"three\""sv};
+        EXPECT_EQ((std::vector<std::string_view>{"\"one \\\r\ntwo\""sv, "\"three\""sv}), records(ndjson, qc::json::indexLines(ndjson)));
+    }
+
+    EXPECT_EQ(0u, qc::json::indexLines(""sv).size());
+    EXPECT_EQ(0u, qc::json::indexLines(" \n\n \r\n"sv).size());
+    EXPECT_EQ(1u, qc::json::indexLines("1"sv).size());
+}
+
+TEST_F(IndexTest, linesSaveLoad)
+{
+    std::string ndjson{};
+    for (int i{0}; i < 300; ++i)
+    {
+        ndjson += std::to_string(i) += '\n';
+    }
+    const qc::json::LineIndex index{qc::json::indexLines(ndjson)};
+
+    qc::json::saveIndex(index, path);
+    const qc::json::LineIndex loaded{qc::json::loadLineIndex(path)};
+    ASSERT_EQ(index.size(), loaded.size());
+    EXPECT_EQ(index.sourceSize(), loaded.sourceSize());
+    for (size_t i{0u}; i < index.size(); ++i)
+    {
+        EXPECT_EQ(index.offset(i), loaded.offset(i));
+    }
+    EXPECT_EQ(qc::json::Value{299}, qc::json::decodeRecord(ndjson, loaded, 299u));
+
+    // Empty
+    qc::json::saveIndex(qc::json::indexLines(""sv), path);
+    EXPECT_EQ(0u, qc::json::loadLineIndex(path).size());
+}
+
+TEST_F(IndexTest, linesErrors)
+{
+    const std::string_view ndjson{"[1]\n[2, ]\n[3, , ]\n"sv};
+    const qc::json::LineIndex index{qc::json::indexLines(ndjson)};
+
+    EXPECT_THROW(index.offset(3u), IndexError);
+    EXPECT_THROW(qc::json::decodeRecord(ndjson, index, 3u), IndexError);
+    EXPECT_THROW(qc::json::decodeRecord(ndjson.substr(1u), index, 0u), IndexError);
+
+    // The error position is into the whole input
+    try
+    {
+        qc::json::decodeRecord(ndjson, index, 2u);
+        ADD_FAILURE();
+    }
+    catch (const DecodeError & e)
+    {
+        EXPECT_EQ(14u, e.position);
+    }
+
+    // Not an index
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << "not an index at all, but long enough to have a header's worth of bytes";
+    }
+    EXPECT_THROW(qc::json::loadLineIndex(path), IndexError);
+
+    // Truncated
+    qc::json::saveIndex(index, path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1u);
+    EXPECT_THROW(qc::json::loadLineIndex(path), IndexError);
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(qc::json::loadLineIndex(path), IndexError);
+}
+
+TEST_F(IndexTest, elements)
+{
+    // Array, with every kind of nesting and text that could be mistaken for structure
+    {
+        const std::string_view json{R"( // Leading comment
+            [
+                {"a": [1, 2], "b": {"c": "]},{["}},
+                "string, with ] and , and \" and \\",
+                'single, [quoted]',
+                /* comment, [with] brackets */ [[], [[]], {}],
+                -1.5e3 // trailing, comment
+                ,
+                null,
+            ] // After
+        )"sv};
+        const qc::json::ElementIndex index{qc::json::indexElements(json)};
+        EXPECT_EQ(qc::json::Container::array, index.container());
+        ASSERT_EQ(6u, index.size());
+        EXPECT_EQ(R"({"a": [1, 2], "b": {"c": "]},{["}})"sv, index.element(json, 0u));
+        EXPECT_EQ(R"('single, [quoted]')"sv, index.element(json, 2u));
+        EXPECT_EQ("null"sv, index.element(json, 5u));
+
+        const qc::json::Value dom{qc::json::decode(json)};
+        for (size_t i{0u}; i < index.size(); ++i)
+        {
+            EXPECT_EQ(dom.asArray()[i], qc::json::decodeElement(json, index, i)) << i;
+        }
+        EXPECT_THROW(index.key(0u), IndexError);
+        EXPECT_THROW(index.find("a"sv), IndexError);
+    }
+
+    // Object, with keys of every form
+    {
+        const std::string_view json{R"({
+            "plain": 1,
+            "esc\"aped\n": [2, {"nested": 3}],
+            'single': "four",
+            identifier: {"five": 5},
+            /* comment */ "commented" /* comment */ : 6,
+            "plain": "duplicate",
+            "": {},
+        })"sv};
+        const qc::json::ElementIndex index{qc::json::indexElements(json)};
+        EXPECT_EQ(qc::json::Container::object, index.container());
+        ASSERT_EQ(7u, index.size());
+        EXPECT_EQ((std::vector<std::string_view>{"plain"sv, "esc\"aped\n"sv, "single"sv, "identifier"sv, "commented"sv, "plain"sv, ""sv}), (std::vector<std::string_view>{index.key(0u), index.key(1u), index.key(2u), index.key(3u), index.key(4u), index.key(5u), index.key(6u)}));
+        EXPECT_EQ("6"sv, index.element(json, 4u));
+
+        EXPECT_EQ(0u, index.find("plain"sv));
+        EXPECT_EQ(3u, index.find("identifier"sv));
+        EXPECT_EQ(6u, index.find(""sv));
+        EXPECT_EQ(index.size(), index.find("missing"sv));
+
+        EXPECT_EQ(qc::json::Value{1}, qc::json::decodeMember(json, index, "plain"sv));
+        EXPECT_EQ(qc::json::decode(R"([2, {"nested": 3}])"sv), qc::json::decodeMember(json, index, "esc\"aped\n"sv));
+        EXPECT_EQ(qc::json::Value{"duplicate"}, qc::json::decodeElement(json, index, 5u));
+        EXPECT_THROW(qc::json::decodeMember(json, index, "missing"sv), IndexError);
+    }
+
+    // Large, to cross many blocks
+    {
+        std::string json{"["};
+        for (int i{0}; i < 10000; ++i)
+        {
+            json += R"({"id": )" + std::to_string(i) + R"(, "tags": ["a", "b,c", "]"]}, )";
+        }
+        json += "]";
+        const qc::json::ElementIndex index{qc::json::indexElements(json)};
+        ASSERT_EQ(10000u, index.size());
+        EXPECT_EQ(qc::json::decode(R"({"id": 9876, "tags": ["a", "b,c", "]"]})"sv), qc::json::decodeElement(json, index, 9876u));
+    }
+
+    EXPECT_EQ(0u, qc::json::indexElements("[]"sv).size());
+    EXPECT_EQ(0u, qc::json::indexElements(" { /* nothing */ } "sv).size());
+    EXPECT_EQ(1u, qc::json::indexElements("[0]"sv).size());
+}
+
+TEST_F(IndexTest, elementsSaveLoad)
+{
+    for (const std::string_view json : {R"([1, "two", [3], {"four": 4}, ])"sv, R"({"a": 1, 'b': [2], c: {"d": 3}})"sv, "[]"sv})
+    {
+        const qc::json::ElementIndex index{qc::json::indexElements(json)};
+        qc::json::saveIndex(index, path);
+        const qc::json::ElementIndex loaded{qc::json::loadElementIndex(path)};
+
+        EXPECT_EQ(index.container(), loaded.container());
+        EXPECT_EQ(index.sourceSize(), loaded.sourceSize());
+        ASSERT_EQ(index.size(), loaded.size());
+        for (size_t i{0u}; i < index.size(); ++i)
+        {
+            EXPECT_EQ(index.element(json, i), loaded.element(json, i));
+            if (index.container() == qc::json::Container::object)
+            {
+                EXPECT_EQ(index.key(i), loaded.key(i));
+                EXPECT_EQ(i, loaded.find(index.key(i)));
+            }
+        }
+    }
+
+    // A line index is not an element index, nor the reverse
+    qc::json::saveIndex(qc::json::indexLines("1\n2\n"sv), path);
+    EXPECT_THROW(qc::json::loadElementIndex(path), IndexError);
+    qc::json::saveIndex(qc::json::indexElements("[1, 2]"sv), path);
+    EXPECT_THROW(qc::json::loadLineIndex(path), IndexError);
+
+    // Truncated
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1u);
+    EXPECT_THROW(qc::json::loadElementIndex(path), IndexError);
+}
+
+TEST_F(IndexTest, elementsErrors)
+{
+    for (const std::string_view json : {""sv, "1"sv, R"("string, with [brackets]")"sv, "[1, 2"sv, "[1, 2}"sv, "[1]]"sv, "[1] [2]"sv, R"({"a" 1})"sv, R"({"a": 1, "b": })"sv, R"({"a": "b": 1})"sv})
+    {
+        EXPECT_THROW(qc::json::indexElements(json), IndexError) << json;
+    }
+
+    // Elements are only validated when decoded, with the position into the whole input
+    const std::string_view json{"[1, [2, ], [3, , ]]"sv};
+    const qc::json::ElementIndex index{qc::json::indexElements(json)};
+    EXPECT_EQ(qc::json::decode("[2]"sv), qc::json::decodeElement(json, index, 1u));
+    try
+    {
+        qc::json::decodeElement(json, index, 2u);
+        ADD_FAILURE();
+    }
+    catch (const DecodeError & e)
+    {
+        EXPECT_EQ(15u, e.position);
+    }
+    EXPECT_THROW(qc::json::decodeElement(json, index, 3u), IndexError);
+    EXPECT_THROW(index.element(json.substr(1u), 0u), IndexError);
+
+    // Bad keys are decode errors
+    EXPECT_THROW(qc::json::indexElements(R"({"a": 1, two words: 2})"sv), DecodeError);
+}
@@ -820,6 +820,9 @@ TEST(json, encoderOptions)
     'v'
   ]
 })", encode(makeObject("k", makeArray("v")), Density::multiline, 2u, true, true));
+
+    // Canonical objects are reordered by UTF-16 code unit, so U+1F600 comes before U+FF61
+    EXPECT_EQ("{\"a\":0,\"\xF0\x9F\x98\x80\":1,\"\xEF\xBD\xA1\":2}", encode(makeObject("\xEF\xBD\xA1", 2, "\xF0\x9F\x98\x80", 1, "a", 0), Density::multiline, 4u, false, false, true));
 }
 
 TEST(json, numberEquality)
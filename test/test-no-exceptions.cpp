@@ -0,0 +1,214 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <qc-json.hpp>
+#include <qc-json-file.hpp>
+#include <qc-json-index.hpp>
+#include <qc-json-reformat.hpp>
+#include <qc-json-schema.hpp>
+#include <qc-json-snapshot.hpp>
+#include <qc-json-static.hpp>
+
+#ifndef QC_JSON_NO_EXCEPTIONS
+    #error "This test must be compiled with exceptions disabled"
+#endif
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::DecodeResult;
+using qc::json::Density;
+using qc::json::Encoder;
+using qc::json::Value;
+using namespace qc::json::tokens;
+
+// Records the name of each composer call made
+struct RecordingComposer : qc::json::DummyComposer<nullptr_t>
+{
+    std::vector<std::string> calls{};
+
+    nullptr_t object(nullptr_t) { calls.push_back("object"s); return nullptr; }
+    nullptr_t array(nullptr_t) { calls.push_back("array"s); return nullptr; }
+    void end(qc::json::Density, nullptr_t, nullptr_t) { calls.push_back("end"s); }
+    void key(std::string_view, nullptr_t) { calls.push_back("key"s); }
+    void val(std::string_view, nullptr_t) { calls.push_back("string"s); }
+    void val(int64_t, nullptr_t) { calls.push_back("integer"s); }
+    void val(uint64_t, nullptr_t) { calls.push_back("unsigner"s); }
+    void val(double, nullptr_t) { calls.push_back("floater"s); }
+    void val(bool, nullptr_t) { calls.push_back("boolean"s); }
+    void val(nullptr_t, nullptr_t) { calls.push_back("null"s); }
+};
+
+TEST(noExceptions, saxDecode)
+{
+    { // Success
+        RecordingComposer composer{};
+        const DecodeResult result{qc::json::tryDecode(R"({"a": [1, true]})"sv, composer, nullptr)};
+        EXPECT_TRUE(result);
+        EXPECT_TRUE(result.message.empty());
+        EXPECT_EQ((std::vector{"object"s, "key"s, "array"s, "integer"s, "boolean"s, "end"s, "end"s}), composer.calls);
+    }
+    { // Failure stops the composer
+        RecordingComposer composer{};
+        const DecodeResult result{qc::json::tryDecode(R"({"a": [1, nope, 2]})"sv, composer, nullptr)};
+        EXPECT_FALSE(result);
+        EXPECT_EQ("Unknown value"s, result.message);
+        EXPECT_EQ(10u, result.position);
+        EXPECT_EQ((std::vector{"object"s, "key"s, "array"s, "integer"s}), composer.calls);
+    }
+    { // Only the first error is reported
+        RecordingComposer composer{};
+        const DecodeResult result{qc::json::tryDecode(R"({"a" 1})"sv, composer, nullptr)};
+        EXPECT_FALSE(result);
+        EXPECT_EQ("Expected `:`"s, result.message);
+        EXPECT_EQ(5u, result.position);
+    }
+    { // Error in string
+        RecordingComposer composer{};
+        const DecodeResult result{qc::json::tryDecode(R"(["abc\xZZ"])"sv, composer, nullptr)};
+        EXPECT_FALSE(result);
+        EXPECT_EQ("Invalid code point"s, result.message);
+        EXPECT_EQ((std::vector{"array"s}), composer.calls);
+    }
+    { // Extraneous content
+        RecordingComposer composer{};
+        const DecodeResult result{qc::json::tryDecode("1 2"sv, composer, nullptr)};
+        EXPECT_FALSE(result);
+        EXPECT_EQ("Extraneous content"s, result.message);
+        EXPECT_EQ(2u, result.position);
+    }
+}
+
+TEST(noExceptions, domDecode)
+{
+    Value root{};
+    EXPECT_TRUE(qc::json::tryDecode(R"({"a": [1, 2]})"sv, root));
+    EXPECT_EQ(2u, root.asObject().at("a").asArray().size());
+
+    const DecodeResult result{qc::json::tryDecode(R"({"a": [1, 2})"sv, root)};
+    EXPECT_FALSE(result);
+    EXPECT_EQ("Expected `,`"s, result.message);
+    EXPECT_TRUE(root.isNull());
+}
+
+TEST(noExceptions, encoder)
+{
+    Encoder encoder{Density::nospace};
+    EXPECT_FALSE(encoder.failed());
+    EXPECT_TRUE(encoder.error().empty());
+
+    // Error is sticky
+    encoder << object << 1;
+    EXPECT_TRUE(encoder.failed());
+    EXPECT_EQ("Cannot add to object without first providing a key"sv, encoder.error());
+    encoder << "k" << 1 << end << end;
+    EXPECT_EQ("Cannot add to object without first providing a key"sv, encoder.error());
+    EXPECT_EQ(""s, encoder.finish());
+    EXPECT_TRUE(encoder.failed());
+
+    // Reset allows reuse
+    encoder.reset();
+    EXPECT_FALSE(encoder.failed());
+    encoder << array << 1 << 2 << end;
+    EXPECT_EQ("[1,2]"s, encoder.finish());
+
+    // Incomplete JSON
+    encoder << array << 1;
+    EXPECT_EQ(""s, encoder.finish());
+    EXPECT_EQ("Cannot finish, JSON is not yet complete"sv, encoder.error());
+    encoder.reset();
+
+    // Errors from deeper within the encoder
+    encoder << comment("a\x01");
+    EXPECT_EQ("Comment has invalid character `\\x1`"sv, encoder.error());
+    encoder.reset();
+    Encoder canonical{Density::unspecified, 4u, false, false, true};
+    canonical << std::numeric_limits<double>::infinity();
+    EXPECT_EQ("Canonical JSON cannot represent NaN or infinity"sv, canonical.error());
+}
+
+TEST(noExceptions, file)
+{
+    const std::filesystem::path path{std::filesystem::temp_directory_path() / "qc-json-no-exceptions-test.json"};
+
+    {
+        qc::json::FileSink sink{path, 4096u};
+        Encoder encoder{Density::nospace};
+        encoder.setSink(&sink);
+        encoder << object << "a" << array << 1 << true << end << end;
+        EXPECT_TRUE(encoder.finish().empty());
+        EXPECT_FALSE(encoder.failed());
+    }
+
+    EXPECT_EQ(qc::json::decode(R"({"a": [1, true]})"sv), qc::json::decodeFile(path, 3u));
+
+    std::filesystem::remove(path);
+}
+
+TEST(noExceptions, index)
+{
+    const std::string_view ndjson{"{\"a\": 1}\n[2]\n\"three\"\n"sv};
+    const qc::json::LineIndex lines{qc::json::indexLines(ndjson)};
+    EXPECT_EQ(3u, lines.size());
+    EXPECT_EQ(qc::json::decode("[2]"sv), qc::json::decodeRecord(ndjson, lines, 1u));
+
+    const std::string_view json{R"({"a": [1], 'b': "two", c: null})"sv};
+    const qc::json::ElementIndex elements{qc::json::indexElements(json)};
+    EXPECT_EQ(3u, elements.size());
+    EXPECT_EQ(qc::json::decode("[1]"sv), qc::json::decodeMember(json, elements, "a"sv));
+    EXPECT_EQ("two"sv, qc::json::decodeMember(json, elements, "b"sv).asString());
+    EXPECT_TRUE(qc::json::decodeElement(json, elements, 2u).isNull());
+}
+
+TEST(noExceptions, reformat)
+{
+    EXPECT_EQ(R"({"a":[1,"\u0001"]})"s, qc::json::reformat(R"({a: [0x1, '\x01']})"sv, {.density = Density::nospace, .strict = true}));
+}
+
+TEST(noExceptions, schema)
+{
+    const qc::json::Schema schema{qc::json::decode(R"({type: "array", maxItems: 2})"sv)};
+    qc::json::validate("[1, 2]"sv, schema);
+}
+
+TEST(noExceptions, staticDecode)
+{
+    static constexpr auto config{qc::json::staticDecode<"{ size: [16, 9], ratio: 1.5 }">()};
+    EXPECT_EQ(9, config.root().at("size"sv).at(1u).asInteger());
+    EXPECT_EQ(1.5, config.root().at("ratio"sv).asFloater());
+}
+
+TEST(noExceptions, snapshot)
+{
+    const std::filesystem::path path{std::filesystem::temp_directory_path() / "qc-json-no-exceptions-test.bin"};
+
+    qc::json::saveSnapshot(qc::json::decode(R"({"a": [1, "b"]})"sv), path);
+    {
+        const qc::json::Snapshot snapshot{qc::json::loadSnapshot(path)};
+        EXPECT_EQ("b"sv, snapshot.root().at("a"sv).at(1u).asString());
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(noExceptions, tryGet)
+{
+    const Value val{qc::json::makeObject("a", 7, "b", "x", "c", -1.5, "d", nullptr)};
+    const qc::json::Object & obj{val.asObject()};
+
+    EXPECT_EQ(7, obj.at("a").tryGet<int>());
+    EXPECT_EQ(7u, obj.at("a").tryGet<uint8_t>());
+    EXPECT_EQ(7.0, obj.at("a").tryGet<double>());
+    EXPECT_FALSE(obj.at("a").tryGet<std::string>());
+    EXPECT_EQ('x', obj.at("b").tryGet<char>());
+    EXPECT_EQ("x"sv, obj.at("b").tryGet<std::string_view>());
+    EXPECT_FALSE(obj.at("b").tryGet<bool>());
+    EXPECT_FALSE(obj.at("c").tryGet<int>());
+    EXPECT_FALSE(obj.at("c").tryGet<unsigned int>());
+    EXPECT_EQ(-1.5, obj.at("c").tryGet<double>());
+    EXPECT_TRUE(obj.at("d").tryGet<nullptr_t>());
+    EXPECT_FALSE(obj.at("d").tryGet<int>());
+}
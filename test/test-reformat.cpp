@@ -0,0 +1,190 @@
+#include <cctype>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <qc-json.hpp>
+#include <qc-json-reformat.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Density;
+using qc::json::ReformatOptions;
+using qc::json::reformat;
+using qc::json::minify;
+using qc::json::prettify;
+
+static constexpr std::string_view json5{R"({
+    // Name
+    name: 'Bob',
+    list: [1, 0x10, -2.5, true, null],
+    nested: {a: {}, b: []},
+    big: 18446744073709551615,
+})"};
+
+// Whether the string is a single RFC 8259 JSON value, surrounded by optional whitespace
+static bool isStrictJson(const std::string_view json)
+{
+    size_t i{0u};
+    const auto ws{[&]() { while (i < json.size() && (json[i] == ' ' || json[i] == '\t' || json[i] == '\n' || json[i] == '\r')) ++i; }};
+    const auto take{[&](const char c) { if (i < json.size() && json[i] == c) { ++i; return true; } return false; }};
+    const auto digits{[&]() { const size_t start{i}; while (i < json.size() && json[i] >= '0' && json[i] <= '9') ++i; return i > start; }};
+    const auto string{[&]() {
+        if (!take('"')) return false;
+        while (i < json.size() && json[i] != '"')
+        {
+            if ((unsigned char)json[i] < 0x20u) return false;
+            if (take('\\'))
+            {
+                if (i >= json.size()) return false;
+                const char c{json[i++]};
+                if (c == 'u')
+                {
+                    for (int j{0}; j < 4; ++j, ++i) if (i >= json.size() || !std::isxdigit((unsigned char)json[i])) return false;
+                }
+                else if (std::string_view{"\"\\/bfnrt"}.find(c) == std::string_view::npos) return false;
+            }
+            else ++i;
+        }
+        return take('"');
+    }};
+    const auto value{[&](const auto & self) -> bool {
+        ws();
+        if (i >= json.size()) return false;
+        if (take('{'))
+        {
+            ws();
+            if (take('}')) return true;
+            do { ws(); if (!string()) return false; ws(); if (!take(':') || !self(self)) return false; ws(); } while (take(','));
+            return take('}');
+        }
+        if (take('['))
+        {
+            ws();
+            if (take(']')) return true;
+            do { if (!self(self)) return false; ws(); } while (take(','));
+            return take(']');
+        }
+        if (json[i] == '"') return string();
+        for (const std::string_view word : {"true"sv, "false"sv, "null"sv}) if (json.substr(i).starts_with(word)) { i += word.size(); return true; }
+        take('-');
+        if (!take('0') && !digits()) return false;
+        if (take('.') && !digits()) return false;
+        if ((take('e') || take('E')) && (take('+') || take('-') || true) && !digits()) return false;
+        return true;
+    }};
+
+    if (!value(value)) return false;
+    ws();
+    return i == json.size();
+}
+
+TEST(reformat, minify)
+{
+    EXPECT_EQ(R"({"name":"Bob","list":[1,16,-2.5,true,null],"nested":{"a":{},"b":[]},"big":18446744073709551615})"s, minify(json5));
+    EXPECT_EQ("5"s, minify(" 5 "sv));
+    EXPECT_EQ(R"("a")"s, minify(R"( 'a' )"sv));
+}
+
+TEST(reformat, prettify)
+{
+    EXPECT_EQ(R"({
+  // Name
+  "name": "Bob",
+  "list": [
+    1,
+    16,
+    -2.5,
+    true,
+    null
+  ],
+  "nested": {
+    "a": {},
+    "b": []
+  },
+  "big": 18446744073709551615
+})"s, prettify(json5, 2u));
+}
+
+TEST(reformat, preserveDensity)
+{
+    EXPECT_EQ(R"({
+    // Name
+    "name": "Bob",
+    "list": [ 1, 16, -2.5, true, null ],
+    "nested": { "a": {}, "b": [] },
+    "big": 18446744073709551615
+})"s, reformat(json5));
+    EXPECT_EQ(R"([ {"a":[1,2]}, [ 3 ] ])"s, reformat(R"([{"a":[1,2]}, [ 3 ]])"sv));
+
+    // Matches decoding and encoding a DOM, given keys already in order
+    const std::string_view sorted{"{\n    a: [1, 2],\n    b: {c: [ ], d: [\n    ]},\n    e: null\n}"sv};
+    EXPECT_EQ(qc::json::encode(qc::json::decode(sorted), Density::unspecified), reformat(sorted));
+}
+
+TEST(reformat, options)
+{
+    EXPECT_EQ(R"({ name: 'Bob', list: [ 1, 16, -2.5, true, null ], nested: { a: {}, b: [] }, big: 18446744073709551615 })"s,
+        reformat(json5, ReformatOptions{.density = Density::uniline, .singleQuotes = true, .identifiers = true, .comments = false}));
+    EXPECT_EQ(R"({ /* Name */ name: 'Bob', list: [ 1, 16, -2.5, true, null ], nested: { a: {}, b: [] }, big: 18446744073709551615 })"s,
+        reformat(json5, ReformatOptions{.density = Density::uniline, .singleQuotes = true, .identifiers = true}));
+}
+
+TEST(reformat, strict)
+{
+    const ReformatOptions options{.density = Density::uniline, .singleQuotes = true, .identifiers = true, .strict = true};
+    EXPECT_EQ(R"({ "name": "Bob", "list": [ 1, 16, -2.5, true, null ], "nested": { "a": {}, "b": [] }, "big": 18446744073709551615 })"s,
+        reformat(json5, options));
+    EXPECT_EQ("[ 1, 2 ]"s, reformat("[1, 2]"sv, options));
+    EXPECT_EQ("inf"s, reformat("Infinity"sv));
+    EXPECT_THROW(reformat("Infinity"sv, options), qc::json::ComposeError);
+    EXPECT_THROW(reformat("[0, -Infinity]"sv, options), qc::json::ComposeError);
+    EXPECT_THROW(reformat("NaN"sv, options), qc::json::ComposeError);
+
+    // Only JSON's escapes are used
+    const std::string escaped{reformat(R"({a:"\0\v\x01\x1F\t\x7F'"})"sv, options)};
+    EXPECT_EQ("{ \"a\": \"\\u0000\\u000b\\u0001\\u001f\\t\x7F'\" }"s, escaped);
+    EXPECT_TRUE(isStrictJson(escaped));
+    EXPECT_TRUE(isStrictJson(reformat(json5, options)));
+    EXPECT_FALSE(isStrictJson(reformat(R"({a:"\0\v\x01"})"sv)));
+}
+
+TEST(reformat, sink)
+{
+    struct StringSink : qc::json::Sink
+    {
+        std::string str{};
+        size_t writes{0u};
+        bool finished{false};
+
+        void write(const std::string_view chunk) override { str += chunk; ++writes; }
+        void finish() override { finished = true; }
+    };
+
+    std::string json{"["};
+    for (int i{0}; i < 10000; ++i) json += std::to_string(i) + ", ";
+    json += "]";
+
+    StringSink sink{};
+    reformat(json, sink, ReformatOptions{.density = Density::nospace});
+    EXPECT_TRUE(sink.finished);
+    EXPECT_GT(sink.writes, 1u);
+    EXPECT_EQ(minify(json), sink.str);
+}
+
+TEST(reformat, invalid)
+{
+    EXPECT_THROW(reformat("[1, 2"sv), qc::json::DecodeError);
+    EXPECT_THROW(minify("{a: }"sv), qc::json::DecodeError);
+}
+
+TEST(reformat, reformatter)
+{
+    qc::json::Encoder encoder{Density::uniline};
+    encoder << qc::json::array << "before"sv;
+    qc::json::Reformatter reformatter{encoder, false};
+    qc::json::decode(R"({ "a": /* x */ [1] })"sv, reformatter, nullptr);
+    encoder << "after"sv << qc::json::end;
+    EXPECT_EQ(R"([ "before", { "a": [ 1 ] }, "after" ])"s, encoder.finish());
+}
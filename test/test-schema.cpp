@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <qc-json-schema.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Schema;
+using qc::json::SchemaError;
+using qc::json::ValidationError;
+using qc::json::DecodeError;
+using qc::json::validate;
+
+static Schema schema(std::string_view json)
+{
+    return Schema{qc::json::decode(json)};
+}
+
+// Returns the position of the validation error, or `npos` if valid
+static size_t violation(std::string_view json, const Schema & schema)
+{
+    try
+    {
+        validate(json, schema);
+        return std::string_view::npos;
+    }
+    catch (const ValidationError & e)
+    {
+        return e.position;
+    }
+}
+
+TEST(schema, type)
+{
+    const Schema s{schema(R"({ "type": "integer" })")};
+    EXPECT_NO_THROW(validate("1", s));
+    EXPECT_NO_THROW(validate("1.0", s));
+    EXPECT_NO_THROW(validate("1e3", s));
+    EXPECT_NO_THROW(validate("18446744073709551615", s));
+    EXPECT_THROW(validate("1.5", s), ValidationError);
+    EXPECT_THROW(validate("\"1\"", s), ValidationError);
+    EXPECT_THROW(validate("[]", s), ValidationError);
+
+    const Schema s2{schema(R"({ "type": ["number", "null"] })")};
+    EXPECT_NO_THROW(validate("1", s2));
+    EXPECT_NO_THROW(validate("1.5", s2));
+    EXPECT_NO_THROW(validate("nan", s2));
+    EXPECT_NO_THROW(validate("null", s2));
+    EXPECT_THROW(validate("true", s2), ValidationError);
+    EXPECT_THROW(validate("{}", s2), ValidationError);
+
+    try
+    {
+        validate("true", s2);
+    }
+    catch (const ValidationError & e)
+    {
+        EXPECT_EQ("Expected number or null"s, e.what());
+    }
+
+    EXPECT_NO_THROW(validate(R"({ "a": [1, "x", null] })", schema("true")));
+    EXPECT_THROW(validate("1", schema("false")), ValidationError);
+}
+
+TEST(schema, enum)
+{
+    const Schema s{schema(R"({ "enum": ["a", 1, true, null] })")};
+    EXPECT_NO_THROW(validate("'a'", s));
+    EXPECT_NO_THROW(validate("1", s));
+    EXPECT_NO_THROW(validate("1.0", s));
+    EXPECT_NO_THROW(validate("0x1", s));
+    EXPECT_NO_THROW(validate("true", s));
+    EXPECT_NO_THROW(validate("null", s));
+    EXPECT_THROW(validate("\"b\"", s), ValidationError);
+    EXPECT_THROW(validate("2", s), ValidationError);
+    EXPECT_THROW(validate("false", s), ValidationError);
+    EXPECT_THROW(validate("\"1\"", s), ValidationError);
+    EXPECT_THROW(schema(R"({ "enum": [[]] })"), SchemaError);
+}
+
+TEST(schema, numbers)
+{
+    const Schema s{schema(R"({ "minimum": -1, "maximum": 10.5 })")};
+    EXPECT_NO_THROW(validate("-1", s));
+    EXPECT_NO_THROW(validate("10.5", s));
+    EXPECT_THROW(validate("-1.01", s), ValidationError);
+    EXPECT_THROW(validate("11", s), ValidationError);
+    EXPECT_THROW(validate("18446744073709551615", s), ValidationError);
+    EXPECT_NO_THROW(validate("\"not a number\"", s));
+
+    const Schema s2{schema(R"({ "exclusiveMinimum": 0, "exclusiveMaximum": 1 })")};
+    EXPECT_NO_THROW(validate("0.5", s2));
+    EXPECT_THROW(validate("0", s2), ValidationError);
+    EXPECT_THROW(validate("1", s2), ValidationError);
+
+    // Inclusive and exclusive bounds together are both checked
+    const Schema s3{schema(R"({ "minimum": 0, "exclusiveMinimum": 5 })")};
+    EXPECT_THROW(validate("3", s3), ValidationError);
+    EXPECT_THROW(validate("5", s3), ValidationError);
+    EXPECT_NO_THROW(validate("5.5", s3));
+    const Schema s4{schema(R"({ "minimum": 5, "exclusiveMinimum": 0 })")};
+    EXPECT_THROW(validate("3", s4), ValidationError);
+    EXPECT_NO_THROW(validate("5", s4));
+    const Schema s5{schema(R"({ "maximum": 5, "exclusiveMaximum": 10 })")};
+    EXPECT_NO_THROW(validate("5", s5));
+    EXPECT_THROW(validate("5.5", s5), ValidationError);
+    const Schema s6{schema(R"({ "maximum": 10, "exclusiveMaximum": 5 })")};
+    EXPECT_NO_THROW(validate("4", s6));
+    EXPECT_THROW(validate("5", s6), ValidationError);
+
+    // Integers beyond 2^53 are compared exactly
+    const Schema s7{schema(R"({ "maximum": 9007199254740992 })")};
+    EXPECT_NO_THROW(validate("9007199254740992", s7));
+    EXPECT_THROW(validate("9007199254740993", s7), ValidationError);
+    EXPECT_THROW(validate("9007199254740993.0", s7), ValidationError);
+    const Schema s8{schema(R"({ "exclusiveMinimum": 18446744073709551614, "maximum": 18446744073709551615 })")};
+    EXPECT_NO_THROW(validate("18446744073709551615", s8));
+    EXPECT_THROW(validate("18446744073709551614", s8), ValidationError);
+    EXPECT_THROW(validate("-1", s8), ValidationError);
+    const Schema s9{schema(R"({ "minimum": -9223372036854775807, "maximum": 9223372036854775806 })")};
+    EXPECT_NO_THROW(validate("-9223372036854775807", s9));
+    EXPECT_THROW(validate("-9223372036854775808", s9), ValidationError);
+    EXPECT_THROW(validate("9223372036854775807", s9), ValidationError);
+    EXPECT_THROW(validate("9223372036854775808", s9), ValidationError);
+    EXPECT_THROW(validate("9223372036854775807.0", s9), ValidationError);
+    const Schema s10{schema(R"({ "minimum": 0.5, "maximum": 1.5 })")};
+    EXPECT_NO_THROW(validate("1", s10));
+    EXPECT_THROW(validate("0", s10), ValidationError);
+    EXPECT_THROW(validate("2", s10), ValidationError);
+}
+
+TEST(schema, strings)
+{
+    const Schema s{schema(R"({ "minLength": 2, "maxLength": 3 })")};
+    EXPECT_NO_THROW(validate("\"ab\"", s));
+    EXPECT_NO_THROW(validate("\"abc\"", s));
+    EXPECT_NO_THROW(validate(R"("\xC3\xA9\xC3\xA9\xC3\xA9")", s)); // Code points, not bytes
+    EXPECT_THROW(validate("\"a\"", s), ValidationError);
+    EXPECT_THROW(validate("\"abcd\"", s), ValidationError);
+}
+
+TEST(schema, arrays)
+{
+    const Schema s{schema(R"({ "type": "array", "items": { "type": "string" }, "minItems": 1, "maxItems": 2 })")};
+    EXPECT_NO_THROW(validate(R"(["a"])", s));
+    EXPECT_NO_THROW(validate(R"(["a", "b"])", s));
+    EXPECT_THROW(validate(R"([])", s), ValidationError);
+    EXPECT_THROW(validate(R"(["a", "b", "c"])", s), ValidationError);
+    EXPECT_THROW(validate(R"(["a", 1])", s), ValidationError);
+    EXPECT_THROW(validate(R"(["a", ["b"]])", s), ValidationError);
+}
+
+TEST(schema, objects)
+{
+    const Schema s{schema(R"({
+        "type": "object",
+        "properties": {
+            "id": { "type": "integer", "minimum": 0 },
+            "tags": { "type": "array", "items": { "type": "string" } },
+            "meta": { "type": "object", "required": ["v"] }
+        },
+        "required": ["id", "name"],
+        "additionalProperties": { "type": "string" }
+    })")};
+    EXPECT_NO_THROW(validate(R"({ "id": 1, "name": "x" })", s));
+    EXPECT_NO_THROW(validate(R"({ name: "x", id: 1, tags: ["a"], meta: { v: null }, other: "y" })", s));
+    EXPECT_THROW(validate(R"({ "name": "x" })", s), ValidationError);
+    EXPECT_THROW(validate(R"({ "id": 1 })", s), ValidationError);
+    EXPECT_THROW(validate(R"({ "id": -1, "name": "x" })", s), ValidationError);
+    EXPECT_THROW(validate(R"({ "id": 1, "name": 5 })", s), ValidationError);
+    EXPECT_THROW(validate(R"({ "id": 1, "name": "x", "other": 5 })", s), ValidationError);
+    EXPECT_THROW(validate(R"({ "id": 1, "name": "x", "meta": {} })", s), ValidationError);
+    EXPECT_THROW(validate(R"({ "id": 1, "name": "x", "tags": [1] })", s), ValidationError);
+
+    const Schema s2{schema(R"({ "properties": { "a": true }, "additionalProperties": false })")};
+    EXPECT_NO_THROW(validate(R"({ "a": 1 })", s2));
+    EXPECT_THROW(validate(R"({ "a": 1, "b": 2 })", s2), ValidationError);
+}
+
+TEST(schema, position)
+{
+    const Schema s{schema(R"({ "items": { "maximum": 5 } })")};
+    EXPECT_EQ(std::string_view::npos, violation("[1, 2, 3]", s));
+    EXPECT_EQ(9u, violation("[1, 2, 10, 3]", s));
+
+    const Schema s2{schema(R"({ "required": ["a"] })")};
+    EXPECT_EQ(11u, violation(R"([{ "b": 1 }])", schema(R"({ "items": { "required": ["a"] } })")));
+    EXPECT_EQ(10u, violation(R"({ "b": 1 })", s2));
+
+    // Decode errors are still decode errors
+    EXPECT_THROW(validate("[1, 2", s), DecodeError);
+}
+
+TEST(schema, invalid)
+{
+    EXPECT_THROW(schema("1"), SchemaError);
+    EXPECT_THROW(schema(R"({ "type": "thing" })"), SchemaError);
+    EXPECT_THROW(schema(R"({ "type": 1 })"), SchemaError);
+    EXPECT_THROW(schema(R"({ "minLength": -1 })"), SchemaError);
+    EXPECT_THROW(schema(R"({ "minimum": "1" })"), SchemaError);
+    EXPECT_THROW(schema(R"({ "required": [1] })"), SchemaError);
+    EXPECT_THROW(schema(R"({ "properties": { "a": 1 } })"), SchemaError);
+    EXPECT_NO_THROW(schema(R"({ "$schema": "x", "title": "t", "description": "d" })"));
+}
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <qc-json-snapshot.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::StaticValue;
+using qc::json::Type;
+
+class SnapshotTest : public testing::Test
+{
+    protected: //---------------------------------------------------------------
+
+    std::filesystem::path path{std::filesystem::temp_directory_path() / "qc-json-snapshot-test.bin"};
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    qc::json::Snapshot roundTrip(const std::string_view json)
+    {
+        qc::json::saveSnapshot(qc::json::decode(json), path);
+        return qc::json::loadSnapshot(path);
+    }
+};
+
+TEST_F(SnapshotTest, scalars)
+{
+    EXPECT_TRUE(roundTrip("null"sv).root().isNull());
+    EXPECT_EQ(true, roundTrip("true"sv).root().asBoolean());
+    EXPECT_EQ(-123, roundTrip("-123"sv).root().asInteger());
+    EXPECT_EQ(18446744073709551615u, roundTrip("18446744073709551615"sv).root().asUnsigner());
+    EXPECT_EQ(1.25, roundTrip("1.25"sv).root().asFloater());
+    EXPECT_TRUE(std::isnan(roundTrip("nan"sv).root().asFloater()));
+    EXPECT_EQ("abc"sv, roundTrip(R"("abc")"sv).root().asString());
+    EXPECT_EQ(""sv, roundTrip(R"("")"sv).root().asString());
+}
+
+TEST_F(SnapshotTest, containers)
+{
+    const qc::json::Snapshot snapshot{roundTrip(R"({
+        "zeta": [1, [2, 3], {"x": null}, []],
+        "alpha": {"inner": "text", "empty": {}},
+        "mid": "value"
+    })"sv)};
+    const StaticValue root{snapshot.root()};
+
+    ASSERT_TRUE(root.isObject());
+    ASSERT_EQ(3u, root.size());
+
+    // Members are in key order, as they were in the value
+    EXPECT_EQ("alpha"sv, root.key(0u));
+    EXPECT_EQ("mid"sv, root.key(1u));
+    EXPECT_EQ("zeta"sv, root.key(2u));
+
+    EXPECT_EQ("value"sv, root.at("mid"sv).asString());
+    EXPECT_EQ("text"sv, root.at("alpha"sv).at("inner"sv).asString());
+    EXPECT_EQ(0u, root.at("alpha"sv).at("empty"sv).size());
+    EXPECT_FALSE(root.contains("beta"sv));
+    EXPECT_FALSE(root.contains("zz"sv));
+    EXPECT_THROW(root.at("aaa"sv), std::out_of_range);
+
+    const StaticValue zeta{root.at("zeta"sv)};
+    ASSERT_EQ(4u, zeta.size());
+    EXPECT_EQ(1, zeta.at(0u).asInteger());
+    EXPECT_EQ(3, zeta.at(1u).at(1u).asInteger());
+    EXPECT_TRUE(zeta.at(2u).at("x"sv).isNull());
+    EXPECT_EQ(Type::array, zeta.at(3u).type());
+    EXPECT_EQ(0u, zeta.at(3u).size());
+}
+
+TEST_F(SnapshotTest, stringTable)
+{
+    std::string json{"["};
+    for (int i{0}; i < 100; ++i)
+    {
+        json += R"({"identifier": "repeated value", "n": )" + std::to_string(i) + "},";
+    }
+    json += "]";
+
+    const qc::json::Snapshot snapshot{roundTrip(json)};
+
+    // Header, the array, 100 objects, 200 keys, 200 values, and each distinct string once
+    EXPECT_EQ(32u + 501u * 24u + "identifier"sv.size() + "repeated value"sv.size() + "n"sv.size(), snapshot.size());
+    EXPECT_EQ(100u, snapshot.root().size());
+    EXPECT_EQ(57, snapshot.root().at(57u).at("n"sv).asInteger());
+    EXPECT_EQ("repeated value"sv, snapshot.root().at(99u).at("identifier"sv).asString());
+}
+
+TEST_F(SnapshotTest, move)
+{
+    qc::json::Snapshot a{roundTrip("[1, 2]"sv)};
+    qc::json::Snapshot b{std::move(a)};
+    EXPECT_EQ(2, b.root().at(1u).asInteger());
+
+    a = std::move(b);
+    EXPECT_EQ(2u, a.root().size());
+}
+
+TEST_F(SnapshotTest, invalid)
+{
+    EXPECT_THROW(qc::json::loadSnapshot(path), qc::json::SnapshotError);
+
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << "{\"not\": \"a snapshot\", \"but\": \"long enough\"}";
+    }
+    EXPECT_THROW(qc::json::loadSnapshot(path), qc::json::SnapshotError);
+
+    // Truncated
+    qc::json::saveSnapshot(qc::json::decode("[1, 2, 3]"sv), path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1u);
+    EXPECT_THROW(qc::json::loadSnapshot(path), qc::json::SnapshotError);
+}
@@ -0,0 +1,145 @@
+#include <bit>
+#include <cmath>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <qc-json-static.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::StaticValue;
+using qc::json::Type;
+
+static constexpr auto config{qc::json::staticDecode<R"(
+    // Default configuration
+    {
+        name: "Widget",
+        'size': [16, 9,],
+        enabled: true,
+        ratio: 1.5,
+        offset: -7,
+        mask: 0xFF,
+        big: 18446744073709551615,
+        nothing: null,
+        /* Nested */
+        nested: { inner: [[], {}, 'a\tb'] },
+    }
+)">()};
+
+// Evaluated entirely at compile time
+static_assert(config.root().isObject());
+static_assert(config.root().size() == 9u);
+static_assert(config.root().at("name"sv).asString() == "Widget"sv);
+static_assert(config.root().at("size"sv).at(1u).asInteger() == 9);
+static_assert(config.root().at("enabled"sv).asBoolean());
+static_assert(!config.root().contains("missing"sv));
+
+TEST(static, object)
+{
+    const StaticValue root{config.root()};
+    ASSERT_TRUE(root.isObject());
+    ASSERT_EQ(9u, root.size());
+
+    // Member order is preserved
+    EXPECT_EQ("name"sv, root.key(0u));
+    EXPECT_EQ("size"sv, root.key(1u));
+    EXPECT_EQ("nested"sv, root.key(8u));
+    EXPECT_EQ("Widget"sv, root.at(0u).asString());
+
+    EXPECT_TRUE(root.contains("ratio"sv));
+    EXPECT_FALSE(root.contains("Ratio"sv));
+    EXPECT_THROW(root.at("Ratio"sv), std::out_of_range);
+    EXPECT_THROW(root.key(9u), std::out_of_range);
+    EXPECT_THROW(root.at("size"sv).key(0u), qc::json::TypeError);
+}
+
+TEST(static, array)
+{
+    const StaticValue size{config.root().at("size"sv)};
+    ASSERT_TRUE(size.isArray());
+    ASSERT_EQ(2u, size.size());
+    EXPECT_EQ(16, size.at(0u).asInteger());
+    EXPECT_EQ(9, size.at(1u).asInteger());
+    EXPECT_THROW(size.at(2u), std::out_of_range);
+
+    const StaticValue inner{config.root().at("nested"sv).at("inner"sv)};
+    ASSERT_EQ(3u, inner.size());
+    EXPECT_TRUE(inner.at(0u).isArray());
+    EXPECT_EQ(0u, inner.at(0u).size());
+    EXPECT_TRUE(inner.at(1u).isObject());
+    EXPECT_EQ(0u, inner.at(1u).size());
+    EXPECT_EQ("a\tb"sv, inner.at(2u).asString());
+}
+
+TEST(static, scalars)
+{
+    const StaticValue root{config.root()};
+    EXPECT_EQ(Type::floater, root.at("ratio"sv).type());
+    EXPECT_EQ(1.5, root.at("ratio"sv).asFloater());
+    EXPECT_EQ(-7, root.at("offset"sv).asInteger());
+    EXPECT_EQ(0xFFu, root.at("mask"sv).asUnsigner());
+    EXPECT_EQ(18446744073709551615u, root.at("big"sv).asUnsigner());
+    EXPECT_TRUE(root.at("nothing"sv).isNull());
+    EXPECT_TRUE(root.at("enabled"sv).asBoolean());
+
+    EXPECT_THROW(root.at("ratio"sv).asInteger(), qc::json::TypeError);
+    EXPECT_THROW(root.at("name"sv).size(), qc::json::TypeError);
+}
+
+TEST(static, numbers)
+{
+    static constexpr auto numbers{qc::json::staticDecode<"[0, -0, 1.000, .0, -9223372036854775808, 9223372036854775808, -9223372036854775809, 18446744073709551616, 1e3, 0.1, 123.456e-2, 6.02214076e23, 5e-324, -inf, nan, 0b101, 0o17]">()};
+    const StaticValue arr{numbers.root()};
+
+    // Matches the runtime decoder
+    const qc::json::Value expected{qc::json::decode("[0, -0, 1.000, .0, -9223372036854775808, 9223372036854775808, -9223372036854775809, 18446744073709551616, 1e3, 0.1, 123.456e-2, 6.02214076e23, 5e-324, -inf, nan, 0b101, 0o17]"sv)};
+    const qc::json::Array & expectedArr{expected.asArray()};
+    ASSERT_EQ(expectedArr.size(), arr.size());
+    for (size_t i{0u}; i < arr.size(); ++i)
+    {
+        const StaticValue val{arr.at(i)};
+        ASSERT_EQ(expectedArr[i].type(), val.type()) << i;
+        switch (val.type())
+        {
+            case Type::integer: EXPECT_EQ(expectedArr[i].asInteger(), val.asInteger()) << i; break;
+            case Type::unsigner: EXPECT_EQ(expectedArr[i].asUnsigner(), val.asUnsigner()) << i; break;
+            case Type::floater:
+                if (std::isnan(val.asFloater())) EXPECT_TRUE(std::isnan(expectedArr[i].asFloater())) << i;
+                else EXPECT_EQ(expectedArr[i].asFloater(), val.asFloater()) << i;
+                break;
+            default: FAIL() << i;
+        }
+    }
+}
+
+TEST(static, floaters)
+{
+    // Limits, subnormals, halfway points, and more digits than a double holds
+    static constexpr char json[]{"[1.7976931348623157e308, 2.2250738585072011e-308, 2.2250738585072014e-308, 3e-324, 2.4703282292062328e-324, 1e23, 9007199254740993e0, 9007199254740995e0, 1.00000000000000011102230246251565404236316680908203125, 1.00000000000000011102230246251565404236316680908203126, 3.141592653589793238462643383279502884197169399375105820974944, 0.000000000000000000000000000000000000000001e300, 123456789012345678901234567890e-10]"};
+    static constexpr auto floaters{qc::json::staticDecode<json>()};
+    const StaticValue arr{floaters.root()};
+
+    // Bit for bit the same as the runtime decoder
+    const qc::json::Value expected{qc::json::decode(json)};
+    const qc::json::Array & expectedArr{expected.asArray()};
+    ASSERT_EQ(expectedArr.size(), arr.size());
+    for (size_t i{0u}; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(Type::floater, arr.at(i).type()) << i;
+        EXPECT_EQ(std::bit_cast<uint64_t>(expectedArr[i].asFloater()), std::bit_cast<uint64_t>(arr.at(i).asFloater())) << i;
+    }
+}
+
+TEST(static, root)
+{
+    static constexpr auto str{qc::json::staticDecode<R"("abc\x41B" // Trailing comment)">()};
+    EXPECT_EQ("abcAB"sv, str.root().asString());
+
+    static constexpr auto empty{qc::json::staticDecode<"''">()};
+    EXPECT_EQ(""sv, empty.root().asString());
+
+    static constexpr auto number{qc::json::staticDecode<" 42 ,">()};
+    EXPECT_EQ(42, number.root().asInteger());
+}
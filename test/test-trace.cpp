@@ -0,0 +1,141 @@
+#define QC_JSON_TRACE
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <qc-json.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::TraceInfo;
+using qc::json::TraceOperation;
+
+static std::vector<TraceInfo> traces{};
+
+static void record(const TraceInfo & info)
+{
+    traces.push_back(info);
+}
+
+class TraceTest : public testing::Test
+{
+    protected: //---------------------------------------------------------------
+
+    void SetUp() override
+    {
+        traces.clear();
+        qc::json::setTraceHook(record);
+    }
+
+    void TearDown() override
+    {
+        qc::json::setTraceHook(nullptr);
+    }
+};
+
+TEST_F(TraceTest, saxDecode)
+{
+    qc::json::DummyComposer composer{};
+    const std::string_view json{R"({"a": [1, {"b": [[]]}], "c": null})"};
+    qc::json::decode(json, composer, nullptr);
+
+    ASSERT_EQ(1u, traces.size());
+    EXPECT_EQ(TraceOperation::saxDecode, traces[0].operation);
+    EXPECT_EQ(json.size(), traces[0].bytes);
+    EXPECT_EQ(7u, traces[0].nodes);
+    EXPECT_EQ(5u, traces[0].depth);
+    EXPECT_FALSE(traces[0].failed);
+    EXPECT_GE(traces[0].elapsed.count(), 0);
+}
+
+TEST_F(TraceTest, saxDecodeFailure)
+{
+    qc::json::DummyComposer composer{};
+    EXPECT_THROW(qc::json::decode("[1, 2, nope]"sv, composer, nullptr), qc::json::DecodeError);
+
+    ASSERT_EQ(1u, traces.size());
+    EXPECT_EQ(TraceOperation::saxDecode, traces[0].operation);
+    EXPECT_EQ(7u, traces[0].bytes);
+    EXPECT_EQ(4u, traces[0].nodes);
+    EXPECT_EQ(1u, traces[0].depth);
+    EXPECT_TRUE(traces[0].failed);
+}
+
+TEST_F(TraceTest, domDecode)
+{
+    const std::string_view json{"[[1, 2], 3]"};
+    const qc::json::Value val{qc::json::decode(json)};
+
+    ASSERT_EQ(2u, traces.size());
+    EXPECT_EQ(TraceOperation::saxDecode, traces[0].operation);
+    EXPECT_EQ(TraceOperation::domDecode, traces[1].operation);
+    EXPECT_EQ(json.size(), traces[1].bytes);
+    EXPECT_EQ(5u, traces[1].nodes);
+    EXPECT_EQ(2u, traces[1].depth);
+    EXPECT_FALSE(traces[1].failed);
+    EXPECT_GE(traces[1].elapsed, traces[0].elapsed);
+}
+
+TEST_F(TraceTest, saxEncode)
+{
+    qc::json::Encoder encoder{qc::json::Density::nospace};
+    encoder << qc::json::object << "a" << qc::json::array << 1 << 2 << qc::json::end << qc::json::end;
+    const std::string str{encoder.finish()};
+
+    ASSERT_EQ(1u, traces.size());
+    EXPECT_EQ(TraceOperation::saxEncode, traces[0].operation);
+    EXPECT_EQ(str.size(), traces[0].bytes);
+    EXPECT_EQ(4u, traces[0].nodes);
+    EXPECT_EQ(2u, traces[0].depth);
+
+    // Stats are reset between documents
+    encoder << 5;
+    EXPECT_EQ("5"s, encoder.finish());
+    ASSERT_EQ(2u, traces.size());
+    EXPECT_EQ(1u, traces[1].bytes);
+    EXPECT_EQ(1u, traces[1].nodes);
+    EXPECT_EQ(0u, traces[1].depth);
+}
+
+TEST_F(TraceTest, saxEncodeSink)
+{
+    struct NullSink : qc::json::Sink
+    {
+        void write(const std::string_view) override {}
+    };
+
+    NullSink sink{};
+    qc::json::Encoder encoder{qc::json::Density::nospace};
+    encoder.setSink(&sink, 8u);
+    encoder << qc::json::array;
+    for (int i{0}; i < 100; ++i) encoder << i;
+    encoder << qc::json::end;
+    encoder.finish();
+
+    ASSERT_EQ(1u, traces.size());
+    EXPECT_EQ(291u, traces[0].bytes);
+    EXPECT_EQ(101u, traces[0].nodes);
+}
+
+TEST_F(TraceTest, domEncode)
+{
+    const qc::json::Value val{qc::json::decode("[[1, 2], 3]"sv)};
+    traces.clear();
+    const std::string str{qc::json::encode(val, qc::json::Density::nospace)};
+
+    ASSERT_EQ(2u, traces.size());
+    EXPECT_EQ(TraceOperation::saxEncode, traces[0].operation);
+    EXPECT_EQ(TraceOperation::domEncode, traces[1].operation);
+    EXPECT_EQ(str.size(), traces[1].bytes);
+    EXPECT_EQ(5u, traces[1].nodes);
+    EXPECT_EQ(2u, traces[1].depth);
+}
+
+TEST_F(TraceTest, noHook)
+{
+    qc::json::setTraceHook(nullptr);
+    qc::json::decode("[1]"sv);
+    EXPECT_TRUE(traces.empty());
+}
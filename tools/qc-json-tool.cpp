@@ -0,0 +1,658 @@
+///
+/// Command line tool wrapping the QC JSON headers
+///
+/// Run with no arguments for usage
+///
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define QC_JSON_TOOL_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fstream>
+    #include <sstream>
+#endif
+
+#if defined(QC_JSON_ZLIB) || defined(QC_JSON_ZSTD)
+    #define QC_JSON_TOOL_COMPRESSION
+    #include <fstream>
+#endif
+
+#include <qc-json.hpp>
+#include <qc-json-index.hpp>
+#include <qc-json-reformat.hpp>
+#include <qc-json-schema.hpp>
+#ifdef QC_JSON_TOOL_COMPRESSION
+    #include <qc-json-compress.hpp>
+#endif
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+using qc::json::Density;
+using qc::json::ReformatOptions;
+
+static constexpr std::string_view usage{
+R"(Usage: qc-json-tool <command> [options] [file]
+
+Reads from stdin if no file or `-` is given. Writes to stdout
+
+Commands:
+    validate [--schema <file>]  Checks the input is valid JSON5, and optionally that it matches the schema
+    minify                      Removes all whitespace and comments
+    pretty [--indent <n>]       Puts every element on its own line with `n` spaces of indentation, 4 by default
+    to-json                     Converts JSON5 to strict JSON, preserving density
+    ndjson-split                Writes each element of the root array minified on its own line
+    ndjson-merge                Combines each line of NDJSON into a single root array
+    ndjson-index                Writes an index of the NDJSON file's records to `<file>.idx`
+    ndjson-record <n>           Writes the `n`th record of NDJSON minified, using `<file>.idx` if it matches
+    bench [--seconds <n>]       Measures decode and encode throughput, spending about `n` seconds on each, 1 by default
+)"};
+
+// Thrown for bad command line arguments
+struct UsageError : std::runtime_error
+{
+    explicit UsageError(const std::string & msg) : std::runtime_error{msg} {}
+};
+
+// Read only view of an entire file, memory mapped where possible
+class Input
+{
+    public: //------------------------------------------------------------------
+
+    explicit Input(const std::string_view path)
+    {
+        if (path.empty() || path == "-"sv)
+        {
+            _readStdin();
+            return;
+        }
+
+        #ifdef QC_JSON_TOOL_COMPRESSION
+        // Compressed files are decompressed as they are read rather than mapped
+        if (_isCompressed(path))
+        {
+            _buffer = qc::json::readCompressed(std::string{path});
+            return;
+        }
+        #endif
+
+        #ifdef QC_JSON_TOOL_MMAP
+        {
+            const int fd{::open(std::string{path}.c_str(), O_RDONLY)};
+            if (fd == -1)
+            {
+                throw std::runtime_error{("Failed to open `"s += path) += '`'};
+            }
+
+            struct stat info{};
+            if (::fstat(fd, &info) == -1)
+            {
+                ::close(fd);
+                throw std::runtime_error{("Failed to stat `"s += path) += '`'};
+            }
+
+            _size = size_t(info.st_size);
+            if (_size)
+            {
+                void * const map{::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0)};
+                if (map == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error{("Failed to map `"s += path) += '`'};
+                }
+                ::madvise(map, _size, MADV_SEQUENTIAL);
+                _map = static_cast<const char *>(map);
+            }
+
+            ::close(fd);
+        }
+        #else
+        {
+            std::ifstream file{std::string{path}, std::ios::binary};
+            if (!file)
+            {
+                throw std::runtime_error{("Failed to open `"s += path) += '`'};
+            }
+            std::ostringstream ss{};
+            ss << file.rdbuf();
+            _buffer = std::move(ss).str();
+        }
+        #endif
+    }
+
+    Input(const Input &) = delete;
+
+    ~Input() noexcept
+    {
+        #ifdef QC_JSON_TOOL_MMAP
+        if (_map)
+        {
+            ::munmap(const_cast<char *>(_map), _size);
+        }
+        #endif
+    }
+
+    std::string_view view() const noexcept
+    {
+        return _map ? std::string_view{_map, _size} : std::string_view{_buffer};
+    }
+
+    private: //-----------------------------------------------------------------
+
+    const char * _map{nullptr};
+    size_t _size{0u};
+    std::string _buffer{};
+
+    void _readStdin()
+    {
+        char chunk[65536];
+        size_t n;
+
+        #ifdef QC_JSON_TOOL_COMPRESSION
+        // Compressed input is decompressed chunk by chunk as it arrives
+        std::optional<qc::json::Decompressor> decompressor{};
+        if ((n = std::fread(chunk, 1u, sizeof(chunk), stdin)))
+        {
+            const std::string_view first{chunk, n};
+            const qc::json::Compression compression{qc::json::detectCompression(first)};
+            if (compression == qc::json::Compression::none)
+            {
+                _buffer.append(first);
+            }
+            else
+            {
+                decompressor.emplace(compression);
+                decompressor->update(first, _buffer);
+            }
+        }
+        while ((n = std::fread(chunk, 1u, sizeof(chunk), stdin)))
+        {
+            if (decompressor)
+            {
+                decompressor->update(std::string_view{chunk, n}, _buffer);
+            }
+            else
+            {
+                _buffer.append(chunk, n);
+            }
+        }
+        if (decompressor)
+        {
+            decompressor->finish();
+        }
+        #else
+        while ((n = std::fread(chunk, 1u, sizeof(chunk), stdin)))
+        {
+            _buffer.append(chunk, n);
+        }
+        #endif
+    }
+
+    #ifdef QC_JSON_TOOL_COMPRESSION
+    static bool _isCompressed(const std::string_view path)
+    {
+        std::ifstream file{std::string{path}, std::ios::binary};
+        char magic[4]{};
+        file.read(magic, sizeof(magic));
+        return qc::json::detectCompression(std::string_view{magic, size_t(file.gcount())}) != qc::json::Compression::none;
+    }
+    #endif
+};
+
+// Streams output to stdout. Relies on stdio for buffering
+class StdoutSink : public qc::json::Sink
+{
+    public: //------------------------------------------------------------------
+
+    void write(const std::string_view chunk) override
+    {
+        if (std::fwrite(chunk.data(), 1u, chunk.size(), stdout) != chunk.size())
+        {
+            throw std::runtime_error{"Failed to write output"};
+        }
+    }
+};
+
+// Reformats each element of the root array into its own line
+class SplitComposer
+{
+    public: //------------------------------------------------------------------
+
+    explicit SplitComposer(qc::json::Sink & sink) :
+        _sink{sink}
+    {
+        _encoder.setSink(&sink, 65536u);
+    }
+
+    int object(int & outerState)
+    {
+        if (outerState == 0)
+        {
+            throw qc::json::ComposeError{"Root must be an array"sv};
+        }
+        std::nullptr_t state{};
+        _reformatter.object(state);
+        return outerState + 1;
+    }
+
+    int array(int & outerState)
+    {
+        if (outerState >= 1)
+        {
+            std::nullptr_t state{};
+            _reformatter.array(state);
+        }
+        return outerState + 1;
+    }
+
+    void end(const Density density, int && innerState, int & outerState)
+    {
+        if (innerState >= 2)
+        {
+            std::nullptr_t state{};
+            _reformatter.end(density, nullptr, state);
+            if (outerState == 1)
+            {
+                _endLine();
+            }
+        }
+    }
+
+    void key(const std::string_view key, int & /*state*/)
+    {
+        std::nullptr_t state{};
+        _reformatter.key(key, state);
+    }
+
+    void val(const std::string_view val, int & state) { _val(val, state); }
+    void val(const int64_t val, int & state) { _val(val, state); }
+    void val(const uint64_t val, int & state) { _val(val, state); }
+    void val(const double val, int & state) { _val(val, state); }
+    void val(const bool val, int & state) { _val(val, state); }
+    void val(const std::nullptr_t, int & state) { _val(nullptr, state); }
+
+    void comment(const std::string_view /*comment*/, int & /*state*/) {}
+
+    private: //-----------------------------------------------------------------
+
+    qc::json::Sink & _sink;
+    qc::json::Encoder _encoder{Density::nospace};
+    qc::json::Reformatter _reformatter{_encoder, false};
+
+    template <typename T>
+    void _val(const T val, const int depth)
+    {
+        if (depth == 0)
+        {
+            throw qc::json::ComposeError{"Root must be an array"sv};
+        }
+        std::nullptr_t state{};
+        _reformatter.val(val, state);
+        if (depth == 1)
+        {
+            _endLine();
+        }
+    }
+
+    void _endLine()
+    {
+        _encoder.finish();
+        _sink.write("\n"sv);
+    }
+};
+
+// Returns the one-based line and column of the position
+static std::pair<size_t, size_t> lineColumn(const std::string_view json, const size_t position)
+{
+    size_t line{1u}, lineStart{0u};
+    for (size_t i{0u}; i < position && i < json.size(); ++i)
+    {
+        if (json[i] == '\n')
+        {
+            ++line;
+            lineStart = i + 1u;
+        }
+    }
+    return {line, position - lineStart + 1u};
+}
+
+static void validate(const std::string_view json, const std::optional<std::string_view> schemaPath)
+{
+    if (schemaPath)
+    {
+        const Input schemaInput{*schemaPath};
+        std::optional<qc::json::Schema> schema{};
+        try
+        {
+            schema.emplace(qc::json::decode(schemaInput.view()));
+        }
+        catch (const qc::json::DecodeError & e)
+        {
+            const auto [line, column]{lineColumn(schemaInput.view(), e.position)};
+            throw std::runtime_error{"Schema is invalid JSON at line "s + std::to_string(line) + ", column " + std::to_string(column) + ": " + e.what()};
+        }
+        qc::json::validate(json, *schema);
+    }
+    else
+    {
+        qc::json::DummyComposer composer{};
+        qc::json::decode(json, composer, nullptr);
+    }
+
+    std::cerr << "Valid\n";
+}
+
+static void ndjsonSplit(const std::string_view json)
+{
+    StdoutSink sink{};
+    SplitComposer composer{sink};
+    qc::json::decode(json, composer, 0);
+}
+
+// Returns the path of the index sidecar for the file
+static std::string indexPath(const std::optional<std::string_view> path)
+{
+    if (!path || *path == "-"sv)
+    {
+        throw UsageError{"An NDJSON index requires a file"s};
+    }
+    return std::string{*path} += ".idx"sv;
+}
+
+static void ndjsonIndex(const std::string_view ndjson, const std::optional<std::string_view> path)
+{
+    const qc::json::LineIndex index{qc::json::indexLines(ndjson)};
+    qc::json::saveIndex(index, indexPath(path));
+    std::cerr << index.size() << " records indexed\n";
+}
+
+static void ndjsonRecord(const std::string_view ndjson, const std::optional<std::string_view> path, const size_t number)
+{
+    // Use the sidecar if there is one for this file, otherwise index from scratch
+    std::optional<qc::json::LineIndex> index{};
+    if (path && *path != "-"sv)
+    {
+        try
+        {
+            index.emplace(qc::json::loadLineIndex(indexPath(path)));
+            if (index->sourceSize() != ndjson.size())
+            {
+                index.reset();
+            }
+        }
+        catch (const qc::json::IndexError &)
+        {}
+    }
+    if (!index)
+    {
+        index.emplace(qc::json::indexLines(ndjson));
+    }
+
+    if (number >= index->size())
+    {
+        throw std::runtime_error{"Record "s + std::to_string(number) + " out of range, there are " + std::to_string(index->size())};
+    }
+
+    const std::string_view record{index->record(ndjson, number)};
+    StdoutSink sink{};
+    try
+    {
+        qc::json::reformat(record, sink, ReformatOptions{.density = Density::nospace, .comments = false});
+    }
+    catch (qc::json::DecodeError & e)
+    {
+        e.position += size_t(record.data() - ndjson.data());
+        throw;
+    }
+    sink.write("\n"sv);
+}
+
+static void ndjsonMerge(const std::string_view ndjson)
+{
+    StdoutSink sink{};
+    sink.write("[\n"sv);
+
+    bool first{true};
+    size_t lineNumber{0u};
+    for (size_t lineStart{0u}; lineStart < ndjson.size();)
+    {
+        size_t lineEnd{ndjson.find('\n', lineStart)};
+        if (lineEnd == std::string_view::npos)
+        {
+            lineEnd = ndjson.size();
+        }
+        std::string_view line{ndjson.substr(lineStart, lineEnd - lineStart)};
+        ++lineNumber;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1u);
+        }
+
+        if (line.find_first_not_of(" \t"sv) != std::string_view::npos)
+        {
+            if (!first)
+            {
+                sink.write(",\n"sv);
+            }
+            first = false;
+
+            sink.write("    "sv);
+            try
+            {
+                qc::json::reformat(line, sink, ReformatOptions{.density = Density::nospace, .comments = false});
+            }
+            catch (qc::json::DecodeError & e)
+            {
+                e.position += lineStart;
+                throw;
+            }
+        }
+
+        lineStart = lineEnd + 1u;
+    }
+
+    sink.write(first ? "]\n"sv : "\n]\n"sv);
+}
+
+// Runs the function repeatedly for about the given duration and prints the throughput
+template <typename F>
+static void benchmark(const std::string_view name, const size_t bytes, const double seconds, F && f)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up
+    f();
+
+    size_t iterations{0u};
+    const Clock::time_point start{Clock::now()};
+    Clock::time_point now{start};
+    do
+    {
+        f();
+        ++iterations;
+        now = Clock::now();
+    } while (std::chrono::duration<double>(now - start).count() < seconds);
+
+    const double elapsed{std::chrono::duration<double>(now - start).count()};
+    const double mbPerSecond{double(bytes) * double(iterations) / elapsed / (1024.0 * 1024.0)};
+    std::printf("%-12.*s %10.1f MiB/s %12.3f us/op %10zu ops\n", int(name.size()), name.data(), mbPerSecond, elapsed * 1000000.0 / double(iterations), iterations);
+}
+
+static void bench(const std::string_view json, const double seconds)
+{
+    const qc::json::Value dom{qc::json::decode(json)};
+    const size_t encodedSize{qc::json::encode(dom).size()};
+
+    std::printf("%zu bytes in, %zu bytes encoded\n", json.size(), encodedSize);
+
+    benchmark("sax decode"sv, json.size(), seconds, [&]() {
+        qc::json::DummyComposer composer{};
+        qc::json::decode(json, composer, nullptr);
+    });
+    benchmark("dom decode"sv, json.size(), seconds, [&]() {
+        const qc::json::Value val{qc::json::decode(json)};
+    });
+    benchmark("dom encode"sv, encodedSize, seconds, [&]() {
+        const std::string str{qc::json::encode(dom)};
+    });
+    benchmark("minify"sv, json.size(), seconds, [&]() {
+        const std::string str{qc::json::minify(json)};
+    });
+}
+
+static int run(const std::span<const std::string_view> args)
+{
+    if (args.empty())
+    {
+        throw UsageError{"Missing command"s};
+    }
+
+    const std::string_view command{args[0]};
+    std::optional<std::string_view> path{};
+    std::optional<std::string_view> schemaPath{};
+    size_t indent{4u};
+    double seconds{1.0};
+    std::optional<size_t> recordNumber{};
+
+    for (size_t i{1u}; i < args.size(); ++i)
+    {
+        const std::string_view arg{args[i]};
+        const bool hasValue{i + 1u < args.size()};
+
+        if (arg == "--schema"sv && command == "validate"sv && hasValue)
+        {
+            schemaPath = args[++i];
+        }
+        else if (arg == "--indent"sv && command == "pretty"sv && hasValue)
+        {
+            indent = size_t(std::strtoull(std::string{args[++i]}.c_str(), nullptr, 10));
+        }
+        else if (arg == "--seconds"sv && command == "bench"sv && hasValue)
+        {
+            seconds = std::strtod(std::string{args[++i]}.c_str(), nullptr);
+        }
+        else if (command == "ndjson-record"sv && !recordNumber && !arg.empty() && arg.find_first_not_of("0123456789"sv) == std::string_view::npos)
+        {
+            recordNumber = size_t(std::strtoull(std::string{arg}.c_str(), nullptr, 10));
+        }
+        else if (!path && (arg == "-"sv || !arg.starts_with("--"sv)))
+        {
+            path = arg;
+        }
+        else
+        {
+            throw UsageError{("Unexpected argument `"s += arg) += '`'};
+        }
+    }
+
+    if (command == "ndjson-record"sv && !recordNumber)
+    {
+        throw UsageError{"Missing record number"s};
+    }
+
+    const Input input{path.value_or("-"sv)};
+    const std::string_view json{input.view()};
+
+    try
+    {
+        if (command == "validate"sv)
+        {
+            validate(json, schemaPath);
+        }
+        else if (command == "minify"sv || command == "pretty"sv || command == "to-json"sv)
+        {
+            ReformatOptions options{};
+            if (command == "minify"sv)
+            {
+                options.density = Density::nospace;
+                options.comments = false;
+            }
+            else if (command == "pretty"sv)
+            {
+                options.density = Density::multiline;
+                options.indentSpaces = indent;
+            }
+            else
+            {
+                options.strict = true;
+            }
+
+            StdoutSink sink{};
+            qc::json::reformat(json, sink, options);
+            sink.write("\n"sv);
+        }
+        else if (command == "ndjson-split"sv)
+        {
+            ndjsonSplit(json);
+        }
+        else if (command == "ndjson-merge"sv)
+        {
+            ndjsonMerge(json);
+        }
+        else if (command == "ndjson-index"sv)
+        {
+            ndjsonIndex(json, path);
+        }
+        else if (command == "ndjson-record"sv)
+        {
+            ndjsonRecord(json, path, *recordNumber);
+        }
+        else if (command == "bench"sv)
+        {
+            bench(json, seconds);
+        }
+        else
+        {
+            throw UsageError{("Unknown command `"s += command) += '`'};
+        }
+    }
+    catch (const qc::json::DecodeError & e)
+    {
+        std::fflush(stdout);
+        const auto [line, column]{lineColumn(json, e.position)};
+        std::cerr << "Error at line " << line << ", column " << column << ": " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(const int argc, const char * const * const argv)
+{
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    try
+    {
+        const int result{run(args)};
+        if (std::fflush(stdout))
+        {
+            throw std::runtime_error{"Failed to write output"};
+        }
+        return result;
+    }
+    catch (const UsageError & e)
+    {
+        std::cerr << e.what() << "\n\n" << usage;
+        return 2;
+    }
+    catch (const std::exception & e)
+    {
+        std::fflush(stdout);
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}